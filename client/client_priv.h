@@ -104,6 +104,7 @@ enum options_client
   OPT_SHUTDOWN_WAIT_FOR_SLAVES,
   OPT_COPY_S3_TABLES,
   OPT_PRINT_TABLE_METADATA,
+  OPT_DO_DOMAIN_IDS, OPT_IGNORE_DOMAIN_IDS,
   OPT_MAX_CLIENT_OPTION /* should be always the last */
 };
 
@@ -50,6 +50,7 @@
 #include "sql_string.h"   // needed for Rpl_filter
 #include "sql_list.h"     // needed for Rpl_filter
 #include "rpl_filter.h"
+#include "my_counter.h"
 
 #include "mysqld.h"
 
@@ -92,7 +93,8 @@ ulong opt_binlog_rows_event_max_size;
 ulonglong test_flags = 0;
 ulong opt_binlog_rows_event_max_encoded_size= MAX_MAX_ALLOWED_PACKET;
 static uint opt_protocol= 0;
-static FILE *result_file;
+/* Each --parallel-decode thread writes to its own batch file */
+static thread_local FILE *result_file;
 static char *result_file_name= 0;
 static const char *output_prefix= "";
 static char **defaults_argv= 0;
@@ -149,10 +151,12 @@ static ulonglong start_position, stop_position;
 
 static char *start_datetime_str, *stop_datetime_str;
 static my_time_t start_datetime= 0, stop_datetime= MY_TIME_T_MAX;
-static ulonglong rec_count= 0;
+static Atomic_counter<ulonglong> rec_count(0);
 static MYSQL* mysql = NULL;
 static const char* dirname_for_local_load= 0;
 static bool opt_skip_annotate_row_events= 0;
+static uint opt_parallel_decode= 0;
+static DYNAMIC_ARRAY do_domain_ids, ignore_domain_ids;
 
 static my_bool opt_flashback;
 static bool opt_print_table_metadata;
@@ -190,7 +194,7 @@ enum Exit_status {
   Also because of that when reading a remote Annotate event we have to keep
   its binary log representation in a separately allocated buffer.
 */
-static Annotate_rows_log_event *annotate_event= NULL;
+static thread_local Annotate_rows_log_event *annotate_event= NULL;
 
 static void free_annotate_event()
 {
@@ -253,6 +257,8 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *, const char*);
 static Exit_status dump_remote_log_entries(PRINT_EVENT_INFO *, const char*);
 static Exit_status dump_log_entries(const char* logname);
 static Exit_status safe_connect();
+static Exit_status process_transaction_payload(PRINT_EVENT_INFO *, Log_event *,
+                                               my_off_t, const char *);
 
 
 class Load_log_processor
@@ -1081,8 +1087,11 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         everything (in case the binlog has timestamps increasing and
         decreasing, we do this to avoid cutting the middle).
       */
-      start_datetime= 0;
-      offset= 0; // print everything and protect against cycling rec_count
+      if (start_datetime || offset)
+      {
+        start_datetime= 0;
+        offset= 0; // print everything and protect against cycling rec_count
+      }
       /*
         Skip events according to the --server-id flag.  However, don't
         skip format_description or rotate events, because they they
@@ -1510,6 +1519,13 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         destroy_evt= FALSE;
       break;
     }
+    case TRANSACTION_PAYLOAD_EVENT:
+      if (ev->print(result_file, print_event_info))
+        goto err;
+      if ((retval= process_transaction_payload(print_event_info, ev, pos,
+                                               logname)) != OK_CONTINUE)
+        goto end;
+      break;
     case START_ENCRYPTION_EVENT:
       glob_description_event->start_decryption((Start_encryption_log_event*)ev);
       /* fall through */
@@ -1576,6 +1592,629 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
 }
 
 
+/**
+  Process the events carried by a Transaction_payload_log_event like the
+  events read from the binlog. They all have the position of the payload
+  event.
+
+  @param[in,out] print_event_info Parameters and context state
+  determining how to print.
+  @param[in] ev The Transaction_payload_log_event.
+  @param[in] pos Offset of the payload event from beginning of binlog file.
+  @param[in] logname Name of input binlog.
+
+  @return As for process_event().
+*/
+static Exit_status
+process_transaction_payload(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
+                            my_off_t pos, const char *logname)
+{
+  char ll_buff[21];
+  char *events;
+  ulong events_len;
+  Exit_status retval= OK_CONTINUE;
+  DBUG_ENTER("process_transaction_payload");
+
+  if (transaction_payload_uncompress(glob_description_event,
+                                     ev->checksum_alg ==
+                                     BINLOG_CHECKSUM_ALG_CRC32,
+                                     ev->temp_buf,
+                                     uint4korr(ev->temp_buf + EVENT_LEN_OFFSET),
+                                     &events, &events_len))
+  {
+    error("Could not uncompress the transaction payload at position %s",
+          llstr(pos, ll_buff));
+    DBUG_RETURN(ERROR_STOP);
+  }
+
+  for (const char *ptr= events;
+       retval == OK_CONTINUE && ptr < events + events_len; )
+  {
+    uint len= uint4korr(ptr + EVENT_LEN_OFFSET);
+    const char *error_msg;
+    Log_event *inner_ev;
+    char *buf= (char*) my_memdup(PSI_NOT_INSTRUMENTED, ptr, len, MYF(MY_WME));
+    ptr+= len;
+
+    if (!buf)
+    {
+      retval= ERROR_STOP;
+      break;
+    }
+    if (!(inner_ev= Log_event::read_log_event(buf, len, &error_msg,
+                                              glob_description_event,
+                                              opt_verify_binlog_checksum)))
+    {
+      error("Could not construct log event object: %s", error_msg);
+      my_free(buf);
+      retval= ERROR_STOP;
+      break;
+    }
+    inner_ev->register_temp_buf(buf, TRUE);
+    retval= process_event(print_event_info, inner_ev, pos, logname);
+  }
+
+  my_free(events);
+  DBUG_RETURN(retval);
+}
+
+
+/*
+  --parallel-decode
+
+  The main thread reads the binlog and collects whole event groups into
+  batches of about DECODE_BATCH_SIZE bytes. Decoding threads print each batch
+  with their own PRINT_EVENT_INFO into a temporary file, and the main thread
+  copies the files to the output in binlog order. Everything that is not in
+  an event group (format description, rotate, ...), and groups that need
+  state shared with the main thread (LOAD DATA), are printed by the main
+  thread once all batches before them are written.
+*/
+
+#define DECODE_BATCH_SIZE (1024*1024)
+
+struct Decode_event
+{
+  Log_event *ev;
+  my_off_t pos;
+};
+
+struct Decode_batch
+{
+  DYNAMIC_ARRAY events;                 // of Decode_event
+  const char *logname;
+  size_t size;
+  FILE *out;
+  Exit_status status;
+  /* Printed by the main thread, eg. for LOAD DATA events */
+  bool in_main;
+  bool decoded;
+  /* State of the main PRINT_EVENT_INFO when the batch was started */
+  bool printed_fd_event;
+  uint8 common_header_len;
+  /*
+    False if events with LOG_EVENT_SKIP_REPLICATION_F were read before the
+    batch, so that @@skip_replication may be set when the batch starts.
+  */
+  bool skip_replication_known;
+  /* Value of @@skip_replication after the decoded batch */
+  bool skip_replication;
+  Decode_batch *next, *next_todo;
+};
+
+static uint decode_thread_count= 0;
+static pthread_t *decode_threads;
+static pthread_mutex_t decode_mutex;
+static pthread_cond_t decode_todo_cond, decode_done_cond;
+static bool decode_shutdown;
+/* All submitted batches in binlog order, and those not yet decoded */
+static Decode_batch *decode_first, *decode_last;
+static Decode_batch *decode_todo_first, *decode_todo_last;
+static uint decode_pending;
+/* The batch the main thread adds events to */
+static Decode_batch *decode_batch_filling;
+/* First error or stop returned for a batch; later batches are not written */
+static Exit_status decode_status= OK_CONTINUE;
+/*
+  True when batches were written since the main thread last printed, so
+  that the db, charset etc. remembered in its PRINT_EVENT_INFO are stale.
+*/
+static bool decode_state_unknown;
+/* True once any event with LOG_EVENT_SKIP_REPLICATION_F has been read */
+static bool skip_replication_seen;
+
+/* Event group tracking for dispatch_event() */
+static bool in_event_group, event_group_standalone;
+static bool skip_event_group, event_group_in_main;
+
+
+/**
+  Indicates whether the event group of the given GTID domain should be
+  filtered out, according to --do-domain-ids and --ignore-domain-ids.
+*/
+static bool shall_skip_domain(uint32 domain_id)
+{
+  DYNAMIC_ARRAY *ids= (do_domain_ids.elements ? &do_domain_ids :
+                       &ignore_domain_ids);
+  bool found= false;
+
+  for (size_t i= 0; !found && i < ids->elements; i++)
+    found= *dynamic_element(ids, i, uint32*) == domain_id;
+  return do_domain_ids.elements ? !found : found;
+}
+
+
+/**
+  Indicates whether the event is a non-final part of a standalone event
+  group, like Log_event::is_part_of_group() in the server.
+*/
+static bool is_group_prefix_event(Log_event_type type)
+{
+  switch (type) {
+  case INTVAR_EVENT:
+  case RAND_EVENT:
+  case USER_VAR_EVENT:
+  case TABLE_MAP_EVENT:
+  case ANNOTATE_ROWS_EVENT:
+  case TRANSACTION_PAYLOAD_EVENT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+
+/**
+  Indicates whether the event uses state that only the main thread has,
+  so that its event group cannot be printed by a decoding thread.
+*/
+static bool needs_main_thread(Log_event_type type)
+{
+  switch (type) {
+  case CREATE_FILE_EVENT:
+  case APPEND_BLOCK_EVENT:
+  case EXEC_LOAD_EVENT:
+  case DELETE_FILE_EVENT:
+  case BEGIN_LOAD_QUERY_EVENT:
+  case EXECUTE_LOAD_QUERY_EVENT:
+  case START_ENCRYPTION_EVENT:
+    return true;
+  default:
+    return false;
+  }
+}
+
+
+/**
+  Forget the db, charset, sql_mode etc. that the main PRINT_EVENT_INFO
+  remembers as printed, so that the next event prints them again.
+*/
+static void forget_printed_state(PRINT_EVENT_INFO *print_event_info)
+{
+  print_event_info->db[0]= 0;
+  print_event_info->charset_inited= 0;
+  print_event_info->flags2_inited= 0;
+  print_event_info->sql_mode_inited= 0;
+  print_event_info->time_zone_str[0]= 0;
+  print_event_info->lc_time_names_number= ~0;
+  print_event_info->charset_database_number= ILLEGAL_CHARSET_INFO_NUMBER;
+  print_event_info->auto_increment_increment= 0;
+  print_event_info->auto_increment_offset= 0;
+  print_event_info->thread_id_printed= false;
+  print_event_info->server_id_printed= false;
+  print_event_info->domain_id_printed= false;
+  print_event_info->allow_parallel_printed= false;
+}
+
+
+static FILE *open_decode_file()
+{
+  char name[FN_REFLEN];
+  File fd;
+  FILE *file;
+
+  if ((fd= create_temp_file(name, NullS, "mysqlbinlog", O_BINARY,
+                            MYF(MY_WME | MY_TEMPORARY))) < 0)
+    return 0;
+  if (!(file= my_fdopen(fd, name, O_RDWR | O_BINARY, MYF(MY_WME))))
+    my_close(fd, MYF(0));
+  return file;
+}
+
+
+static void free_decode_batch(Decode_batch *batch)
+{
+  for (size_t i= 0; i < batch->events.elements; i++)
+    delete dynamic_element(&batch->events, i, Decode_event*)->ev;
+  delete_dynamic(&batch->events);
+  if (batch->out)
+    my_fclose(batch->out, MYF(0));
+  my_free(batch);
+}
+
+
+/**
+  Print the events of a batch with process_event(), and delete them.
+
+  @return As for process_event().
+*/
+static Exit_status decode_batch(Decode_batch *batch,
+                                PRINT_EVENT_INFO *print_event_info)
+{
+  Exit_status retval= OK_CONTINUE;
+  size_t i;
+
+  for (i= 0; retval == OK_CONTINUE && i < batch->events.elements; i++)
+  {
+    Decode_event *de= dynamic_element(&batch->events, i, Decode_event*);
+    retval= process_event(print_event_info, de->ev, de->pos, batch->logname);
+  }
+  /* process_event() deleted the events it was given */
+  for (; i < batch->events.elements; i++)
+    delete dynamic_element(&batch->events, i, Decode_event*)->ev;
+  reset_dynamic(&batch->events);
+  return retval;
+}
+
+
+/**
+  Print a batch into its own file, in a decoding thread.
+*/
+static Exit_status decode_batch_to_file(Decode_batch *batch)
+{
+  PRINT_EVENT_INFO print_event_info;
+  Exit_status retval;
+
+  if (!print_event_info.init_ok() || !(batch->out= open_decode_file()))
+    return ERROR_STOP;
+  result_file= batch->out;
+  strmov(print_event_info.delimiter, "/*!*/;");
+  print_event_info.verbose= short_form ? 0 : verbose;
+  print_event_info.short_form= short_form;
+  print_event_info.print_row_count= print_row_count;
+  print_event_info.printed_fd_event= batch->printed_fd_event;
+  print_event_info.common_header_len= batch->common_header_len;
+  print_event_info.file= batch->out;
+  if (!batch->skip_replication_known)
+  {
+    /* Make the first event of the batch set @@skip_replication */
+    Log_event *ev= dynamic_element(&batch->events, 0, Decode_event*)->ev;
+    print_event_info.skip_replication=
+      !(ev->flags & LOG_EVENT_SKIP_REPLICATION_F);
+    print_skip_replication_statement(&print_event_info, ev);
+  }
+
+  retval= decode_batch(batch, &print_event_info);
+  /* An Annotate_rows event whose table maps were all filtered away */
+  free_annotate_event();
+  batch->skip_replication= print_event_info.skip_replication;
+  if (fflush(batch->out))
+    retval= ERROR_STOP;
+  result_file= 0;
+  return retval;
+}
+
+
+pthread_handler_t decode_thread(void *arg __attribute__((unused)))
+{
+  my_thread_init();
+  pthread_mutex_lock(&decode_mutex);
+  for (;;)
+  {
+    Decode_batch *batch;
+
+    while (!(batch= decode_todo_first) && !decode_shutdown)
+      pthread_cond_wait(&decode_todo_cond, &decode_mutex);
+    if (decode_shutdown)
+      break;
+    if (!(decode_todo_first= batch->next_todo))
+      decode_todo_last= 0;
+    pthread_mutex_unlock(&decode_mutex);
+
+    Exit_status status= decode_batch_to_file(batch);
+
+    pthread_mutex_lock(&decode_mutex);
+    batch->status= status;
+    batch->decoded= true;
+    pthread_cond_broadcast(&decode_done_cond);
+  }
+  pthread_mutex_unlock(&decode_mutex);
+  my_thread_end();
+  return 0;
+}
+
+
+static int start_decode_threads(uint count)
+{
+  pthread_mutex_init(&decode_mutex, NULL);
+  pthread_cond_init(&decode_todo_cond, NULL);
+  pthread_cond_init(&decode_done_cond, NULL);
+  if (!(decode_threads= (pthread_t*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                               count * sizeof(pthread_t),
+                                               MYF(MY_WME))))
+    return 1;
+  for (; decode_thread_count < count; decode_thread_count++)
+  {
+    if (pthread_create(&decode_threads[decode_thread_count], NULL,
+                       decode_thread, NULL))
+    {
+      error("Could not create decoding thread");
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
+/**
+  Stop the decoding threads, and free the batches that were not written.
+*/
+static void end_decode_threads()
+{
+  if (!decode_threads)
+    return;
+  pthread_mutex_lock(&decode_mutex);
+  decode_shutdown= true;
+  pthread_cond_broadcast(&decode_todo_cond);
+  pthread_mutex_unlock(&decode_mutex);
+  for (uint i= 0; i < decode_thread_count; i++)
+    pthread_join(decode_threads[i], NULL);
+  my_free(decode_threads);
+  decode_threads= 0;
+  decode_thread_count= 0;
+
+  while (decode_first)
+  {
+    Decode_batch *batch= decode_first;
+    decode_first= batch->next;
+    free_decode_batch(batch);
+  }
+  if (decode_batch_filling)
+    free_decode_batch(decode_batch_filling);
+  decode_batch_filling= 0;
+  pthread_mutex_destroy(&decode_mutex);
+  pthread_cond_destroy(&decode_todo_cond);
+  pthread_cond_destroy(&decode_done_cond);
+}
+
+
+/**
+  Copy a batch printed by a decoding thread to the output, and take over
+  the @@skip_replication value it ended with.
+*/
+static Exit_status write_decode_file(Decode_batch *batch,
+                                     PRINT_EVENT_INFO *print_event_info)
+{
+  uchar buff[IO_SIZE];
+  size_t length;
+
+  if (batch->out)
+  {
+    rewind(batch->out);
+    while ((length= fread(buff, 1, sizeof(buff), batch->out)) > 0)
+    {
+      if (my_fwrite(result_file, buff, length, MYF(MY_WME | MY_NABP)))
+        return ERROR_STOP;
+    }
+    if (ferror(batch->out))
+    {
+      error("Could not read decoded events from temporary file.");
+      return ERROR_STOP;
+    }
+  }
+  print_event_info->skip_replication= batch->skip_replication;
+  decode_state_unknown= true;
+  return batch->status;
+}
+
+
+/**
+  Write the submitted batches that are decoded, in binlog order, and print
+  the ones that are for the main thread.
+
+  @param max_pending Wait for batches to be decoded until at most this
+  many are left.
+
+  @return As for process_event().
+*/
+static Exit_status write_decoded_batches(PRINT_EVENT_INFO *print_event_info,
+                                         uint max_pending)
+{
+  pthread_mutex_lock(&decode_mutex);
+  while (decode_first && decode_status == OK_CONTINUE)
+  {
+    Decode_batch *batch= decode_first;
+    Exit_status retval;
+
+    if (!batch->in_main && !batch->decoded)
+    {
+      if (decode_pending <= max_pending)
+        break;
+      pthread_cond_wait(&decode_done_cond, &decode_mutex);
+      continue;
+    }
+    if (!(decode_first= batch->next))
+      decode_last= 0;
+    decode_pending--;
+    pthread_mutex_unlock(&decode_mutex);
+
+    if (batch->in_main)
+    {
+      if (decode_state_unknown)
+        forget_printed_state(print_event_info);
+      decode_state_unknown= false;
+      retval= decode_batch(batch, print_event_info);
+    }
+    else
+      retval= write_decode_file(batch, print_event_info);
+    free_decode_batch(batch);
+    if (retval != OK_CONTINUE)
+      decode_status= retval;
+
+    pthread_mutex_lock(&decode_mutex);
+  }
+  pthread_mutex_unlock(&decode_mutex);
+  return decode_status;
+}
+
+
+/**
+  Hand the batch being filled to the decoding threads, and write what is
+  decoded, waiting if too many batches are pending.
+*/
+static Exit_status submit_decode_batch(PRINT_EVENT_INFO *print_event_info)
+{
+  Decode_batch *batch= decode_batch_filling;
+
+  if (!batch)
+    return OK_CONTINUE;
+  decode_batch_filling= 0;
+
+  pthread_mutex_lock(&decode_mutex);
+  if (decode_last)
+    decode_last->next= batch;
+  else
+    decode_first= batch;
+  decode_last= batch;
+  decode_pending++;
+  if (!batch->in_main)
+  {
+    if (decode_todo_last)
+      decode_todo_last->next_todo= batch;
+    else
+      decode_todo_first= batch;
+    decode_todo_last= batch;
+    pthread_cond_signal(&decode_todo_cond);
+  }
+  pthread_mutex_unlock(&decode_mutex);
+
+  /* Bound the memory used by the events of pending batches */
+  return write_decoded_batches(print_event_info, 2 * decode_thread_count);
+}
+
+
+/**
+  Write all batches, so that the main thread can print the next event.
+*/
+static Exit_status flush_decode_batches(PRINT_EVENT_INFO *print_event_info)
+{
+  Exit_status retval;
+
+  if (!decode_thread_count)
+    return OK_CONTINUE;
+  if ((retval= submit_decode_batch(print_event_info)) != OK_CONTINUE ||
+      (retval= write_decoded_batches(print_event_info, 0)) != OK_CONTINUE)
+    return retval;
+  if (decode_state_unknown)
+    forget_printed_state(print_event_info);
+  decode_state_unknown= false;
+  return OK_CONTINUE;
+}
+
+
+static Exit_status queue_decode_event(PRINT_EVENT_INFO *print_event_info,
+                                      Log_event *ev, my_off_t pos,
+                                      const char *logname, bool group_end)
+{
+  Decode_batch *batch= decode_batch_filling;
+  Decode_event de= { ev, pos };
+
+  if (!batch)
+  {
+    if (!(batch= (Decode_batch*) my_malloc(PSI_NOT_INSTRUMENTED,
+                                           sizeof(Decode_batch),
+                                           MYF(MY_WME | MY_ZEROFILL))) ||
+        my_init_dynamic_array(PSI_NOT_INSTRUMENTED, &batch->events,
+                              sizeof(Decode_event), 256, 256, MYF(0)))
+    {
+      my_free(batch);
+      delete ev;
+      return ERROR_STOP;
+    }
+    batch->logname= logname;
+    batch->status= OK_CONTINUE;
+    batch->printed_fd_event= print_event_info->printed_fd_event;
+    batch->common_header_len= print_event_info->common_header_len;
+    /* Nothing but @@skip_replication=0 has been printed yet */
+    batch->skip_replication_known= !skip_replication_seen;
+    decode_batch_filling= batch;
+  }
+  if (insert_dynamic(&batch->events, (uchar*) &de))
+  {
+    error("Out of memory");
+    delete ev;
+    return ERROR_STOP;
+  }
+  if (ev->temp_buf)
+    batch->size+= uint4korr(ev->temp_buf + EVENT_LEN_OFFSET);
+  if (needs_main_thread(ev->get_type_code()))
+    batch->in_main= true;
+
+  if (group_end && batch->size >= DECODE_BATCH_SIZE)
+    return submit_decode_batch(print_event_info);
+  return OK_CONTINUE;
+}
+
+
+/**
+  Process an event read from the binlog: filter its event group by GTID
+  domain, and print it with process_event() or queue it for the decoding
+  threads.
+
+  Parameters and return value as for process_event().
+*/
+static Exit_status dispatch_event(PRINT_EVENT_INFO *print_event_info,
+                                  Log_event *ev, my_off_t pos,
+                                  const char *logname)
+{
+  Log_event_type ev_type= ev->get_type_code();
+  bool group_event= in_event_group;
+  Exit_status retval;
+
+  if (ev->flags & LOG_EVENT_SKIP_REPLICATION_F)
+    skip_replication_seen= true;
+
+  if (ev_type == GTID_EVENT)
+  {
+    Gtid_log_event *gev= (Gtid_log_event*) ev;
+    group_event= in_event_group= true;
+    event_group_standalone= gev->flags2 & Gtid_log_event::FL_STANDALONE;
+    skip_event_group= ((do_domain_ids.elements ||
+                        ignore_domain_ids.elements) &&
+                       shall_skip_domain(gev->domain_id));
+    /* --start-datetime and --offset need the events one at a time */
+    event_group_in_main= start_datetime || offset;
+  }
+  else if (in_event_group &&
+           (event_group_standalone ? !is_group_prefix_event(ev_type) :
+            (ev_type == XID_EVENT || ev_type == XA_PREPARE_LOG_EVENT ||
+             (LOG_EVENT_IS_QUERY(ev_type) &&
+              (((Query_log_event*) ev)->is_commit() ||
+               ((Query_log_event*) ev)->is_rollback())))))
+    in_event_group= false;                      // Last event of the group
+
+  if (group_event && skip_event_group)
+  {
+    delete ev;
+    return OK_CONTINUE;
+  }
+  if (!decode_thread_count)
+    return process_event(print_event_info, ev, pos, logname);
+
+  if (group_event && !event_group_in_main &&
+      ev->when < stop_datetime && pos < stop_position_mot)
+    return queue_decode_event(print_event_info, ev, pos, logname,
+                              !in_event_group);
+
+  if ((retval= flush_decode_batches(print_event_info)) != OK_CONTINUE)
+  {
+    delete ev;
+    return retval;
+  }
+  return process_event(print_event_info, ev, pos, logname);
+}
+
+
 static struct my_option my_options[] =
 {
   {"help", '?', "Display this help and exit.",
@@ -1809,6 +2448,21 @@ Example: rewrite-db='from->to'.",
    "Print metadata stored in Table_map_log_event",
    &opt_print_table_metadata, &opt_print_table_metadata, 0,
    GET_BOOL, NO_ARG, 0, 0, 0, 0, 0, 0},
+  {"parallel-decode", 0,
+   "Decode the events of a local binlog in this many threads. The output "
+   "stays in binlog order, but session variables and the default database "
+   "are printed again for every batch of transactions. Cannot be used with "
+   "--read-from-remote-server or --flashback. 0 means no decoding threads.",
+   &opt_parallel_decode, &opt_parallel_decode, 0,
+   GET_UINT, REQUIRED_ARG, 0, 0, 256, 0, 1, 0},
+  {"do-domain-ids", OPT_DO_DOMAIN_IDS,
+   "Print only the event groups whose GTID is in one of these domains, "
+   "given as a comma-separated list of domain ids.",
+   0, 0, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
+  {"ignore-domain-ids", OPT_IGNORE_DOMAIN_IDS,
+   "Skip the event groups whose GTID is in one of these domains, given as "
+   "a comma-separated list of domain ids.",
+   0, 0, 0, GET_STR, REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
   {0, 0, 0, 0, 0, 0, GET_NO_ARG, NO_ARG, 0, 0, 0, 0, 0, 0}
 };
 
@@ -1899,6 +2553,9 @@ static void cleanup()
   if (mysql)
     mysql_close(mysql);
   free_defaults(defaults_argv);
+  end_decode_threads();
+  delete_dynamic(&do_domain_ids);
+  delete_dynamic(&ignore_domain_ids);
   free_annotate_event();
   my_free_open_file_info();
   load_processor.destroy();
@@ -1960,6 +2617,46 @@ static my_time_t convert_str_to_timestamp(const char* str)
 }
 
 
+/**
+  Parse a comma-separated list of GTID domain ids for --do-domain-ids or
+  --ignore-domain-ids.
+
+  @return 0 on success, 1 on a malformed list.
+*/
+static int parse_domain_ids(const char *str, DYNAMIC_ARRAY *ids,
+                            const char *option)
+{
+  const char *ptr= str;
+
+  for (;;)
+  {
+    char *end;
+    ulonglong id;
+    uint32 domain_id;
+
+    while (my_isspace(&my_charset_latin1, *ptr))
+      ptr++;
+    if (!my_isdigit(&my_charset_latin1, *ptr))
+      break;
+    errno= 0;
+    id= strtoull(ptr, &end, 10);
+    if (errno || id > UINT_MAX32)
+      break;
+    domain_id= (uint32) id;
+    if (insert_dynamic(ids, (uchar*) &domain_id))
+      return 1;
+    for (ptr= end; my_isspace(&my_charset_latin1, *ptr); ptr++)
+    {}
+    if (!*ptr)
+      return 0;
+    if (*ptr++ != ',')
+      break;
+  }
+  sql_print_error("Bad domain id list for --%s: '%s'\n", option, str);
+  return 1;
+}
+
+
 extern "C" my_bool
 get_one_option(const struct my_option *opt, const char *argument, const char *filename)
 {
@@ -2100,6 +2797,14 @@ get_one_option(const struct my_option *opt, const char *argument, const char *fi
     binlog_filter->add_db_rewrite(key, val);
     break;
   }
+  case OPT_DO_DOMAIN_IDS:
+    if (parse_domain_ids(argument, &do_domain_ids, opt->name))
+      return 1;
+    break;
+  case OPT_IGNORE_DOMAIN_IDS:
+    if (parse_domain_ids(argument, &ignore_domain_ids, opt->name))
+      return 1;
+    break;
   case OPT_PRINT_ROW_COUNT:
     print_row_count_used= 1;
     break;
@@ -2255,7 +2960,7 @@ static Exit_status safe_connect()
 */
 static Exit_status dump_log_entries(const char* logname)
 {
-  Exit_status rc;
+  Exit_status rc, flush_rc;
   PRINT_EVENT_INFO print_event_info;
 
   if (!print_event_info.init_ok())
@@ -2289,6 +2994,11 @@ static Exit_status dump_log_entries(const char* logname)
   rc= (remote_opt ? dump_remote_log_entries(&print_event_info, logname) :
        dump_local_log_entries(&print_event_info, logname));
 
+  /* Write the batches left with the decoding threads, even after an error */
+  flush_rc= flush_decode_batches(&print_event_info);
+  if (rc != ERROR_STOP && flush_rc != OK_CONTINUE)
+    rc= flush_rc;
+
   if (rc == ERROR_STOP)
     return rc;
 
@@ -2494,7 +3204,7 @@ static Exit_status handle_event_text_mode(PRINT_EVENT_INFO *print_event_info,
       if (old_off != BIN_LOG_HEADER_SIZE)
         *len= 1;         // fake event, don't increment old_off
     }
-    Exit_status retval= process_event(print_event_info, ev, old_off, logname);
+    Exit_status retval= dispatch_event(print_event_info, ev, old_off, logname);
     if (retval != OK_CONTINUE)
       DBUG_RETURN(retval);
   }
@@ -3060,7 +3770,7 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
       // file->error == 0 means EOF, that's OK, we break in this case
       goto end;
     }
-    if ((retval= process_event(print_event_info, ev, old_off, logname)) !=
+    if ((retval= dispatch_event(print_event_info, ev, old_off, logname)) !=
         OK_CONTINUE)
       goto end;
   }
@@ -3102,6 +3812,10 @@ int main(int argc, char** argv)
   defaults_argv= argv;
 
   init_alloc_root(PSI_NOT_INSTRUMENTED, &glob_root, 1024, 0, MYF(0));
+  my_init_dynamic_array(PSI_NOT_INSTRUMENTED, &do_domain_ids, sizeof(uint32),
+                        16, 16, MYF(0));
+  my_init_dynamic_array(PSI_NOT_INSTRUMENTED, &ignore_domain_ids,
+                        sizeof(uint32), 16, 16, MYF(0));
 
   if (!(binlog_filter= new Rpl_filter))
   {
@@ -3140,6 +3854,25 @@ int main(int argc, char** argv)
     my_init_dynamic_array(PSI_NOT_INSTRUMENTED, &events_in_stmt,
                           sizeof(Rows_log_event*), 1024, 1024, MYF(0));
   }
+  if (do_domain_ids.elements && ignore_domain_ids.elements)
+  {
+    error("The --do-domain-ids and --ignore-domain-ids options cannot be "
+          "used together");
+    die();
+  }
+  if (opt_parallel_decode)
+  {
+    if (remote_opt)
+    {
+      error("The --parallel-decode option only works with local binlogs");
+      die();
+    }
+    if (opt_flashback)
+    {
+      error("The --parallel-decode option cannot be used with --flashback");
+      die();
+    }
+  }
   if (opt_stop_never)
     to_last_remote_log= TRUE;
 
@@ -3199,6 +3932,12 @@ int main(int argc, char** argv)
   else
     load_processor.init_by_cur_dir();
 
+  if (opt_parallel_decode && start_decode_threads(opt_parallel_decode))
+  {
+    retval= ERROR_STOP;
+    goto err;
+  }
+
   if (!opt_raw_mode)
   {
     fprintf(result_file, "/*!50530 SET @@SESSION.PSEUDO_SLAVE_MODE=1*/;\n");
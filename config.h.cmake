@@ -207,6 +207,7 @@
 #cmakedefine HAVE_RWLOCK_INIT 1
 #cmakedefine HAVE_SCHED_YIELD 1
 #cmakedefine HAVE_SELECT 1
+#cmakedefine HAVE_SENDFILE 1
 #cmakedefine HAVE_SETENV 1
 #cmakedefine HAVE_SETLOCALE 1
 #cmakedefine HAVE_SETUPTERM 1
@@ -220,7 +220,10 @@ xb_fil_cur_open(
 	cursor->buf_page_no = 0;
 	cursor->thread_n = thread_n;
 
-	if (!node->space->crypt_data
+	const bool need_zstd_dict = node->space->is_compressed()
+		&& !node->space->zstd_dict;
+
+	if ((!node->space->crypt_data || need_zstd_dict)
 	    && os_file_read(IORequestRead,
 			    node->handle, cursor->buf, 0,
 			    cursor->page_size) == DB_SUCCESS) {
@@ -229,6 +232,10 @@ xb_fil_cur_open(
 			node->space->crypt_data = fil_space_read_crypt_data(
 				node->space->zip_size(), cursor->buf);
 		}
+		if (need_zstd_dict && !node->space->zstd_dict) {
+			node->space->zstd_dict = fil_zstd_dict_read(
+				cursor->buf);
+		}
 		mysql_mutex_unlock(&fil_system.mutex);
 	}
 
@@ -331,7 +338,8 @@ static bool page_is_corrupted(const byte *page, ulint page_no,
 	if (page_type == FIL_PAGE_PAGE_COMPRESSED
 	    || page_type == FIL_PAGE_PAGE_COMPRESSED_ENCRYPTED) {
 		ulint decomp = fil_page_decompress(tmp_frame, tmp_page,
-						   space->flags);
+						   space->flags,
+						   space->zstd_dict);
 		page_type = fil_page_get_type(tmp_page);
 
 		return (!decomp
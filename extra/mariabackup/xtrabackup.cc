@@ -74,6 +74,7 @@ Street, Fifth Floor, Boston, MA 02110-1335 USA
 #include <dict0priv.h>
 #include <lock0lock.h>
 #include <log0recv.h>
+#include <log0arch.h>
 #include <log0crypt.h>
 #include <row0mysql.h>
 #include <row0quiesce.h>
@@ -152,6 +153,8 @@ xb_page_bitmap *changed_page_bitmap;
 char *xtrabackup_incremental_basedir; /* for --backup */
 char *xtrabackup_extra_lsndir; /* for --backup with --extra-lsndir */
 char *xtrabackup_incremental_dir; /* for --prepare */
+char *xtrabackup_log_archive_dir; /* for --prepare */
+ulonglong xtrabackup_log_archive_to_lsn; /* for --prepare */
 
 char xtrabackup_real_incremental_basedir[FN_REFLEN];
 char xtrabackup_real_extra_lsndir[FN_REFLEN];
@@ -903,6 +906,8 @@ enum options_xtrabackup
   OPT_XTRA_INCREMENTAL_BASEDIR,
   OPT_XTRA_EXTRA_LSNDIR,
   OPT_XTRA_INCREMENTAL_DIR,
+  OPT_XTRA_LOG_ARCHIVE_DIR,
+  OPT_XTRA_LOG_ARCHIVE_TO_LSN,
   OPT_XTRA_TABLES,
   OPT_XTRA_TABLES_FILE,
   OPT_XTRA_DATABASES,
@@ -1056,6 +1061,18 @@ struct my_option xb_client_options[]= {
      (G_PTR *) &xtrabackup_incremental_dir,
      (G_PTR *) &xtrabackup_incremental_dir, 0, GET_STR, REQUIRED_ARG, 0, 0, 0,
      0, 0, 0},
+    {"log-archive-dir", OPT_XTRA_LOG_ARCHIVE_DIR,
+     "(for --prepare): roll the backup forward with the redo log that the "
+     "server archived in the specified directory (innodb_log_archive_dir).",
+     (G_PTR *) &xtrabackup_log_archive_dir,
+     (G_PTR *) &xtrabackup_log_archive_dir, 0, GET_STR, REQUIRED_ARG, 0, 0, 0,
+     0, 0, 0},
+    {"log-archive-to-lsn", OPT_XTRA_LOG_ARCHIVE_TO_LSN,
+     "(for --prepare with --log-archive-dir): apply the archived redo log "
+     "only up to the specified LSN. By default, all of it is applied.",
+     (G_PTR *) &xtrabackup_log_archive_to_lsn,
+     (G_PTR *) &xtrabackup_log_archive_to_lsn, 0, GET_ULL, REQUIRED_ARG, 0, 0,
+     0, 0, 0, 0},
     {"tables", OPT_XTRA_TABLES, "filtering by regexp for table names.",
      (G_PTR *) &xtrabackup_tables, (G_PTR *) &xtrabackup_tables, 0, GET_STR,
      REQUIRED_ARG, 0, 0, 0, 0, 0, 0},
@@ -5587,6 +5604,182 @@ static ibool prepare_handle_del_files(const char *datadir, const char *db, const
 	return TRUE;
 }
 
+/** Append the archived redo log that follows the end of LOG_FILE_NAME
+in the backup (--log-archive-dir, --log-archive-to-lsn).
+@return	whether the operation succeeded */
+static bool xb_log_archive_apply()
+{
+	File	file = my_open(LOG_FILE_NAME, O_RDWR | O_BINARY, MYF(MY_WME));
+	if (file < 0) {
+		return false;
+	}
+
+	bool	ok = false;
+	MY_DIR*	dir = NULL;
+	byte	block[OS_FILE_LOG_BLOCK_SIZE];
+	/* archive files by their start LSN, with the end LSN */
+	std::map<lsn_t, std::pair<std::string, lsn_t> > archive;
+	const my_off_t size = my_seek(file, 0, SEEK_END, MYF(0));
+	lsn_t	stop_lsn = xtrabackup_log_archive_to_lsn
+		? lsn_t(xtrabackup_log_archive_to_lsn) : LSN_MAX;
+
+	if (size == MY_FILEPOS_ERROR
+	    || size < LOG_FILE_HDR_SIZE + OS_FILE_LOG_BLOCK_SIZE
+	    || size % OS_FILE_LOG_BLOCK_SIZE
+	    || my_pread(file, block, sizeof block, 0, MYF(MY_WME | MY_NABP))) {
+		msg("Error: cannot read the header of %s", LOG_FILE_NAME);
+		goto func_exit;
+	}
+
+	{
+		/* The backup log is contiguous. The block that contains
+		LOG_HEADER_START_LSN is at LOG_FILE_HDR_SIZE. The last block
+		may be incomplete; it will be overwritten. */
+		my_off_t offset = size - OS_FILE_LOG_BLOCK_SIZE;
+		lsn_t	lsn = ut_uint64_align_down(
+			mach_read_from_8(block + LOG_HEADER_START_LSN),
+			OS_FILE_LOG_BLOCK_SIZE)
+			+ (offset - LOG_FILE_HDR_SIZE);
+		const lsn_t backup_end_lsn = lsn;
+
+		if (stop_lsn < backup_end_lsn) {
+			msg("Error: --log-archive-to-lsn=" LSN_PF
+			    " precedes the end of the backup log " LSN_PF,
+			    stop_lsn, backup_end_lsn);
+			goto func_exit;
+		}
+
+		dir = my_dir(xtrabackup_log_archive_dir,
+			     MYF(MY_WME | MY_WANT_STAT));
+		if (!dir) {
+			goto func_exit;
+		}
+
+		for (uint i = 0; i < dir->number_of_files; i++) {
+			const fileinfo& f = dir->dir_entry[i];
+			if (strncmp(f.name, LOG_ARCHIVE_PREFIX,
+				    sizeof LOG_ARCHIVE_PREFIX - 1)) {
+				continue;
+			}
+			char*	end;
+			const lsn_t start = strtoull(
+				f.name + sizeof LOG_ARCHIVE_PREFIX - 1,
+				&end, 10);
+			if (*end || !start
+			    || start % OS_FILE_LOG_BLOCK_SIZE) {
+				continue;
+			}
+			archive[start] = std::make_pair(
+				std::string(xtrabackup_log_archive_dir)
+				+ "/" + f.name,
+				start + ut_uint64_align_down(
+					lsn_t(f.mystat->st_size),
+					OS_FILE_LOG_BLOCK_SIZE));
+		}
+
+		while (lsn < stop_lsn) {
+			/* Find the archive file that extends the furthest
+			from lsn. */
+			auto a = archive.end();
+			for (auto i = archive.begin();
+			     i != archive.end() && i->first <= lsn; i++) {
+				if (i->second.second > lsn
+				    && (a == archive.end()
+					|| i->second.second
+					> a->second.second)) {
+					a = i;
+				}
+			}
+
+			if (a == archive.end()) {
+				break;
+			}
+
+			File arch = my_open(a->second.first.c_str(),
+					    O_RDONLY | O_BINARY, MYF(MY_WME));
+			if (arch < 0) {
+				goto func_exit;
+			}
+
+			msg("Applying %s", a->second.first.c_str());
+
+			for (; lsn < a->second.second && lsn < stop_lsn;
+			     lsn += OS_FILE_LOG_BLOCK_SIZE,
+			     offset += OS_FILE_LOG_BLOCK_SIZE) {
+				if (my_pread(arch, block, sizeof block,
+					     lsn - a->first,
+					     MYF(MY_WME | MY_NABP))) {
+					my_close(arch, MYF(0));
+					goto func_exit;
+				}
+
+				if (log_block_get_hdr_no(block)
+				    != log_block_convert_lsn_to_no(lsn)) {
+					msg("Error: unexpected block in %s "
+					    "at LSN " LSN_PF,
+					    a->second.first.c_str(), lsn);
+					my_close(arch, MYF(0));
+					goto func_exit;
+				}
+
+				if (stop_lsn - lsn < OS_FILE_LOG_BLOCK_SIZE) {
+					/* Ignore anything after stop_lsn.
+					An incomplete mini-transaction at the
+					end will not be applied. */
+					ulint data_len = ulint(stop_lsn - lsn);
+					if (data_len < LOG_BLOCK_HDR_SIZE) {
+						data_len = LOG_BLOCK_HDR_SIZE;
+					}
+					if (data_len
+					    < log_block_get_data_len(block)) {
+						log_block_set_data_len(
+							block, data_len);
+						log_block_set_checksum(
+							block,
+							log_block_calc_checksum_crc32(
+								block));
+					}
+				}
+
+				if (my_pwrite(file, block, sizeof block,
+					      offset,
+					      MYF(MY_WME | MY_NABP))) {
+					my_close(arch, MYF(0));
+					goto func_exit;
+				}
+			}
+
+			my_close(arch, MYF(0));
+		}
+
+		if (lsn == backup_end_lsn) {
+			msg("Error: --log-archive-dir=%s does not contain"
+			    " the redo log from LSN " LSN_PF,
+			    xtrabackup_log_archive_dir, backup_end_lsn);
+			goto func_exit;
+		}
+
+		if (lsn < stop_lsn && xtrabackup_log_archive_to_lsn) {
+			msg("Error: --log-archive-dir=%s does not contain"
+			    " the redo log from LSN " LSN_PF
+			    " to --log-archive-to-lsn=" LSN_PF,
+			    xtrabackup_log_archive_dir, lsn, stop_lsn);
+			goto func_exit;
+		}
+
+		msg("Rolled the backup log forward from LSN " LSN_PF
+		    " to " LSN_PF, backup_end_lsn, std::min(lsn, stop_lsn));
+		ok = !my_sync(file, MYF(MY_WME));
+	}
+
+func_exit:
+	if (dir) {
+		my_dirend(dir);
+	}
+	my_close(file, MYF(MY_WME));
+	return ok;
+}
+
 /** Implement --prepare
 @return	whether the operation succeeded */
 static bool xtrabackup_prepare_func(char** argv)
@@ -5675,6 +5868,22 @@ static bool xtrabackup_prepare_func(char** argv)
 		return(false);
 	}
 
+	if (xtrabackup_log_archive_dir) {
+		if (xtrabackup_incremental) {
+			msg("error: --log-archive-dir cannot be combined "
+			    "with --incremental-dir.");
+			return(false);
+		}
+		if (strcmp(metadata_type, "full-backuped")) {
+			msg("error: --log-archive-dir requires a target "
+			    "that was not prepared yet.");
+			return(false);
+		}
+		if (!xb_log_archive_apply()) {
+			return(false);
+		}
+	}
+
 	srv_max_n_threads = 1000;
 	srv_n_purge_threads = 1;
 
@@ -5794,6 +6003,13 @@ static bool xtrabackup_prepare_func(char** argv)
 	else if (ok) xb_write_galera_info(xtrabackup_incremental);
 #endif
 
+	if (xtrabackup_log_archive_dir && recv_sys.recovered_lsn) {
+		/* The backup now corresponds to the end of the
+		last applied mini-transaction. */
+		metadata_to_lsn = recv_sys.recovered_lsn;
+		metadata_last_lsn = recv_sys.recovered_lsn;
+	}
+
         innodb_shutdown();
 
         innodb_free_param();
@@ -0,0 +1,271 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/* Sparse GTID index of binlog files, see gtid_index.h */
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "unireg.h"
+#include "mysqld.h"
+#include "log.h"
+#include "rpl_gtid.h"
+#include "gtid_index.h"
+
+my_bool opt_binlog_gtid_index= TRUE;
+ulong opt_binlog_gtid_index_span_min= 65536;
+
+static const uchar gtid_index_magic[8]=
+  { 0xfe, 'G', 'T', 'I', 'D', 'I', 'D', 'X' };
+static const uchar GTID_INDEX_VERSION= 2;
+/* Offset of the flags byte in the header */
+static const uint GTID_INDEX_FLAGS_OFFSET= 9;
+/* Size of one GTID in an entry */
+static const uint GTID_INDEX_GTID_SIZE= 16;
+
+
+void gtid_index_name(char *out, const char *binlog_name)
+{
+  strxnmov(out, FN_REFLEN - 1, binlog_name, GTID_INDEX_SUFFIX, NullS);
+}
+
+
+/* Delete the index of a binlog file that is being purged. */
+void gtid_index_delete(const char *binlog_name)
+{
+  char buf[FN_REFLEN];
+  gtid_index_name(buf, binlog_name);
+  mysql_file_delete(key_file_binlog_index, buf, MYF(0));
+}
+
+
+/*
+  Create the index for a new binlog file.
+
+  @param binlog_name  name of the binlog file
+  @param offset       end of the events at the start of the binlog file,
+                      whose GTID state is in its Gtid_list_log_event
+*/
+bool Gtid_index_writer::open(const char *binlog_name, my_off_t offset)
+{
+  uchar header[GTID_INDEX_HEADER_SIZE];
+
+  DBUG_ASSERT(!is_open());
+  gtid_index_name(name, binlog_name);
+  if ((file= mysql_file_create(key_file_binlog_index, name, 0,
+                               O_WRONLY | O_TRUNC | O_BINARY,
+                               MYF(MY_WME))) < 0)
+  {
+    sql_print_warning("Failed to create GTID index file '%s'; slaves "
+                      "connecting to binlog file '%s' will scan it from "
+                      "the start", name, binlog_name);
+    return true;
+  }
+
+  bzero(header, sizeof(header));
+  memcpy(header, gtid_index_magic, sizeof(gtid_index_magic));
+  header[sizeof(gtid_index_magic)]= GTID_INDEX_VERSION;
+  header[GTID_INDEX_FLAGS_OFFSET]= GTID_INDEX_FLAG_IN_USE;
+  if (mysql_file_write(file, header, sizeof(header), MYF(MY_WME | MY_NABP)))
+  {
+    abort("write");
+    return true;
+  }
+  last_offset= offset;
+  return false;
+}
+
+
+/* Stop writing the index after an error; it will not be used. */
+void Gtid_index_writer::abort(const char *what)
+{
+  sql_print_warning("Failed to %s GTID index file '%s' (errno: %d); it will "
+                    "not be updated any more", what, name, my_errno);
+  mysql_file_close(file, MYF(0));
+  file= -1;
+}
+
+
+/*
+  Note the end of a binlog group commit. Called under LOCK_log, after the
+  binlog has been written up to offset.
+
+  @param offset  the binlog offset after the last event group
+  @param state   the binlog GTID state at offset
+*/
+void Gtid_index_writer::process(my_off_t offset, rpl_binlog_state *state)
+{
+  if (!is_open() || offset < last_offset + opt_binlog_gtid_index_span_min)
+    return;
+
+  uint32 count= state->count();
+  size_t data_len= 12 + (size_t) count * GTID_INDEX_GTID_SIZE;
+  rpl_gtid *list= (rpl_gtid *) my_malloc(PSI_INSTRUMENT_ME,
+                                         count * sizeof(*list) + (count == 0),
+                                         MYF(MY_WME));
+  uchar *buf= (uchar *) my_malloc(PSI_INSTRUMENT_ME, data_len + 8,
+                                  MYF(MY_WME));
+  if (!list || !buf || state->get_gtid_list(list, count))
+  {
+    my_free(list);
+    my_free(buf);
+    abort("update");
+    return;
+  }
+
+  uchar *p= buf;
+  int4store(p, (uint32) data_len);
+  p+= 4;
+  int8store(p, (ulonglong) offset);
+  int4store(p + 8, count);
+  p+= 12;
+  for (uint32 i= 0; i < count; i++, p+= GTID_INDEX_GTID_SIZE)
+  {
+    int4store(p, list[i].domain_id);
+    int4store(p + 4, list[i].server_id);
+    int8store(p + 8, list[i].seq_no);
+  }
+  int4store(p, my_checksum(0, buf + 4, data_len));
+
+  if (mysql_file_write(file, buf, data_len + 8, MYF(MY_WME | MY_NABP)))
+    abort("write");
+  else
+    last_offset= offset;
+
+  my_free(list);
+  my_free(buf);
+}
+
+
+/* Mark the index complete, when the binlog file is closed. */
+void Gtid_index_writer::close()
+{
+  if (!is_open())
+    return;
+  uchar flags= 0;
+  if (mysql_file_pwrite(file, &flags, 1, GTID_INDEX_FLAGS_OFFSET,
+                        MYF(MY_WME | MY_NABP)) ||
+      mysql_file_sync(file, MYF(MY_WME)))
+    sql_print_warning("Failed to close GTID index file '%s' (errno: %d)",
+                      name, my_errno);
+  mysql_file_close(file, MYF(0));
+  file= -1;
+}
+
+
+/*
+  Open the index of a binlog file, if it can be used.
+
+  @return false if the index can be read, true if it does not exist or
+          does not describe the binlog file.
+*/
+bool Gtid_index_reader::open(const char *binlog_name)
+{
+  char name[FN_REFLEN];
+  uchar header[GTID_INDEX_HEADER_SIZE];
+
+  DBUG_ASSERT(file < 0);
+  gtid_index_name(name, binlog_name);
+  if ((file= mysql_file_open(key_file_binlog_index, name,
+                             O_RDONLY | O_BINARY, MYF(0))) < 0)
+    return true;
+  if (init_io_cache(&cache, file, IO_SIZE * 2, READ_CACHE, 0, 0, MYF(0)))
+  {
+    mysql_file_close(file, MYF(0));
+    file= -1;
+    return true;
+  }
+
+  /*
+    The index of a binlog file that is still in use is valid as far as it
+    has been written. Otherwise, the server was killed while writing the
+    binlog file, which may have been truncated during crash recovery.
+  */
+  if (my_b_read(&cache, header, sizeof(header)) ||
+      memcmp(header, gtid_index_magic, sizeof(gtid_index_magic)) ||
+      header[sizeof(gtid_index_magic)] != GTID_INDEX_VERSION ||
+      ((header[GTID_INDEX_FLAGS_OFFSET] & GTID_INDEX_FLAG_IN_USE) &&
+       !mysql_bin_log.is_active(binlog_name)))
+  {
+    close();
+    return true;
+  }
+  return false;
+}
+
+
+/*
+  Read the next entry of the index.
+
+  @param[out] offset  the binlog offset
+  @param[out] list    the binlog GTID state at offset, to be freed with
+                      my_free()
+  @param[out] count   number of GTIDs in list
+
+  @return false on success, true at the end of the index or if the entry
+          is corrupt or has not been completely written yet.
+*/
+bool Gtid_index_reader::read_entry(my_off_t *offset, rpl_gtid **list,
+                                   uint32 *count)
+{
+  uchar hdr[16];
+  uchar crc_buf[4];
+
+  if (my_b_read(&cache, hdr, sizeof(hdr)))
+    return true;
+  uint32 data_len= uint4korr(hdr);
+  *offset= uint8korr(hdr + 4);
+  *count= uint4korr(hdr + 12);
+  if (*count >= (1 << 28) ||
+      data_len != 12 + (size_t) *count * GTID_INDEX_GTID_SIZE ||
+      *offset < BIN_LOG_HEADER_SIZE)
+    return true;
+
+  size_t len= (size_t) *count * GTID_INDEX_GTID_SIZE;
+  uchar *buf= (uchar *) my_malloc(PSI_INSTRUMENT_ME, len + 1, MYF(MY_WME));
+  if (!buf)
+    return true;
+  *list= (rpl_gtid *) my_malloc(PSI_INSTRUMENT_ME,
+                                *count * sizeof(**list) + (*count == 0),
+                                MYF(MY_WME));
+  if (!*list || my_b_read(&cache, buf, len) ||
+      my_b_read(&cache, crc_buf, sizeof(crc_buf)) ||
+      uint4korr(crc_buf) != my_checksum(my_checksum(0, hdr + 4, 12), buf, len))
+  {
+    my_free(buf);
+    my_free(*list);
+    *list= NULL;
+    return true;
+  }
+
+  const uchar *p= buf;
+  for (uint32 i= 0; i < *count; i++, p+= GTID_INDEX_GTID_SIZE)
+  {
+    (*list)[i].domain_id= uint4korr(p);
+    (*list)[i].server_id= uint4korr(p + 4);
+    (*list)[i].seq_no= uint8korr(p + 8);
+  }
+  my_free(buf);
+  return false;
+}
+
+
+void Gtid_index_reader::close()
+{
+  if (file < 0)
+    return;
+  end_io_cache(&cache);
+  mysql_file_close(file, MYF(0));
+  file= -1;
+}
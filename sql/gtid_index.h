@@ -0,0 +1,99 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#ifndef GTID_INDEX_H
+#define GTID_INDEX_H
+
+#include "my_sys.h"
+
+/*
+  Sparse GTID index of a binlog file.
+
+  Next to each binlog file FILE, the file FILE.idx records the binlog GTID
+  state at some event group boundaries in FILE. The state has the same
+  format and meaning as the list in a Gtid_list_log_event: the last GTID
+  binlogged for each (domain_id, server_id) before that offset. A new entry
+  is added after a group commit once the binlog has grown by at least
+  binlog_gtid_index_span_min bytes since the previous entry.
+
+  A slave connecting with a GTID position then does not need to read the
+  binlog file from its start up to the requested GTID; the master starts
+  reading at the last indexed offset before which the slave has already
+  received everything.
+
+  File format (all integers little-endian):
+
+    header:  8 bytes magic, 1 byte version, 1 byte flags, 6 bytes reserved
+    entry:   4 bytes length of the data,
+             data: 8 bytes binlog offset, 4 bytes number of GTIDs N,
+                   N times (4 bytes domain_id, 4 bytes server_id,
+                            8 bytes seq_no),
+             4 bytes CRC-32 of the data
+
+  The flag GTID_INDEX_FLAG_IN_USE is cleared when the binlog file is closed.
+  The index of a binlog file that was not closed properly (after a crash)
+  is not used.
+*/
+
+struct rpl_gtid;
+struct rpl_binlog_state;
+
+extern my_bool opt_binlog_gtid_index;
+extern ulong opt_binlog_gtid_index_span_min;
+
+#define GTID_INDEX_SUFFIX ".idx"
+#define GTID_INDEX_HEADER_SIZE 16
+#define GTID_INDEX_FLAG_IN_USE 1
+
+void gtid_index_name(char *out, const char *binlog_name);
+void gtid_index_delete(const char *binlog_name);
+
+
+/* Writes the index of the binlog file that is being written. */
+class Gtid_index_writer
+{
+public:
+  Gtid_index_writer() : file(-1), last_offset(0) {}
+  bool open(const char *binlog_name, my_off_t offset);
+  void process(my_off_t offset, rpl_binlog_state *state);
+  void close();
+  bool is_open() const { return file >= 0; }
+
+private:
+  void abort(const char *what);
+
+  File file;
+  /* The binlog offset of the last entry */
+  my_off_t last_offset;
+  char name[FN_REFLEN];
+};
+
+
+/* Reads the index of a binlog file from the start. */
+class Gtid_index_reader
+{
+public:
+  Gtid_index_reader() : file(-1) {}
+  ~Gtid_index_reader() { close(); }
+  bool open(const char *binlog_name);
+  bool read_entry(my_off_t *offset, rpl_gtid **list, uint32 *count);
+  void close();
+
+private:
+  File file;
+  IO_CACHE cache;
+};
+
+#endif /* GTID_INDEX_H */
@@ -546,6 +546,7 @@ class binlog_cache_mngr {
     if (do_trx)
     {
       trx_cache.reset();
+      writeset.reset();
       using_xa= FALSE;
       last_commit_pos_file[0]= 0;
       last_commit_pos_offset= 0;
@@ -566,6 +567,9 @@ class binlog_cache_mngr {
 
   binlog_cache_data trx_cache;
 
+  /* Keys modified by the transaction in trx_cache */
+  Binlog_writeset writeset;
+
   /*
     Binlog position for current transaction.
     For START TRANSACTION WITH CONSISTENT SNAPSHOT, this is the binlog
@@ -3472,7 +3476,10 @@ void MYSQL_BIN_LOG::cleanup()
     safemalloc is shut down
   */
   if (!is_relay_log)
+  {
     rpl_global_gtid_binlog_state.free();
+    writeset_history.destroy();
+  }
   DBUG_VOID_RETURN;
 }
 
@@ -3892,6 +3899,9 @@ bool MYSQL_BIN_LOG::open(const char *log_name,
       /* update binlog_end_pos so that it can be read by after sync hook */
       reset_binlog_end_pos(log_file_name, offset);
 
+      if (opt_binlog_gtid_index)
+        gtid_index.open(log_file_name, offset);
+
       mysql_mutex_lock(&LOCK_commit_ordered);
       strmake_buf(last_commit_pos_file, log_file_name);
       last_commit_pos_offset= offset;
@@ -4379,6 +4389,8 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
 
   for (;;)
   {
+    if (!is_relay_log)
+      gtid_index_delete(linfo.log_file_name);
     if (unlikely((error= my_delete(linfo.log_file_name, MYF(0)))))
     {
       if (my_errno == ENOENT) 
@@ -4994,6 +5006,8 @@ int MYSQL_BIN_LOG::purge_index_entry(THD *thd, ulonglong *reclaimed_space,
         error= 0;
 
         DBUG_PRINT("info",("purging %s",log_info.log_file_name));
+        if (!is_relay_log)
+          gtid_index_delete(log_info.log_file_name);
         if (!my_delete(log_info.log_file_name, MYF(0)))
         {
           if (reclaimed_space)
@@ -5894,6 +5908,35 @@ void THD::binlog_set_stmt_begin() {
   cache_mngr->trx_cache.set_prev_position(pos);
 }
 
+/**
+  Add the unique keys of a logged row to the writeset of the transaction,
+  for binlog_transaction_dependency_tracking=WRITESET.
+
+  @param table             the table of the row
+  @param is_transactional  whether the row is logged to the transaction cache
+  @param record            table->record[0] or table->record[1]
+  @param read_only         whether only the columns in table->read_set are
+                           valid in record
+
+  A row that is logged while WRITESET is not enabled makes the writeset of
+  the transaction incomplete, so that the transaction will not run in
+  parallel even if WRITESET is enabled before it commits.
+*/
+void THD::binlog_writeset_add_row(TABLE *table, bool is_transactional,
+                                  const uchar *record, bool read_only)
+{
+  if (!is_transactional)
+    return;
+  if (binlog_cache_mngr *cache_mngr= binlog_setup_trx_data())
+  {
+    if (opt_binlog_transaction_dependency_tracking ==
+        BINLOG_DEPENDENCY_TRACKING_WRITESET)
+      cache_mngr->writeset.add_row(this, table, record, read_only);
+    else
+      cache_mngr->writeset.set_unsafe();
+  }
+}
+
 static int
 binlog_start_consistent_snapshot(handlerton *hton, THD *thd)
 {
@@ -6634,6 +6677,10 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       cache_data= cache_mngr->get_binlog_cache_data(is_trans_cache);
       file= &cache_data->cache_log;
 
+      /* A statement cannot be described by a writeset. */
+      if (is_trans_cache && event_info->get_type_code() != TABLE_MAP_EVENT)
+        cache_mngr->writeset.set_unsafe();
+
       if (thd->lex->stmt_accessed_non_trans_temp_table())
         cache_data->set_changes_to_non_trans_temp_table();
 
@@ -7442,6 +7489,70 @@ int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
   DBUG_RETURN(0);                               // All OK
 }
 
+
+/*
+  Write the contents of a transaction cache to the binary log as one
+  compressed Transaction_payload_log_event.
+
+  SYNOPSIS
+    write_transaction_payload()
+    thd      Current_thread
+    cache    Cache to write to the binary log
+
+  DESCRIPTION
+    The events are compressed as they are in the cache: without checksum
+    and with end_log_pos relative to the start of the cache. The reader
+    gives them the end_log_pos of the payload event when expanding it (see
+    transaction_payload_uncompress()), so they need no fixing here.
+
+    Only a cache that is entirely in memory is compressed, which bounds the
+    memory needed on both sides by binlog_cache_size.
+
+  RETURN
+    0                  The payload event was written
+    -1                 The cache was not compressed; use write_cache()
+    ER_ERROR_ON_WRITE  Error
+*/
+
+int MYSQL_BIN_LOG::write_transaction_payload(THD *thd, IO_CACHE *cache)
+{
+  DBUG_ENTER("MYSQL_BIN_LOG::write_transaction_payload");
+
+  mysql_mutex_assert_owner(&LOCK_log);
+  /* Leave a cache that spilled to its temporary file to write_cache() */
+  if (cache->pos_in_file != 0)
+    DBUG_RETURN(-1);
+  if (reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
+    DBUG_RETURN(ER_ERROR_ON_WRITE);
+  size_t length= my_b_bytes_in_cache(cache);
+  DBUG_ASSERT(length == cache->end_of_file);
+  if (length > UINT_MAX32)
+    DBUG_RETURN(-1);
+
+  uint32 comlen= binlog_get_compress_len((uint32) length);
+  uchar *buf= (uchar *) my_malloc(PSI_INSTRUMENT_ME, comlen, MYF(MY_WME));
+  if (!buf)
+    DBUG_RETURN(ER_ERROR_ON_WRITE);
+
+  int res= -1;
+  /* Not worth a payload event if it does not save anything */
+  if (!binlog_buf_compress((const char *) cache->read_pos, (char *) buf,
+                           (uint32) length, &comlen) &&
+      comlen + LOG_EVENT_HEADER_LEN < length)
+  {
+    Transaction_payload_log_event ev(thd, buf, comlen, (uint32) length);
+    if (write_event(&ev))
+      res= ER_ERROR_ON_WRITE;
+    else
+    {
+      status_var_add(thd->status_var.binlog_bytes_written, ev.data_written);
+      res= 0;
+    }
+  }
+  my_free(buf);
+  DBUG_RETURN(res);
+}
+
 /*
   Helper function to get the error code of the query to be binlogged.
  */
@@ -8251,10 +8362,16 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
       current->error and let the thread do the error reporting itself once
       we wake it up.
     */
+    const bool use_writeset= opt_binlog_transaction_dependency_tracking ==
+      BINLOG_DEPENDENCY_TRACKING_WRITESET;
+    if (use_writeset)
+      writeset_history.new_group();
+
     for (current= queue; current != NULL; current= current->next)
     {
       set_current_thd(current->thd);
       binlog_cache_mngr *cache_mngr= current->cache_mngr;
+      uint64 trx_commit_id= commit_id;
 
       /*
         We already checked before that at least one cache is non-empty; if both
@@ -8264,8 +8381,22 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
                   !cache_mngr->trx_cache.empty()  ||
                   current->thd->transaction->xid_state.is_explicit_XA());
 
+      if (use_writeset)
+      {
+        /*
+          Only a transaction that consists of row events for transactional
+          tables may run in parallel with transactions of other group commits.
+        */
+        const bool safe= current->using_trx_cache &&
+          (!current->using_stmt_cache || cache_mngr->stmt_cache.empty()) &&
+          !current->thd->transaction->xid_state.is_explicit_XA() &&
+          cache_mngr->writeset.is_safe();
+        trx_commit_id=
+          writeset_history.get_commit_id(safe ? &cache_mngr->writeset : NULL);
+      }
+
       if (unlikely((current->error= write_transaction_or_stmt(current,
-                                                              commit_id))))
+                                                              trx_commit_id))))
         current->commit_errno= errno;
 
       strmake_buf(cache_mngr->last_commit_pos_file, log_file_name);
@@ -8341,6 +8472,7 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
         it's list before dump-thread tries to send it
       */
       update_binlog_end_pos(commit_offset);
+      gtid_index.process(commit_offset, &rpl_global_gtid_binlog_state);
 
       if (unlikely(any_error))
         sql_print_error("Failed to run 'after_flush' hooks");
@@ -8536,7 +8668,13 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                       DBUG_SUICIDE();
                     });
 
-    if (write_cache(entry->thd, mngr->get_binlog_cache_log(TRUE)))
+    IO_CACHE *cache= mngr->get_binlog_cache_log(TRUE);
+    int res= -1;
+    if (opt_bin_log_compress_transactions)
+      res= write_transaction_payload(entry->thd, cache);
+    if (res < 0)
+      res= write_cache(entry->thd, cache);
+    if (res)
     {
       entry->error_cache= &mngr->trx_cache.cache_log;
       DBUG_RETURN(ER_ERROR_ON_WRITE);
@@ -8853,6 +8991,7 @@ void MYSQL_BIN_LOG::close(uint exiting)
 
     /* this will cleanup IO_CACHE, sync and close the file */
     MYSQL_LOG::close(exiting);
+    gtid_index.close();
   }
 
   /*
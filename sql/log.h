@@ -20,6 +20,8 @@
 #include "handler.h"                            /* my_xid */
 #include "wsrep_mysqld.h"
 #include "rpl_constants.h"
+#include "rpl_writeset.h"
+#include "gtid_index.h"
 
 class Relay_log_info;
 
@@ -526,6 +528,13 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   int readers_count;
   /* Queue of transactions queued up to participate in group commit. */
   group_commit_entry *group_commit_queue;
+  /*
+    Writesets since the last change of commit_id, for
+    binlog_transaction_dependency_tracking=WRITESET. Protected by LOCK_log.
+  */
+  Binlog_writeset_history writeset_history;
+  /* GTID index of the binlog file that is being written */
+  Gtid_index_writer gtid_index;
   /*
     Condition variable to mark that the group commit queue is busy.
     Used when each thread does it's own commit_ordered() (when
@@ -816,6 +825,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   bool write_incident(THD *thd);
   void write_binlog_checkpoint_event_already_locked(const char *name, uint len);
   int  write_cache(THD *thd, IO_CACHE *cache);
+  int  write_transaction_payload(THD *thd, IO_CACHE *cache);
   void set_write_error(THD *thd, bool is_transactional);
   bool check_write_error(THD *thd);
 
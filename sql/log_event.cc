@@ -567,6 +567,93 @@ row_log_event_uncompress(const Format_description_log_event *description_event,
   return 0;
 }
 
+/**
+   Expand a Transaction_payload_log_event in 'src' into the events it
+   carries, stored one after another in 'dst', of total size 'newlen'.
+
+   Each event gets the end_log_pos of the payload event, and a checksum
+   if 'contain_checksum' is set, so it can be handled like any event read
+   from the binlog.
+
+   @Note: The caller should call my_free to release 'dst'.
+
+   return zero if successful, non-zero otherwise.
+*/
+
+int
+transaction_payload_uncompress(const Format_description_log_event *description_event,
+                               bool contain_checksum, const char *src,
+                               ulong src_len, char **dst, ulong *newlen)
+{
+  ulong len= uint4korr(src + EVENT_LEN_OFFSET);
+  const char *tmp= src + description_event->common_header_len;
+  uint32 log_pos= uint4korr(src + LOG_POS_OFFSET);
+  char *events, *new_dst, *to;
+  const char *ev, *end;
+  ulong count= 0;
+
+  // bad event
+  if (src_len < len || len <= description_event->common_header_len)
+    return 1;
+
+  DBUG_ASSERT((uchar)src[EVENT_TYPE_OFFSET] == TRANSACTION_PAYLOAD_EVENT);
+
+  int32 comp_len= (int32)(len - (tmp - src) -
+                          (contain_checksum ? BINLOG_CHECKSUM_LEN : 0));
+  uint32 un_len= binlog_get_uncompress_len(tmp);
+
+  // bad event
+  if (comp_len <= 0 || un_len == 0)
+    return 1;
+
+  events= (char *)my_malloc(PSI_INSTRUMENT_ME, un_len, MYF(MY_WME));
+  if (!events)
+    return 1;
+
+  if (binlog_buf_uncompress(tmp, events, comp_len, &un_len))
+    goto err;
+
+  /* Check the framing of the events, and count them for the checksums. */
+  end= events + un_len;
+  for (ev= events; ev < end; ev+= uint4korr(ev + EVENT_LEN_OFFSET))
+  {
+    // bad event
+    if (end - ev < LOG_EVENT_HEADER_LEN ||
+        uint4korr(ev + EVENT_LEN_OFFSET) < LOG_EVENT_HEADER_LEN ||
+        uint4korr(ev + EVENT_LEN_OFFSET) > (ulong)(end - ev))
+      goto err;
+    count++;
+  }
+
+  *newlen= un_len + (contain_checksum ? count * BINLOG_CHECKSUM_LEN : 0);
+  new_dst= (char *)my_malloc(PSI_INSTRUMENT_ME, *newlen, MYF(MY_WME));
+  if (!new_dst)
+    goto err;
+
+  for (ev= events, to= new_dst; ev < end; )
+  {
+    ulong ev_len= uint4korr(ev + EVENT_LEN_OFFSET);
+    memcpy(to, ev, ev_len);
+    int4store(to + LOG_POS_OFFSET, log_pos);
+    if (contain_checksum)
+    {
+      int4store(to + EVENT_LEN_OFFSET, ev_len + BINLOG_CHECKSUM_LEN);
+      int4store(to + ev_len, my_checksum(0L, (uchar *)to, ev_len));
+      to+= BINLOG_CHECKSUM_LEN;
+    }
+    to+= ev_len;
+    ev+= ev_len;
+  }
+
+  my_free(events);
+  *dst= new_dst;
+  return 0;
+
+err:
+  my_free(events);
+  return 1;
+}
+
 /**
   Get the length of uncompress content.
   return 0 means error.
@@ -713,6 +800,7 @@ const char* Log_event::get_type_str(Log_event_type type)
   case WRITE_ROWS_COMPRESSED_EVENT_V1: return "Write_rows_compressed_v1";
   case UPDATE_ROWS_COMPRESSED_EVENT_V1: return "Update_rows_compressed_v1";
   case DELETE_ROWS_COMPRESSED_EVENT_V1: return "Delete_rows_compressed_v1";
+  case TRANSACTION_PAYLOAD_EVENT: return "Transaction_payload";
 
   default: return "Unknown";				/* impossible */
   }
@@ -1082,11 +1170,13 @@ Log_event* Log_event::read_log_event(const char* buf, uint event_len,
   }
 
   if (event_type > fdle->number_of_event_types &&
-      event_type != FORMAT_DESCRIPTION_EVENT)
+      event_type != FORMAT_DESCRIPTION_EVENT &&
+      event_type != TRANSACTION_PAYLOAD_EVENT)
   {
     /*
       It is unsafe to use the fdle if its post_header_len
-      array does not include the event type.
+      array does not include the event type. The transaction payload
+      event has no post-header, so it does not need the array.
     */
     DBUG_PRINT("error", ("event type %d found, but the current "
                          "Format_description_log_event supports only %d event "
@@ -1260,6 +1350,9 @@ Log_event* Log_event::read_log_event(const char* buf, uint event_len,
     case START_ENCRYPTION_EVENT:
       ev = new Start_encryption_log_event(buf, event_len, fdle);
       break;
+    case TRANSACTION_PAYLOAD_EVENT:
+      ev = new Transaction_payload_log_event(buf, event_len, fdle);
+      break;
     default:
       DBUG_PRINT("error",("Unknown event code: %d",
                           (uchar) buf[EVENT_TYPE_OFFSET]));
@@ -2396,6 +2489,28 @@ Start_encryption_log_event::Start_encryption_log_event(
 }
 
 
+
+/**************************************************************************
+        Transaction_payload_log_event methods
+**************************************************************************/
+
+Transaction_payload_log_event::Transaction_payload_log_event(
+       const char *buf, uint event_len,
+       const Format_description_log_event *description_event)
+  :Log_event(buf, description_event), payload(0), payload_len(0),
+   uncompressed_len(0)
+{
+  uint8 header_size= description_event->common_header_len;
+  if (event_len <= header_size)
+    return;
+  uncompressed_len= binlog_get_uncompress_len(buf + header_size);
+  if (uncompressed_len == 0)
+    return;
+  payload= (const uchar *) buf + header_size;
+  payload_len= event_len - header_size;
+}
+
+
   /**************************************************************************
         Load_log_event methods
    General note about Load_log_event: the binlogging of LOAD DATA INFILE is
@@ -3179,7 +3294,7 @@ Rows_log_event::Rows_log_event(const char *buf, uint event_len,
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
     , m_curr_row(NULL), m_curr_row_end(NULL),
     m_key(NULL), m_key_info(NULL), m_key_nr(0),
-    master_had_triggers(0)
+    master_had_triggers(0), m_hash_scan(NULL)
 #endif
 {
   DBUG_ENTER("Rows_log_event::Rows_log_event(const char*,...)");
@@ -571,9 +571,11 @@ class String;
 #define MARIA_SLAVE_CAPABILITY_BINLOG_CHECKPOINT 3
 /* MariaDB >= 10.0.1, which knows about global transaction id events. */
 #define MARIA_SLAVE_CAPABILITY_GTID 4
+/* Understands TRANSACTION_PAYLOAD_EVENT (log_bin_compress_transactions). */
+#define MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD 5
 
 /* Our capability. */
-#define MARIA_SLAVE_CAPABILITY_MINE MARIA_SLAVE_CAPABILITY_GTID
+#define MARIA_SLAVE_CAPABILITY_MINE MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD
 
 
 /*
@@ -726,6 +728,13 @@ enum Log_event_type
   UPDATE_ROWS_COMPRESSED_EVENT = 170,
   DELETE_ROWS_COMPRESSED_EVENT = 171,
 
+  /*
+    The events of a transaction, compressed together. It has no post-header,
+    and is not counted in LOG_EVENT_TYPES, so that adding it did not change
+    the size of the Format_description event (and every binlog offset).
+  */
+  TRANSACTION_PAYLOAD_EVENT = 172,
+
   /* Add new MariaDB events here - right above this comment!  */
 
   ENUM_END_EVENT /* end marker */
@@ -798,8 +807,10 @@ static inline bool LOG_EVENT_IS_ROW_V2(enum Log_event_type type)
    The number of types we handle in Format_description_log_event (UNKNOWN_EVENT
    is not to be handled, it does not exist in binlogs, it does not have a
    format).
+   TRANSACTION_PAYLOAD_EVENT has no post-header and is not described there
+   either.
 */
-#define LOG_EVENT_TYPES (ENUM_END_EVENT-1)
+#define LOG_EVENT_TYPES (TRANSACTION_PAYLOAD_EVENT-1)
 
 enum Int_event_type
 {
@@ -1550,6 +1561,7 @@ class Log_event
     case USER_VAR_EVENT:
     case TABLE_MAP_EVENT:
     case ANNOTATE_ROWS_EVENT:
+    case TRANSACTION_PAYLOAD_EVENT:
       return true;
     case DELETE_ROWS_EVENT:
     case UPDATE_ROWS_EVENT:
@@ -2755,6 +2767,72 @@ class Start_encryption_log_event : public Log_event
 };
 
 
+/**
+  @class Transaction_payload_log_event
+
+  The events of one transaction, compressed together when
+  log_bin_compress_transactions is set. Compressing the whole transaction
+  works much better than compressing each event on its own
+  (log_bin_compress), as row events of a transaction are small and alike.
+
+  The GTID event starting the event group and the XID or COMMIT event
+  ending it are logged around the payload event, uncompressed, so the
+  group boundaries can be found without uncompressing.
+
+  @section Transaction_payload_log_event_binary_format Binary Format
+
+  The event has no post-header. The body is a record made by
+  binlog_buf_compress() of the events of the transaction, as they were in
+  the binlog cache: without checksum, and with end_log_pos relative to the
+  start of the payload.
+
+  The slave IO thread replaces the event with the events it carries before
+  writing to the relay log, so the SQL thread never sees it.
+  transaction_payload_uncompress() does the expansion, giving each event
+  the end_log_pos of the payload event and a checksum if needed. For a
+  slave that does not announce MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD,
+  the dump thread does the expansion instead.
+
+  The compression is that of the other compressed binlog events (zlib),
+  so that mysqlbinlog and the replication code need no other library;
+  zstd is only linked into InnoDB.
+*/
+
+class Transaction_payload_log_event: public Log_event
+{
+public:
+  const uchar *payload;
+  uint payload_len;
+  uint32 uncompressed_len;
+
+#ifdef MYSQL_SERVER
+  Transaction_payload_log_event(THD *thd_arg, const uchar *payload_arg,
+                                uint payload_len_arg,
+                                uint32 uncompressed_len_arg)
+    :Log_event(thd_arg, 0, true), payload(payload_arg),
+     payload_len(payload_len_arg), uncompressed_len(uncompressed_len_arg)
+  {
+    cache_type= Log_event::EVENT_NO_CACHE;
+  }
+#ifdef HAVE_REPLICATION
+  void pack_info(Protocol *protocol);
+#endif
+  bool write_data_body() { return write_data(payload, payload_len); }
+#else
+  bool print(FILE *file, PRINT_EVENT_INFO *print_event_info);
+#endif
+  Transaction_payload_log_event(const char *buf, uint event_len,
+                   const Format_description_log_event *description_event);
+  Log_event_type get_type_code() { return TRANSACTION_PAYLOAD_EVENT; }
+  int get_data_size() { return payload_len; }
+  bool is_valid() const { return payload != 0; }
+
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+  virtual int do_apply_event(rpl_group_info *rgi);
+#endif
+};
+
+
 class Version
 {
 protected:
@@ -4908,6 +4986,10 @@ class Table_map_log_event : public Log_event
 };
 
 
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+class Rows_hash_scan;
+#endif
+
 /**
   @class Rows_log_event
 
@@ -5173,8 +5255,13 @@ class Rows_log_event : public Log_event
   KEY      *m_key_info; /* Pointer to KEY info for m_key_nr */
   uint      m_key_nr;   /* Key number */
   bool master_had_triggers;     /* set after tables opening */
+  /* Rows located by hash_scan_rows(), or NULL */
+  Rows_hash_scan *m_hash_scan;
 
   int find_key(); // Find a best key to use in find_row()
+  bool use_hash_scan();
+  void hash_scan_rows(rpl_group_info *);
+  int prefetch_rows(rpl_group_info *);
   int find_row(rpl_group_info *);
   int write_row(rpl_group_info *, const bool);
   int update_sequence();
@@ -5787,4 +5874,8 @@ int row_log_event_uncompress(const Format_description_log_event *description_eve
                              const char *src, ulong src_len, char* buf, ulong buf_size, bool* is_malloc,
                              char **dst, ulong *newlen);
 
+int transaction_payload_uncompress(const Format_description_log_event *description_event,
+                                   bool contain_checksum, const char *src, ulong src_len,
+                                   char **dst, ulong *newlen);
+
 #endif /* _log_event_h */
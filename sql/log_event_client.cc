@@ -2127,6 +2127,27 @@ bool Start_encryption_log_event::print(FILE* file,
 }
 
 
+/*
+  Only the header is printed here; mysqlbinlog expands the payload and
+  prints the events it carries after it.
+*/
+bool Transaction_payload_log_event::print(FILE *file,
+                                          PRINT_EVENT_INFO *print_event_info)
+{
+  if (print_event_info->short_form)
+    return 0;
+
+  Write_on_release_cache cache(&print_event_info->head_cache, file,
+                               Write_on_release_cache::FLUSH_F);
+
+  if (print_header(&cache, print_event_info, FALSE) ||
+      my_b_printf(&cache, "\tTransaction_payload\tcompressed_size=%u"
+                  "\tuncompressed_size=%u\n", payload_len, uncompressed_len))
+    return 1;
+  return cache.flush_data();
+}
+
+
 bool Load_log_event::print(FILE* file, PRINT_EVENT_INFO* print_event_info)
 {
   return print(file, print_event_info, 0);
@@ -2480,6 +2480,36 @@ int Start_encryption_log_event::do_update_pos(rpl_group_info *rgi)
 #endif
 
 
+/**************************************************************************
+      Transaction_payload_log_event methods
+**************************************************************************/
+
+#if defined(HAVE_REPLICATION)
+void Transaction_payload_log_event::pack_info(Protocol *protocol)
+{
+  char buf[64];
+  size_t length= my_snprintf(buf, sizeof(buf),
+                             "compressed_size=%u, uncompressed_size=%u",
+                             payload_len, uncompressed_len);
+  protocol->store(buf, length, &my_charset_bin);
+}
+
+
+int Transaction_payload_log_event::do_apply_event(rpl_group_info *rgi)
+{
+  /*
+    The slave IO thread expands the event into the events it carries, see
+    queue_event(). Seeing it here means the relay log was not written by
+    this server version; skipping it would silently lose the transaction.
+  */
+  rgi->rli->report(ERROR_LEVEL, ER_BINLOG_UNCOMPRESS_ERROR, rgi->gtid_info(),
+                   "Transaction payload event found in the relay log; it "
+                   "should have been uncompressed by the IO thread");
+  return 1;
+}
+#endif
+
+
 /**************************************************************************
       Load_log_event methods
 **************************************************************************/
@@ -5152,7 +5182,7 @@ Rows_log_event::Rows_log_event(THD *thd_arg, TABLE *tbl_arg, ulong tid,
 #ifdef HAVE_REPLICATION
     , m_curr_row(NULL), m_curr_row_end(NULL),
     m_key(NULL), m_key_info(NULL), m_key_nr(0),
-    master_had_triggers(0)
+    master_had_triggers(0), m_hash_scan(NULL)
 #endif
 {
   /*
@@ -5301,6 +5331,62 @@ inline void restore_empty_query_table_list(LEX *lex)
 }
 
 
+/*
+  The table rows located for the before images of a rows event with
+  slave_rows_search_algorithms=HASH_SCAN, see
+  Rows_log_event::hash_scan_rows().
+*/
+class Rows_hash_scan
+{
+public:
+  struct Row
+  {
+    ulonglong hash;
+    /* Start of the before image in the event */
+    const uchar *bi;
+    /* The before image, unpacked */
+    uchar *record;
+    /* Position of the matching table row, or NULL if none was found */
+    uchar *ref;
+  };
+
+  Rows_hash_scan() : rows(PSI_INSTRUMENT_MEM, 64, 64), next(0)
+  {
+    init_alloc_root(PSI_INSTRUMENT_ME, &mem_root, 8192, 0, MYF(0));
+    my_hash_init(PSI_INSTRUMENT_ME, &hash, &my_charset_bin, 64,
+                 offsetof(Row, hash), sizeof(ulonglong), NULL, NULL, 0);
+  }
+  ~Rows_hash_scan()
+  {
+    my_hash_free(&hash);
+    free_root(&mem_root, MYF(0));
+  }
+
+  static ulonglong hash_record(TABLE *table, const MY_BITMAP *cols,
+                               uint width);
+
+  /*
+    Return the position of the table row for the before image at bi, or
+    NULL if none was found. Must be called in event order.
+  */
+  const uchar *find(const uchar *bi)
+  {
+    while (next < rows.elements() && rows.at(next)->bi < bi)
+      next++;
+    if (next < rows.elements() && rows.at(next)->bi == bi)
+      return rows.at(next)->ref;
+    return NULL;
+  }
+
+  MEM_ROOT mem_root;
+  /* The rows that have not been matched yet, by hash */
+  HASH hash;
+  /* All rows, in event order */
+  Dynamic_array<Row*> rows;
+  size_t next;
+};
+
+
 int Rows_log_event::do_apply_event(rpl_group_info *rgi)
 {
   Relay_log_info const *rli= rgi->rli;
@@ -5647,6 +5733,14 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
     // Do event specific preparations 
     error= do_before_row_operations(rli);
 
+    if (likely(!error))
+    {
+      if (use_hash_scan())
+        hash_scan_rows(rgi);
+      else if (opt_slave_rows_prefetch)
+        error= prefetch_rows(rgi);
+    }
+
     /*
       Bug#56662 Assertion failed: next_insert_id == 0, file handler.cc
       Don't allow generation of auto_increment value when processing
@@ -5675,7 +5769,9 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
       if (!table->in_use)
         table->in_use= thd;
 
-      error= do_exec_row(rgi);
+      /* An error from the preparations is handled like one for the row */
+      if (likely(!error))
+        error= do_exec_row(rgi);
 
       if (unlikely(error))
         DBUG_PRINT("info", ("error: %s", HA_ERR(error)));
@@ -5748,6 +5844,9 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
                         const_cast<Relay_log_info*>(rli)->abort_slave= 1;);
     }
 
+    delete m_hash_scan;
+    m_hash_scan= NULL;
+
     if (unlikely(error= do_after_row_operations(rli, error)) &&
         ignored_error_code(convert_handler_error(error, thd, table)))
     {
@@ -7621,6 +7720,12 @@ int Rows_log_event::find_key()
   DBUG_ENTER("Rows_log_event::find_key");
   DBUG_ASSERT(m_table);
 
+  if (!(slave_rows_search_algorithms_options & (1ULL << SLAVE_ROWS_INDEX_SCAN)))
+  {
+    m_key_info= NULL;
+    DBUG_RETURN(0);
+  }
+
   best_key_nr= MAX_KEY;
 
   /*
@@ -7679,6 +7784,319 @@ int Rows_log_event::find_key()
 }
 
 
+/*
+  Check whether the rows of this event should be located with a single
+  table scan by hash_scan_rows(), instead of a table scan for each row
+  in find_row(). Call after do_before_row_operations().
+*/
+bool Rows_log_event::use_hash_scan()
+{
+  Log_event_type type= get_general_type_code();
+  return (slave_rows_search_algorithms_options &
+          (1ULL << SLAVE_ROWS_HASH_SCAN)) &&
+         (type == UPDATE_ROWS_EVENT || type == DELETE_ROWS_EVENT) &&
+         !m_key_info && !m_table->versioned() &&
+         !((m_table->file->ha_table_flags() &
+            HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) &&
+           m_table->s->primary_key < MAX_KEY);
+}
+
+
+/*
+  Hash the columns of table->record[0] that are in the before image.
+  Rows that record_compare() considers equal have the same hash.
+*/
+ulonglong Rows_hash_scan::hash_record(TABLE *table, const MY_BITMAP *cols,
+                                      uint width)
+{
+  ulong nr1= 1, nr2= 4;
+  uint fields= MY_MIN(width, table->s->fields);
+  for (uint i= 0; i < fields; i++)
+    if (bitmap_is_set(cols, i))
+      table->field[i]->hash(&nr1, &nr2);
+  return (ulonglong) nr1 ^ ((ulonglong) nr2 << 32);
+}
+
+
+/*
+  Locate the table rows for all before images of the event in a single
+  table scan, for find_row() to fetch them by position.
+
+  The before images are unpacked into a hash table. Each table row is
+  compared to the before images with the same hash, and a matching one
+  remembers the position of the row and is removed from the hash table,
+  so that identical before images are matched to different rows.
+
+  On any error, m_hash_scan is left NULL and find_row() searches each row
+  as usual, reporting the error if it persists.
+*/
+void Rows_log_event::hash_scan_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  const uchar *saved_curr_row= m_curr_row;
+  const uchar *saved_curr_row_end= m_curr_row_end;
+  MY_BITMAP *saved_read_set= table->read_set;
+  MY_BITMAP *saved_write_set= table->write_set;
+  const size_t reclength= table->s->reclength;
+  int error= 0;
+  DBUG_ENTER("Rows_log_event::hash_scan_rows");
+
+  if (!(m_hash_scan= new Rows_hash_scan))
+    DBUG_VOID_RETURN;
+  table->use_all_columns();
+
+  while (m_curr_row != m_rows_end)
+  {
+    Rows_hash_scan::Row *row;
+    prepare_record(table, m_width, FALSE);
+    if ((error= unpack_current_row(rgi)))
+      break;
+    if (!(row= (Rows_hash_scan::Row*)
+          alloc_root(&m_hash_scan->mem_root, sizeof(*row) + reclength)))
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      break;
+    }
+    row->bi= m_curr_row;
+    row->record= (uchar*) (row + 1);
+    row->ref= NULL;
+    row->hash= Rows_hash_scan::hash_record(table, &m_cols, m_width);
+    memcpy(row->record, table->record[0], reclength);
+    if (my_hash_insert(&m_hash_scan->hash, (uchar*) row) ||
+        m_hash_scan->rows.append(row))
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      break;
+    }
+
+    /* Skip the after image */
+    if (get_general_type_code() == UPDATE_ROWS_EVENT)
+    {
+      m_curr_row= m_curr_row_end;
+      if ((error= unpack_current_row(rgi, &m_cols_ai)))
+        break;
+    }
+    m_curr_row= m_curr_row_end;
+  }
+
+  m_curr_row= saved_curr_row;
+  m_curr_row_end= saved_curr_row_end;
+
+  if (!error && !(error= table->file->ha_rnd_init(1)))
+  {
+    while (m_hash_scan->hash.records &&
+           !(error= table->file->ha_rnd_next(table->record[0])))
+    {
+      ulonglong hash= Rows_hash_scan::hash_record(table, &m_cols, m_width);
+      HASH_SEARCH_STATE state;
+      for (Rows_hash_scan::Row *row= (Rows_hash_scan::Row*)
+             my_hash_first(&m_hash_scan->hash, (uchar*) &hash, sizeof(hash),
+                           &state);
+           row;
+           row= (Rows_hash_scan::Row*)
+             my_hash_next(&m_hash_scan->hash, (uchar*) &hash, sizeof(hash),
+                          &state))
+      {
+        memcpy(table->record[1], row->record, reclength);
+        if (record_compare(table))
+          continue;
+        table->file->position(table->record[0]);
+        if (!(row->ref= (uchar*) memdup_root(&m_hash_scan->mem_root,
+                                             table->file->ref,
+                                             table->file->ref_length)))
+          error= HA_ERR_OUT_OF_MEM;
+        my_hash_delete(&m_hash_scan->hash, (uchar*) row);
+        break;
+      }
+      if (error)
+        break;
+    }
+    if (error == HA_ERR_END_OF_FILE)
+      error= 0;
+    table->file->ha_rnd_end();
+  }
+
+  table->column_bitmaps_set(saved_read_set, saved_write_set);
+
+  if (error)
+  {
+    DBUG_PRINT("info", ("hash scan failed: %d", error));
+    delete m_hash_scan;
+    m_hash_scan= NULL;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/* The keys of the before images of a rows event, see prefetch_rows() */
+struct Rows_prefetch_keys
+{
+  KEY *key_info;
+  uint key_length;
+  Dynamic_array<uchar*> keys;
+  size_t next;
+
+  Rows_prefetch_keys(KEY *key)
+    : key_info(key), key_length(key->key_length),
+      keys(PSI_INSTRUMENT_MEM, 64, 64), next(0)
+  {}
+};
+
+
+static int rows_prefetch_key_cmp(void *arg, uchar* const *a, uchar* const *b)
+{
+  Rows_prefetch_keys *keys= (Rows_prefetch_keys*) arg;
+  return key_tuple_cmp(keys->key_info->key_part, *a, *b, keys->key_length);
+}
+
+
+static range_seq_t rows_prefetch_seq_init(void *init_param, uint n_ranges,
+                                          uint flags)
+{
+  ((Rows_prefetch_keys*) init_param)->next= 0;
+  return (range_seq_t) init_param;
+}
+
+
+static bool rows_prefetch_seq_next(range_seq_t seq, KEY_MULTI_RANGE *range)
+{
+  Rows_prefetch_keys *keys= (Rows_prefetch_keys*) seq;
+  if (keys->next == keys->keys.elements())
+    return TRUE;
+  key_range *start_key= &range->start_key;
+  start_key->key= keys->keys.at(keys->next++);
+  start_key->length= keys->key_length;
+  start_key->keypart_map=
+    (key_part_map(1) << keys->key_info->user_defined_key_parts) - 1;
+  start_key->flag= HA_READ_KEY_EXACT;
+  range->end_key= *start_key;
+  range->end_key.flag= HA_READ_AFTER_KEY;
+  range->ptr= (char*) start_key->key;
+  range->range_flag= EQ_RANGE;
+  return FALSE;
+}
+
+
+/*
+  Read the rows of an UPDATE or DELETE event that find_row() will look up
+  through an index, with one multi-range read in key order
+  (slave_rows_prefetch). The rows that are read are discarded; the purpose
+  is that find_row() then finds them in the buffer pool instead of waiting
+  for a random read for each row.
+
+  @return 0, or a handler error (such as a deadlock) that must fail the
+          event. Other errors are ignored; find_row() will report them if
+          they persist.
+*/
+int Rows_log_event::prefetch_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  Log_event_type type= get_general_type_code();
+  uint key_nr;
+  DBUG_ENTER("Rows_log_event::prefetch_rows");
+
+  if ((type != UPDATE_ROWS_EVENT && type != DELETE_ROWS_EVENT) ||
+      table->versioned())
+    DBUG_RETURN(0);
+  if ((table->file->ha_table_flags() & HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) &&
+      table->s->primary_key < MAX_KEY)
+    key_nr= table->s->primary_key;
+  else if (m_key_info)
+    key_nr= m_key_nr;
+  else
+    DBUG_RETURN(0);
+
+  const uchar *saved_curr_row= m_curr_row;
+  const uchar *saved_curr_row_end= m_curr_row_end;
+  MY_BITMAP *saved_read_set= table->read_set;
+  MY_BITMAP *saved_write_set= table->write_set;
+  Rows_prefetch_keys keys(table->key_info + key_nr);
+  MEM_ROOT mem_root;
+  uchar *mrr_buf= NULL;
+  int error= 0;
+
+  init_alloc_root(PSI_INSTRUMENT_ME, &mem_root, 8192, 0, MYF(0));
+  table->use_all_columns();
+
+  while (m_curr_row != m_rows_end)
+  {
+    uchar *key;
+    prepare_record(table, m_width, FALSE);
+    if ((error= unpack_current_row(rgi)))
+      break;
+    if (!(key= (uchar*) alloc_root(&mem_root, keys.key_length)) ||
+        keys.keys.append(key))
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      break;
+    }
+    key_copy(key, table->record[0], keys.key_info, 0);
+    /* Skip the after image */
+    if (type == UPDATE_ROWS_EVENT)
+    {
+      m_curr_row= m_curr_row_end;
+      if ((error= unpack_current_row(rgi, &m_cols_ai)))
+        break;
+    }
+    m_curr_row= m_curr_row_end;
+  }
+
+  m_curr_row= saved_curr_row;
+  m_curr_row_end= saved_curr_row_end;
+
+  /* A single row is read by find_row() as efficiently */
+  if (!error && keys.keys.elements() > 1)
+  {
+    uint n_ranges= (uint) keys.keys.elements();
+    uint mrr_mode= HA_MRR_SINGLE_POINT | HA_MRR_NO_ASSOCIATION;
+    uint buf_size= (uint) thd->variables.mrr_buff_size;
+    Cost_estimate cost;
+    HANDLER_BUFFER buf;
+    RANGE_SEQ_IF seq_funcs= {NULL, rows_prefetch_seq_init,
+                             rows_prefetch_seq_next, 0, 0};
+    range_id_t range_id;
+
+    keys.keys.sort(rows_prefetch_key_cmp, &keys);
+
+    if (table->file->multi_range_read_info(key_nr, n_ranges, n_ranges,
+                                           keys.key_info->user_defined_key_parts,
+                                           &buf_size, &mrr_mode, &cost) ||
+        (buf_size &&
+         !(mrr_buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME, buf_size, MYF(0)))))
+    {
+      buf_size= 0;
+      mrr_mode= HA_MRR_SINGLE_POINT | HA_MRR_NO_ASSOCIATION |
+                HA_MRR_USE_DEFAULT_IMPL;
+    }
+    buf.buffer= buf.end_of_used_area= mrr_buf;
+    buf.buffer_end= mrr_buf + buf_size;
+
+    if (!(error= table->file->ha_index_init(key_nr, 1)))
+    {
+      if (!(error= table->file->multi_range_read_init(&seq_funcs, &keys,
+                                                      n_ranges, mrr_mode,
+                                                      &buf)))
+        while (!(error= table->file->multi_range_read_next(&range_id)))
+        {}
+      table->file->ha_index_or_rnd_end();
+    }
+    DBUG_PRINT("info", ("prefetched %u rows: %d", n_ranges, error));
+    /* The transaction may have been rolled back */
+    if (error == HA_ERR_LOCK_DEADLOCK || error == HA_ERR_LOCK_WAIT_TIMEOUT)
+      table->file->print_error(error, MYF(0));
+    else
+      error= 0;
+  }
+  else
+    error= 0;
+
+  table->column_bitmaps_set(saved_read_set, saved_write_set);
+  my_free(mrr_buf);
+  free_root(&mem_root, MYF(0));
+  DBUG_RETURN(error);
+}
+
+
 /* 
   Check if we are already spending too much time on this statement.
   if we are, warn user that it might be because table does not have
@@ -7859,6 +8277,23 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
    */ 
   store_record(table,record[1]);    
 
+  if (m_hash_scan)
+  {
+    /*
+      The row was located by hash_scan_rows(). Check that it was not
+      changed by an earlier row of the event; else search it again.
+    */
+    const uchar *ref= m_hash_scan->find(m_curr_row);
+    if (ref && !table->file->ha_rnd_init(0))
+    {
+      DBUG_PRINT("info",("locating record using hash scan (rnd_pos)"));
+      if (!table->file->ha_rnd_pos(table->record[0], (uchar*) ref) &&
+          !record_compare(table))
+        DBUG_RETURN(0);
+      table->file->ha_rnd_end();
+    }
+  }
+
   if (m_key_info)
   {
     DBUG_PRINT("info",("locating record using key #%u [%s] (index_read)",
@@ -456,6 +456,63 @@ my_bool my_net_write(NET *net, const uchar *packet, size_t len)
 }
 
 
+#if defined(MYSQL_SERVER) && defined(HAVE_SENDFILE)
+/**
+  Write a logical packet whose payload is a short in-memory prefix followed
+  by a range of a file, the latter sent with vio_sendfile().
+
+  This lets the binlog dump thread stream big events to a slave without
+  copying them into user space. The connection must be a plain socket
+  without compression, and the payload must fit in a single packet
+  (head_len + len < MAX_PACKET_LENGTH).
+
+  @retval
+    0	ok
+  @retval
+    1	error
+*/
+
+my_bool net_write_packet_from_file(NET *net, const uchar *head,
+                                   size_t head_len, File file,
+                                   my_off_t offset, size_t len)
+{
+  uchar buff[NET_HEADER_SIZE];
+  DBUG_ENTER("net_write_packet_from_file");
+  DBUG_ASSERT(!net->compress);
+  DBUG_ASSERT(head_len + len < MAX_PACKET_LENGTH);
+
+  if (unlikely(!net->vio)) /* nowhere to write */
+    DBUG_RETURN(0);
+
+  int3store(buff, head_len + len);
+  buff[3]= (uchar) net->pkt_nr++;
+  /* The packet header and prefix must reach the socket before the file */
+  if (net_write_buff(net, buff, NET_HEADER_SIZE) ||
+      net_write_buff(net, head, head_len) ||
+      net_flush(net))
+    DBUG_RETURN(1);
+
+  net->reading_or_writing= 2;
+  while (len)
+  {
+    size_t length;
+    if ((long) (length= vio_sendfile(net->vio, file, offset, len)) <= 0)
+    {
+      net->error= 2;				/* Close socket */
+      net->last_errno= ER_NET_ERROR_ON_WRITE;
+      MYSQL_SERVER_my_error(net->last_errno, MYF(0));
+      break;
+    }
+    offset+= length;
+    len-= length;
+    update_statistics(thd_increment_bytes_sent(net->thd, length));
+  }
+  net->reading_or_writing= 0;
+  DBUG_RETURN(MY_TEST(len));
+}
+#endif /* MYSQL_SERVER && HAVE_SENDFILE */
+
+
 /**
   Send a command to the server.
 
@@ -76,6 +76,7 @@ Master_info::Master_info(LEX_CSTRING *connection_name_arg,
   copy_filter_setting(rpl_filter, global_rpl_filter);
 
   parallel_mode= rpl_filter->get_parallel_mode();
+  parallel_weight= global_system_variables.slave_parallel_weight;
 
   my_init_dynamic_array(PSI_INSTRUMENT_ME, &ignore_server_ids,
                         sizeof(global_system_variables.server_id), 16, 16,
@@ -342,6 +342,11 @@ class Master_info : public Slave_reporting_capability
 
   /* The parallel replication mode. */
   enum_slave_parallel_mode parallel_mode;
+  /*
+    Share of the parallel replication worker pool, relative to the other
+    connections. See --slave-parallel-weight.
+  */
+  ulonglong parallel_weight;
   /*
     semi_ack is used to identify if the current binlog event needs an
     ACK from slave, or if delay_master is enabled.
@@ -1197,6 +1197,7 @@ handle_rpl_parallel_thread(void *arg)
       if ((event_type= qev->ev->get_type_code()) == GTID_EVENT)
       {
         rpt->last_trans_retry_count= 0;
+        rpt->event_groups++;
         rpt->last_seen_gtid= rgi->current_gtid;
         rpt->channel_name_length= (uint)rgi->rli->mi->connection_name.length;
         if (rpt->channel_name_length)
@@ -2038,14 +2039,15 @@ rpl_parallel_thread::loc_free_gco(group_commit_orderer *gco)
 
 rpl_parallel_thread::rpl_parallel_thread()
   : channel_name_length(0), last_error_number(0), last_error_timestamp(0),
-    worker_idle_time(0), last_trans_retry_count(0), start_time(0)
+    worker_idle_time(0), last_trans_retry_count(0), start_time(0),
+    busy_start_time(0), idle_usec(0), busy_usec(0), event_groups(0)
 {
 }
 
 
 rpl_parallel_thread_pool::rpl_parallel_thread_pool()
-  : threads(0), free_list(0), count(0), inited(false), busy(false),
-    pfs_bkp{0, false, NULL}
+  : threads(0), free_list(0), waiters(0), count(0), inited(false),
+    busy(false), pfs_bkp{0, false, NULL}
 {
 }
 
@@ -2055,6 +2057,7 @@ rpl_parallel_thread_pool::init(uint32 size)
 {
   threads= NULL;
   free_list= NULL;
+  waiters= NULL;
   count= 0;
   busy= false;
 
@@ -2099,23 +2102,77 @@ rpl_parallel_thread_pool::destroy_cond_mutex()
 }
 
 
+/*
+  Check if the connection rp should get the next free worker thread.
+
+  When several multi-source connections wait for a worker at the same time,
+  the one that uses the smallest share of the pool relative to its
+  --slave-parallel-weight goes first, and the earliest waiter among equals.
+  This keeps one busy connection from starving the others when the pool is
+  exhausted.
+*/
+bool
+rpl_parallel_thread_pool::is_next_in_line(rpl_parallel *rp)
+{
+  bool before= true;
+
+  mysql_mutex_assert_owner(&LOCK_rpl_thread_pool);
+  for (rpl_parallel *w= waiters; w; w= w->next_waiter)
+  {
+    if (w == rp)
+    {
+      before= false;
+      continue;
+    }
+    ulonglong w_share= (ulonglong)w->workers_in_use * rp->worker_weight;
+    ulonglong rp_share= (ulonglong)rp->workers_in_use * w->worker_weight;
+    if (w_share < rp_share || (w_share == rp_share && before))
+      return false;
+  }
+  return true;
+}
+
+
 /*
   Wait for a worker thread to become idle. When one does, grab the thread for
-  our use and return it.
+  our use and return it. If other connections are also waiting, the thread
+  goes to the one that is next in line, see is_next_in_line().
 
   Note that we return with the worker threads's LOCK_rpl_thread mutex locked.
 */
 struct rpl_parallel_thread *
 rpl_parallel_thread_pool::get_thread(rpl_parallel_thread **owner,
-                                     rpl_parallel_entry *entry)
+                                     rpl_parallel_entry *entry,
+                                     Relay_log_info *rli)
 {
   rpl_parallel_thread *rpt;
+  rpl_parallel *rp= &rli->parallel;
+  rpl_parallel **ptr;
 
   DBUG_ASSERT(count > 0);
   mysql_mutex_lock(&LOCK_rpl_thread_pool);
-  while (unlikely(busy) || !(rpt= free_list))
+  rp->worker_weight= rli->mi->parallel_weight;
+  rp->next_waiter= NULL;
+  for (ptr= &waiters; *ptr; ptr= &(*ptr)->next_waiter)
+    ;
+  *ptr= rp;
+  DBUG_EXECUTE_IF("rpl_parallel_get_thread_wait",
+    {
+      if (!free_list)
+        debug_sync_set_action(rli->sql_driver_thd,
+                              STRING_WITH_LEN("now SIGNAL get_thread_waiting"));
+    };);
+  while (unlikely(busy) || !(rpt= free_list) || !is_next_in_line(rp))
     mysql_cond_wait(&COND_rpl_thread_pool, &LOCK_rpl_thread_pool);
+  for (ptr= &waiters; *ptr != rp; ptr= &(*ptr)->next_waiter)
+    ;
+  *ptr= rp->next_waiter;
   free_list= rpt->next;
+  rpt->current_source= rp;
+  ++rp->workers_in_use;
+  /* Let the next waiter in line have a go at the remaining free threads. */
+  if (waiters && free_list)
+    mysql_cond_broadcast(&COND_rpl_thread_pool);
   mysql_mutex_unlock(&LOCK_rpl_thread_pool);
   mysql_mutex_lock(&rpt->LOCK_rpl_thread);
   rpt->current_owner= owner;
@@ -2137,10 +2194,15 @@ rpl_parallel_thread_pool::release_thread(rpl_parallel_thread *rpt)
   mysql_mutex_assert_owner(&rpt->LOCK_rpl_thread);
   DBUG_ASSERT(rpt->current_owner == NULL);
   mysql_mutex_lock(&LOCK_rpl_thread_pool);
+  if (rpt->current_source)
+  {
+    rpt->current_source->workers_in_use--;
+    rpt->current_source= NULL;
+  }
   list= free_list;
   rpt->next= list;
   free_list= rpt;
-  if (!list)
+  if (!list || waiters)
     mysql_cond_broadcast(&COND_rpl_thread_pool);
   mysql_mutex_unlock(&LOCK_rpl_thread_pool);
 }
@@ -2225,6 +2287,7 @@ rpl_parallel_entry::choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
       ++idx;
       if (idx >= rpl_thread_max)
         idx= 0;
+      idx= least_loaded_thread(idx);
     }
     rpl_thread_idx= idx;
   }
@@ -2296,11 +2359,51 @@ rpl_parallel_entry::choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
   }
   if (!thr)
     rpl_threads[idx]= thr= global_rpl_thread_pool.get_thread(&rpl_threads[idx],
-                                                             this);
+                                                             this, rli);
 
   return thr;
 }
 
+
+/*
+  Pick the worker for a new event group, starting from the round-robin
+  choice idx.
+
+  A slot whose worker has gone back to the pool is used first, as it will be
+  filled with an idle thread. Otherwise the group goes to the worker with the
+  fewest bytes of events queued, so that a worker that has run out of work
+  takes over the group instead of it waiting behind a busy one.
+*/
+uint32
+rpl_parallel_entry::least_loaded_thread(uint32 idx)
+{
+  uint32 best= idx;
+  uint64 best_load= ULONGLONG_MAX;
+
+  for (uint32 i= 0; i < rpl_thread_max; ++i)
+  {
+    uint32 cur= (idx + i) % rpl_thread_max;
+    rpl_parallel_thread *thr= rpl_threads[cur];
+    uint64 load= 0;
+
+    if (thr)
+    {
+      mysql_mutex_lock(&thr->LOCK_rpl_thread);
+      if (thr->current_owner == &rpl_threads[cur])
+        load= thr->queued_size + 1;
+      mysql_mutex_unlock(&thr->LOCK_rpl_thread);
+    }
+    if (load < best_load)
+    {
+      best= cur;
+      best_load= load;
+      if (!load)
+        break;
+    }
+  }
+  return best;
+}
+
 static void
 free_rpl_parallel_entry(void *element)
 {
@@ -2318,7 +2421,8 @@ free_rpl_parallel_entry(void *element)
 
 
 rpl_parallel::rpl_parallel() :
-  current(NULL), sql_thread_stopping(false)
+  current(NULL), sql_thread_stopping(false), workers_in_use(0),
+  worker_weight(1), next_waiter(NULL)
 {
   my_hash_init(PSI_INSTRUMENT_ME, &domain_hash, &my_charset_bin, 32,
                offsetof(rpl_parallel_entry, domain_id), sizeof(uint32),
@@ -113,6 +113,11 @@ struct rpl_parallel_thread {
   struct rpl_parallel_thread **current_owner;
   /* The rpl_parallel_entry of the owner. */
   rpl_parallel_entry *current_entry;
+  /*
+    The connection that got this thread from the pool, for the fair sharing
+    in get_thread(). Protected by LOCK_rpl_thread_pool.
+  */
+  rpl_parallel *current_source;
   struct queued_event {
     queued_event *next;
     /*
@@ -171,9 +176,20 @@ struct rpl_parallel_thread {
   ulonglong worker_idle_time;
   ulong last_trans_retry_count;
   ulonglong start_time;
+  /*
+    Utilization counters for INFORMATION_SCHEMA.SLAVE_PARALLEL_WORKERS, in
+    microseconds. busy_start_time is when the thread last got work.
+  */
+  ulonglong busy_start_time;
+  ulonglong idle_usec;
+  ulonglong busy_usec;
+  /* Number of event groups this thread has started executing. */
+  ulonglong event_groups;
   void start_time_tracker()
   {
     start_time= microsecond_interval_timer();
+    if (busy_start_time)
+      busy_usec+= start_time - busy_start_time;
   }
   ulonglong compute_time_lapsed()
   {
@@ -181,7 +197,9 @@ struct rpl_parallel_thread {
   }
   void add_to_worker_idle_time_and_reset()
   {
+    busy_start_time= microsecond_interval_timer();
     worker_idle_time+= compute_time_lapsed();
+    idle_usec+= busy_start_time - start_time;
     start_time=0;
   }
   ulonglong get_worker_idle_time()
@@ -293,6 +311,11 @@ struct pool_bkp_for_pfs{
 struct rpl_parallel_thread_pool {
   struct rpl_parallel_thread **threads;
   struct rpl_parallel_thread *free_list;
+  /*
+    Connections waiting in get_thread() for a free thread, in order of
+    arrival. Linked through rpl_parallel::next_waiter.
+  */
+  struct rpl_parallel *waiters;
   mysql_mutex_t LOCK_rpl_thread_pool;
   mysql_cond_t COND_rpl_thread_pool;
   uint32 count;
@@ -312,8 +335,10 @@ struct rpl_parallel_thread_pool {
   void deactivate();
   void destroy_cond_mutex();
   struct rpl_parallel_thread *get_thread(rpl_parallel_thread **owner,
-                                         rpl_parallel_entry *entry);
+                                         rpl_parallel_entry *entry,
+                                         Relay_log_info *rli);
   void release_thread(rpl_parallel_thread *rpt);
+  bool is_next_in_line(rpl_parallel *rp);
 };
 
 
@@ -414,6 +439,7 @@ struct rpl_parallel_entry {
   rpl_parallel_thread * choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
                                       PSI_stage_info *old_stage,
                                       Gtid_log_event *gtid_ev);
+  uint32 least_loaded_thread(uint32 idx);
   int queue_master_restart(rpl_group_info *rgi,
                            Format_description_log_event *fdev);
 };
@@ -421,6 +447,13 @@ struct rpl_parallel {
   HASH domain_hash;
   rpl_parallel_entry *current;
   bool sql_thread_stopping;
+  /*
+    Sharing of global_rpl_thread_pool between multi-source connections, see
+    rpl_parallel_thread_pool::get_thread(). Protected by LOCK_rpl_thread_pool.
+  */
+  uint32 workers_in_use;
+  ulonglong worker_weight;
+  rpl_parallel *next_waiter;
 
   rpl_parallel();
   ~rpl_parallel();
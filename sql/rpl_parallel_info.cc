@@ -0,0 +1,147 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/* INFORMATION_SCHEMA.SLAVE_PARALLEL_WORKERS */
+
+#include <mysql_version.h>
+#include <mysql/plugin.h>
+
+#include "mariadb.h"
+#include "sql_class.h"
+#include "sql_i_s.h"
+#include "sql_show.h"
+#include "sql_parse.h"
+#include "sql_acl.h"
+#include "rpl_parallel.h"
+
+namespace Show {
+
+static ST_FIELD_INFO workers_fields_info[] =
+{
+  Column("WORKER_ID",         ULong(10),     NOT_NULL),
+  Column("THREAD_ID",         ULonglong(21), NULLABLE),
+  Column("CONNECTION_NAME",   Varchar(MAX_CONNECTION_NAME), NOT_NULL),
+  Column("DOMAIN_ID",         ULong(10),     NULLABLE),
+  Column("QUEUED_BYTES",      ULonglong(21), NOT_NULL),
+  Column("EVENT_GROUPS",      ULonglong(21), NOT_NULL),
+  Column("BUSY_MICROSECONDS", ULonglong(21), NOT_NULL),
+  Column("IDLE_MICROSECONDS", ULonglong(21), NOT_NULL),
+  Column("UTILIZATION",       Decimal(602),  NOT_NULL),
+  CEnd()
+};
+
+} // namespace Show
+
+
+/*
+  One row per thread of the parallel replication worker pool. A worker is
+  busy from the moment it gets work from an SQL thread until it waits for
+  more; UTILIZATION is the busy time in percent of the thread's lifetime.
+
+  Like performance_schema.replication_applier_status_by_worker, the values
+  are read under LOCK_rpl_thread_pool only, so they are a snapshot that may
+  be slightly inconsistent between columns. rpl_parallel_thread::current_entry
+  is protected by LOCK_rpl_thread, which must not be acquired after
+  LOCK_rpl_thread_pool, so DOMAIN_ID is taken from the GTID of the event
+  group that a busy worker is applying.
+*/
+static int workers_fill_table(THD* thd, TABLE_LIST* tables, COND*)
+{
+  rpl_parallel_thread_pool *pool= &global_rpl_thread_pool;
+  TABLE* table = tables->table;
+  int res= 0;
+
+  if (check_global_access(thd, PROCESS_ACL | REPL_SLAVE_ADMIN_ACL, true))
+    return 0;
+  if (!pool->inited)
+    return 0;
+
+  mysql_mutex_lock(&pool->LOCK_rpl_thread_pool);
+  ulonglong now= microsecond_interval_timer();
+  for (uint32 i= 0; i < pool->count && !res; i++)
+  {
+    rpl_parallel_thread *rpt= pool->threads[i];
+    THD *worker_thd= rpt->thd;
+    ulonglong idle= rpt->idle_usec;
+    ulonglong busy= rpt->busy_usec;
+    bool is_busy= false;
+
+    if (rpt->start_time)
+      idle+= now - rpt->start_time;
+    else if (rpt->busy_start_time)
+    {
+      busy+= now - rpt->busy_start_time;
+      is_busy= true;
+    }
+
+    table->field[0]->store(i, true);
+    if (worker_thd)
+    {
+      table->field[1]->set_notnull();
+      table->field[1]->store(worker_thd->thread_id, true);
+    }
+    else
+      table->field[1]->set_null();
+    table->field[2]->store(rpt->channel_name, rpt->channel_name_length,
+                           system_charset_info);
+    if (is_busy && rpt->event_groups)
+    {
+      table->field[3]->set_notnull();
+      table->field[3]->store(rpt->last_seen_gtid.domain_id, true);
+    }
+    else
+      table->field[3]->set_null();
+    table->field[4]->store(rpt->queued_size, true);
+    table->field[5]->store(rpt->event_groups, true);
+    table->field[6]->store(busy, true);
+    table->field[7]->store(idle, true);
+    table->field[8]->store(busy + idle ? 100.0 * busy / (busy + idle) : 0.0);
+
+    res= schema_table_store_record(thd, table);
+  }
+  mysql_mutex_unlock(&pool->LOCK_rpl_thread_pool);
+  return res;
+}
+
+
+static int workers_init(void* p)
+{
+  ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*)p;
+  schema->fields_info = Show::workers_fields_info;
+  schema->fill_table = workers_fill_table;
+  return 0;
+}
+
+
+static struct st_mysql_information_schema plugin_descriptor =
+{ MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
+
+maria_declare_plugin(slave_parallel_info)
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &plugin_descriptor,
+  "SLAVE_PARALLEL_WORKERS",
+  "MariaDB Corporation",
+  "Provides utilization of the parallel replication worker threads.",
+  PLUGIN_LICENSE_GPL,
+  workers_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
+}
+maria_declare_plugin_end;
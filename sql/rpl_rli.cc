@@ -63,6 +63,9 @@ Relay_log_info::Relay_log_info(bool is_slave_recovery, const char* thread_name)
    until_log_pos(0), retried_trans(0), executed_entries(0),
    last_trans_retry_count(0), sql_delay(0), sql_delay_end(0),
    until_relay_log_names_defer(false),
+   relay_queue_first(0), relay_queue_last(&relay_queue_first),
+   relay_queue_read(&relay_queue_first), relay_queue_size(0),
+   relay_queue_last_seq(0), relay_queue_read_seq(0), group_relay_queue_seq(0),
    m_flags(0)
 {
   DBUG_ENTER("Relay_log_info::Relay_log_info");
@@ -107,6 +110,7 @@ Relay_log_info::~Relay_log_info()
   DBUG_ENTER("Relay_log_info::~Relay_log_info");
 
   reset_inuse_relaylog();
+  clear_relay_queue();
   mysql_mutex_destroy(&run_lock);
   mysql_mutex_destroy(&data_lock);
   mysql_mutex_destroy(&log_space_lock);
@@ -686,6 +690,7 @@ int init_relay_log_pos(Relay_log_info* rli,const char* log,
   }
 
   rli->group_relay_log_pos = rli->event_relay_log_pos = pos;
+  rli->rewind_relay_queue();
   rli->clear_flag(Relay_log_info::IN_STMT);
   rli->clear_flag(Relay_log_info::IN_TRANSACTION);
 
@@ -1035,6 +1040,7 @@ void Relay_log_info::inc_group_relay_log_pos(ulonglong log_pos,
     /* Non-parallel case. */
     group_relay_log_pos= event_relay_log_pos;
     strmake_buf(group_relay_log_name, event_relay_log_name);
+    group_relay_queue_seq= relay_queue_read_seq;
     notify_group_relay_log_name_update();
     if (log_pos) // not 3.23 binlogs (no log_pos there) and not Stop_log_event
       group_master_log_pos= log_pos;
@@ -1223,6 +1229,7 @@ int purge_relay_logs(Relay_log_info* rli, THD *thd, bool just_reset,
     error=1;
     goto err;
   }
+  rli->clear_relay_queue();
   rli->relay_log_state.load(rpl_global_gtid_slave_state);
   if (!just_reset)
   {
@@ -1568,6 +1575,161 @@ Relay_log_info::update_relay_log_state(rpl_gtid *gtid_list, uint32 count)
 }
 
 
+/*
+  Free the events of the in-memory relay queue that belong to committed
+  event groups. Caller must hold relay_log.LOCK_log.
+*/
+static void
+free_committed_relay_queue(Relay_log_info *rli)
+{
+  relay_queue_event *qev;
+  uint64 committed= rli->group_relay_queue_seq;
+  bool read_freed= false;
+
+  while ((qev= rli->relay_queue_first) && qev->seq <= committed)
+  {
+    if (rli->relay_queue_read == &qev->next)
+      read_freed= true;
+    rli->relay_queue_first= qev->next;
+    rli->relay_queue_size-= qev->len;
+    my_free(qev);
+  }
+  if (!rli->relay_queue_first)
+    rli->relay_queue_last= &rli->relay_queue_first;
+  if (read_freed)
+    rli->relay_queue_read= &rli->relay_queue_first;
+}
+
+
+/*
+  Put an event received by the IO thread in the in-memory relay queue
+  instead of writing it to the relay log.
+
+  Caller must hold relay_log.LOCK_log.
+
+  @retval false  The event was queued.
+  @retval true   The queue is full or out of memory; the caller must write
+                 the event to the relay log.
+*/
+bool
+Relay_log_info::queue_relay_event(const uchar *buf, uint len)
+{
+  relay_queue_event *qev;
+  DBUG_ENTER("Relay_log_info::queue_relay_event");
+  mysql_mutex_assert_owner(relay_log.get_log_lock());
+
+  free_committed_relay_queue(this);
+  if (relay_queue_size + len > opt_slave_relay_log_bypass_size)
+    DBUG_RETURN(true);
+  if (!(qev= (relay_queue_event *)my_malloc(PSI_INSTRUMENT_ME,
+                                            sizeof(*qev) + len, MYF(0))))
+    DBUG_RETURN(true);
+  qev->next= NULL;
+  qev->log_number= strtoul(fn_ext(relay_log.get_log_fname()) + 1, NULL, 10);
+  qev->log_pos= my_b_append_tell(relay_log.get_log_file());
+  qev->seq= relay_queue_last_seq + 1;
+  qev->len= len;
+  memcpy(qev->data, buf, len);
+
+  *relay_queue_last= qev;
+  relay_queue_last= &qev->next;
+  relay_queue_size+= len;
+  relay_queue_last_seq= qev->seq;
+  statistic_increment(slave_relay_queue_events, &LOCK_status);
+  statistic_add(slave_relay_queue_bytes, len, &LOCK_status);
+  DBUG_RETURN(false);
+}
+
+
+/*
+  Return the next event of the in-memory relay queue if it belongs at the
+  current read position of the SQL thread, log_pos in event_relay_log_name.
+
+  Caller must hold relay_log.LOCK_log and data_lock.
+
+  @retval 0  Success. *ev is NULL if no queued event is due yet.
+  @retval 1  Error, *errmsg is set.
+*/
+int
+Relay_log_info::read_relay_queue(my_off_t log_pos, Log_event **ev,
+                                 ulonglong *event_size, const char **errmsg)
+{
+  relay_queue_event *qev;
+  ulong log_number;
+  char *buf;
+  DBUG_ENTER("Relay_log_info::read_relay_queue");
+  mysql_mutex_assert_owner(relay_log.get_log_lock());
+  mysql_mutex_assert_owner(&data_lock);
+
+  *ev= NULL;
+  free_committed_relay_queue(this);
+  if (!(qev= *relay_queue_read))
+    DBUG_RETURN(0);
+  log_number= strtoul(fn_ext(event_relay_log_name) + 1, NULL, 10);
+  if (qev->log_number > log_number ||
+      (qev->log_number == log_number && qev->log_pos > log_pos))
+    DBUG_RETURN(0);
+
+  if (!(buf= (char *)my_memdup(PSI_INSTRUMENT_ME, qev->data, qev->len,
+                               MYF(MY_WME))))
+  {
+    *errmsg= "Out of memory reading the in-memory relay queue";
+    DBUG_RETURN(1);
+  }
+  if (!(*ev= Log_event::read_log_event(buf, qev->len, errmsg,
+                                       relay_log.description_event_for_exec,
+                                       opt_slave_sql_verify_checksum)))
+  {
+    my_free(buf);
+    DBUG_RETURN(1);
+  }
+  (*ev)->register_temp_buf(buf, true);
+
+  relay_queue_read= &qev->next;
+  relay_queue_read_seq= qev->seq;
+  *event_size= qev->len;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Make the SQL thread read the in-memory relay queue again from the first
+  event after the last committed event group. Called when the SQL thread is
+  positioned back to group_relay_log_pos.
+
+  Caller must hold relay_log.LOCK_log.
+*/
+void
+Relay_log_info::rewind_relay_queue()
+{
+  mysql_mutex_assert_owner(relay_log.get_log_lock());
+  free_committed_relay_queue(this);
+  relay_queue_read= &relay_queue_first;
+  relay_queue_read_seq= group_relay_queue_seq;
+}
+
+
+/*
+  Discard the in-memory relay queue, when the relay logs are reset.
+*/
+void
+Relay_log_info::clear_relay_queue()
+{
+  relay_queue_event *qev, *next;
+  mysql_mutex_lock(relay_log.get_log_lock());
+  for (qev= relay_queue_first; qev; qev= next)
+  {
+    next= qev->next;
+    my_free(qev);
+  }
+  relay_queue_first= NULL;
+  relay_queue_last= relay_queue_read= &relay_queue_first;
+  relay_queue_size= 0;
+  relay_queue_last_seq= relay_queue_read_seq= group_relay_queue_seq= 0;
+  mysql_mutex_unlock(relay_log.get_log_lock());
+}
+
+
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
 struct gtid_pos_element { uint64 sub_id; rpl_gtid gtid; void *hton; };
 
@@ -58,6 +58,7 @@ class Rpl_filter;
 
 struct rpl_group_info;
 struct inuse_relaylog;
+struct relay_queue_event;
 
 class Relay_log_info : public Slave_reporting_capability
 {
@@ -259,6 +260,33 @@ class Relay_log_info : public Slave_reporting_capability
   */
   bool sql_thread_caught_up;
 
+  /*
+    In-memory relay queue, see --slave-relay-log-bypass-size. The IO thread
+    can put an event here instead of writing it to the relay log. The event
+    keeps the relay log file and offset it would have been written at, and
+    next_event() returns it when the SQL thread reaches that offset. Events
+    stay queued until their event group is committed, so that a retried
+    transaction or a restarted SQL thread reads them again.
+
+    The list is protected by relay_log.LOCK_log.
+  */
+  relay_queue_event *relay_queue_first, **relay_queue_last;
+  /* The next field of the last event returned to the SQL thread */
+  relay_queue_event **relay_queue_read;
+  size_t relay_queue_size;
+  /* Sequence number of the last queued event */
+  Atomic_counter<uint64> relay_queue_last_seq;
+  /* Last event returned to the SQL thread. Protected by data_lock. */
+  uint64 relay_queue_read_seq;
+  /* Last event of the last committed event group */
+  Atomic_counter<uint64> group_relay_queue_seq;
+
+  bool queue_relay_event(const uchar *buf, uint len);
+  int read_relay_queue(my_off_t log_pos, Log_event **ev, ulonglong *event_size,
+                       const char **errmsg);
+  void rewind_relay_queue();
+  void clear_relay_queue();
+
   void clear_until_condition();
   /**
     Reset the delay.
@@ -592,6 +620,20 @@ class Relay_log_info : public Slave_reporting_capability
 };
 
 
+/*
+  An event of the in-memory relay queue, see Relay_log_info::relay_queue_first.
+*/
+struct relay_queue_event {
+  relay_queue_event *next;
+  /* Number of the relay log file and offset the event belongs at */
+  ulong log_number;
+  my_off_t log_pos;
+  uint64 seq;
+  uint len;
+  uchar data[1];
+};
+
+
 /*
   In parallel replication, if we need to re-try a transaction due to a
   deadlock or other temporary error, we may need to go back and re-read events
@@ -0,0 +1,237 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/* Writeset-based dependency tracking for parallel replication */
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "sql_class.h"
+#include "rpl_writeset.h"
+
+ulong opt_binlog_transaction_dependency_tracking=
+  BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER;
+ulong opt_binlog_transaction_dependency_history_size= 25000;
+
+
+Binlog_writeset::Binlog_writeset()
+  : m_hashes(PSI_INSTRUMENT_MEM, 16, 64), m_unsafe(false),
+    m_checked_table(NULL), m_checked_query_id(0), m_checked_ok(false)
+{
+}
+
+
+void Binlog_writeset::reset()
+{
+  m_hashes.clear();
+  m_unsafe= false;
+  m_checked_table= NULL;
+}
+
+
+/*
+  Check whether the conflicts between changes of a table can be detected
+  from the key values.
+
+  Without a primary key, two changes of the same row need not have any
+  key value in common. Foreign keys make changes of different rows in
+  different tables conflict. Prefix and hash-based unique keys may consider
+  values equal that differ in the hashed part.
+*/
+bool Binlog_writeset::check_table(THD *thd, TABLE *table)
+{
+  if (m_checked_table == table && m_checked_query_id == thd->query_id)
+    return m_checked_ok;
+
+  bool ok= table->s->primary_key != MAX_KEY &&
+           table->file->has_transactions() &&
+           table->file->can_switch_engines();
+
+  for (uint i= 0; ok && i < table->s->keys; i++)
+  {
+    const KEY *key= &table->key_info[i];
+    if (!(key->flags & HA_NOSAME))
+      continue;
+    if (key->algorithm == HA_KEY_ALG_LONG_HASH)
+      ok= false;
+    for (uint j= 0; ok && j < key->user_defined_key_parts; j++)
+      if (key->key_part[j].key_part_flag & HA_PART_KEY_SEG)
+        ok= false;
+  }
+
+  m_checked_table= table;
+  m_checked_query_id= thd->query_id;
+  m_checked_ok= ok;
+  return ok;
+}
+
+
+/*
+  Add the unique key values of a row to the writeset.
+
+  @param thd        the thread that is logging the row
+  @param table      the table that the row belongs to
+  @param record     table->record[0] or table->record[1]
+  @param read_only  whether only the columns in table->read_set are valid
+*/
+void Binlog_writeset::add_row(THD *thd, TABLE *table, const uchar *record,
+                              bool read_only)
+{
+  if (m_unsafe)
+    return;
+
+  if (!check_table(thd, table) ||
+      m_hashes.elements() >= opt_binlog_transaction_dependency_history_size)
+  {
+    m_unsafe= true;
+    return;
+  }
+
+  const TABLE_SHARE *s= table->s;
+  const my_ptrdiff_t diff= record - table->record[0];
+
+  for (uint i= 0; i < s->keys; i++)
+  {
+    const KEY *key= &table->key_info[i];
+    if (!(key->flags & HA_NOSAME))
+      continue;
+
+    /* Identify the table and the index */
+    ulong nr1= 1, nr2= 4;
+    my_charset_bin.hash_sort((const uchar*) s->db.str, s->db.length + 1,
+                             &nr1, &nr2);
+    my_charset_bin.hash_sort((const uchar*) s->table_name.str,
+                             s->table_name.length + 1, &nr1, &nr2);
+    uchar idx= (uchar) i;
+    my_charset_bin.hash_sort(&idx, 1, &nr1, &nr2);
+
+    bool has_null= false;
+    for (uint j= 0; j < key->user_defined_key_parts; j++)
+    {
+      Field *field= key->key_part[j].field;
+      if (read_only && !bitmap_is_set(table->read_set, field->field_index))
+      {
+        /* The value was not read; we cannot tell what it conflicts with */
+        m_unsafe= true;
+        return;
+      }
+      field->move_field_offset(diff);
+      if (field->is_null())
+        has_null= true;
+      else
+        /* Collation-aware, so that values that compare equal collide */
+        field->hash(&nr1, &nr2);
+      field->move_field_offset(-diff);
+      if (has_null)
+        break;
+    }
+
+    /* NULL values never violate uniqueness */
+    if (!has_null)
+      m_hashes.append((ulonglong) nr1 ^ ((ulonglong) nr2 << 32));
+  }
+}
+
+
+Binlog_writeset_history::Binlog_writeset_history()
+  : m_commit_id(0), m_group(0), m_commit_id_group(0), m_unsafe(true)
+{
+  my_hash_clear(&m_hash);
+}
+
+
+void Binlog_writeset_history::destroy()
+{
+  if (my_hash_inited(&m_hash))
+  {
+    my_hash_free(&m_hash);
+    free_root(&m_mem_root, MYF(0));
+  }
+}
+
+
+void Binlog_writeset_history::new_commit_id()
+{
+  /*
+    Use a fresh query id, so that the value differs from any commit_id
+    written with binlog_transaction_dependency_tracking=COMMIT_ORDER.
+  */
+  m_commit_id= next_query_id();
+  m_commit_id_group= m_group;
+  m_unsafe= false;
+  if (m_hash.records)
+  {
+    my_hash_reset(&m_hash);
+    free_root(&m_mem_root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+}
+
+
+uint64 Binlog_writeset_history::get_commit_id(const Binlog_writeset *ws)
+{
+  if (!my_hash_inited(&m_hash))
+  {
+    my_hash_init(PSI_INSTRUMENT_ME, &m_hash, &my_charset_bin, 1024, 0,
+                 sizeof(ulonglong), NULL, NULL, HASH_UNIQUE);
+    init_alloc_root(PSI_INSTRUMENT_ME, &m_mem_root, 8192, 0, MYF(0));
+  }
+
+  if (m_group == m_commit_id_group)
+  {
+    /*
+      Transactions in the same group commit were prepared concurrently
+      and thus cannot conflict with each other.
+    */
+  }
+  else if (!ws || m_unsafe ||
+           m_hash.records + ws->elements() >
+           opt_binlog_transaction_dependency_history_size)
+    new_commit_id();
+  else
+  {
+    for (size_t i= 0; i < ws->elements(); i++)
+    {
+      ulonglong h= ws->at(i);
+      if (my_hash_search(&m_hash, (const uchar*) &h, sizeof h))
+      {
+        new_commit_id();
+        break;
+      }
+    }
+    /* Transactions of several group commits share m_commit_id now. */
+    if (m_commit_id_group != m_group)
+      m_commit_id_group= 0;
+  }
+
+  if (!ws)
+    m_unsafe= true;
+  else if (!m_unsafe)
+  {
+    for (size_t i= 0; i < ws->elements(); i++)
+    {
+      ulonglong h= ws->at(i);
+      if (my_hash_search(&m_hash, (const uchar*) &h, sizeof h))
+        continue;
+      ulonglong *rec= (ulonglong*) alloc_root(&m_mem_root, sizeof h);
+      if (!rec || (*rec= h, my_hash_insert(&m_hash, (uchar*) rec)))
+      {
+        /* Out of memory; do not let anything join this commit_id */
+        m_unsafe= true;
+        break;
+      }
+    }
+  }
+
+  return m_commit_id;
+}
@@ -0,0 +1,116 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#ifndef RPL_WRITESET_H
+#define RPL_WRITESET_H
+
+#include "hash.h"
+#include "sql_array.h"
+
+/*
+  Writeset-based dependency tracking for parallel replication.
+
+  With binlog_transaction_dependency_tracking=WRITESET, every transaction
+  collects a hash of each primary key and unique key value of the rows it
+  inserts, updates or deletes. When the binlog group commit leader writes
+  the GTID events, a transaction whose writeset does not intersect with
+  the writesets of the transactions since the last change of commit_id
+  keeps that commit_id, even if it was committed in a later group commit.
+  The slave (--slave-parallel-mode=conservative) already runs event groups
+  with the same commit_id in parallel and keeps their commit order, so
+  transactions that committed one by one on a lightly loaded master can
+  still be applied in parallel.
+
+  Anything that cannot be described by row keys (statements, DDL, tables
+  without a primary key, tables with foreign keys, non-transactional
+  tables) starts a new commit_id.
+*/
+
+class THD;
+struct TABLE;
+
+enum enum_binlog_dependency_tracking
+{
+  BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER,
+  BINLOG_DEPENDENCY_TRACKING_WRITESET
+};
+
+extern ulong opt_binlog_transaction_dependency_tracking;
+extern ulong opt_binlog_transaction_dependency_history_size;
+
+
+/* The writeset of the transaction that is being binlogged by a THD. */
+class Binlog_writeset
+{
+public:
+  Binlog_writeset();
+  /* Add the key values of a row in table->record[0] or table->record[1]. */
+  void add_row(THD *thd, TABLE *table, const uchar *record, bool read_only);
+  /* Note that the transaction cannot be described by its writeset. */
+  void set_unsafe() { m_unsafe= true; }
+  /* Whether the transaction may run in parallel with non-conflicting ones. */
+  bool is_safe() const { return !m_unsafe && m_hashes.elements(); }
+  size_t elements() const { return m_hashes.elements(); }
+  ulonglong at(size_t i) const { return m_hashes.at(i); }
+  void reset();
+
+private:
+  bool check_table(THD *thd, TABLE *table);
+
+  Dynamic_array<ulonglong> m_hashes;
+  bool m_unsafe;
+  /* Cached result of check_table(), for the current statement */
+  TABLE *m_checked_table;
+  query_id_t m_checked_query_id;
+  bool m_checked_ok;
+};
+
+
+/*
+  Writesets of the transactions that were written to the binlog with the
+  current commit_id. Protected by LOCK_log.
+*/
+class Binlog_writeset_history
+{
+public:
+  Binlog_writeset_history();
+  void destroy();
+  /* Note that a new binlog group commit starts. */
+  void new_group() { m_group++; }
+  /*
+    Return the commit_id for the next transaction in the group commit.
+    @param ws  the writeset of the transaction, or NULL if the
+               transaction must not run in parallel with earlier ones
+  */
+  uint64 get_commit_id(const Binlog_writeset *ws);
+
+private:
+  void new_commit_id();
+
+  HASH m_hash;
+  MEM_ROOT m_mem_root;
+  uint64 m_commit_id;
+  /* The number of the current group commit */
+  uint64 m_group;
+  /*
+    The group commit that all transactions with m_commit_id belong to,
+    or 0 if they belong to several group commits.
+  */
+  uint64 m_commit_id_group;
+  /* Whether a transaction with m_commit_id had no usable writeset */
+  bool m_unsafe;
+};
+
+#endif /* RPL_WRITESET_H */
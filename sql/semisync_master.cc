@@ -339,15 +339,14 @@ Repl_semi_sync_master::Repl_semi_sync_master()
     m_init_done(false),
     m_reply_file_name_inited(false),
     m_reply_file_pos(0L),
-    m_wait_file_name_inited(false),
-    m_wait_file_pos(0),
+    m_waiters_front(NULL),
+    m_waiters_rear(NULL),
     m_master_enabled(false),
     m_wait_timeout(0L),
     m_state(0),
     m_wait_point(0)
 {
   strcpy(m_reply_file_name, "");
-  strcpy(m_wait_file_name, "");
 }
 
 int Repl_semi_sync_master::init_object()
@@ -366,8 +365,6 @@ int Repl_semi_sync_master::init_object()
                    &LOCK_rpl_semi_sync_master_enabled, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_binlog,
                    &LOCK_binlog, MY_MUTEX_INIT_FAST);
-  mysql_cond_init(key_COND_binlog_send,
-                  &COND_binlog_send, NULL);
 
   if (rpl_semi_sync_master_enabled)
   {
@@ -405,7 +402,6 @@ int Repl_semi_sync_master::enable_master()
     {
       m_commit_file_name_inited = false;
       m_reply_file_name_inited  = false;
-      m_wait_file_name_inited   = false;
 
       set_master_enabled(true);
       m_state = true;
@@ -440,7 +436,6 @@ void Repl_semi_sync_master::disable_master()
     m_active_tranxs = NULL;
 
     m_reply_file_name_inited = false;
-    m_wait_file_name_inited  = false;
     m_commit_file_name_inited = false;
 
     set_master_enabled(false);
@@ -456,7 +451,6 @@ void Repl_semi_sync_master::cleanup()
   {
     mysql_mutex_destroy(&LOCK_rpl_semi_sync_master_enabled);
     mysql_mutex_destroy(&LOCK_binlog);
-    mysql_cond_destroy(&COND_binlog_send);
     m_init_done= 0;
   }
 
@@ -473,21 +467,63 @@ void Repl_semi_sync_master::unlock()
   mysql_mutex_unlock(&LOCK_binlog);
 }
 
-void Repl_semi_sync_master::cond_broadcast()
+void Repl_semi_sync_master::add_waiter(Semisync_waiter *waiter)
 {
-  mysql_cond_broadcast(&COND_binlog_send);
+  Semisync_waiter *prev= m_waiters_rear;
+
+  mysql_mutex_assert_owner(&LOCK_binlog);
+
+  /* Transactions mostly start waiting in binlog order. */
+  while (prev && Active_tranx::compare(waiter->log_name, waiter->log_pos,
+                                       prev->log_name, prev->log_pos) < 0)
+    prev= prev->prev;
+  if (prev != m_waiters_rear)
+    rpl_semi_sync_master_wait_pos_backtraverse++;
+
+  waiter->prev= prev;
+  waiter->next= prev ? prev->next : m_waiters_front;
+  if (waiter->next)
+    waiter->next->prev= waiter;
+  else
+    m_waiters_rear= waiter;
+  if (prev)
+    prev->next= waiter;
+  else
+    m_waiters_front= waiter;
+  waiter->queued= true;
 }
 
-int Repl_semi_sync_master::cond_timewait(struct timespec *wait_time)
+void Repl_semi_sync_master::remove_waiter(Semisync_waiter *waiter)
 {
-  int wait_res;
+  mysql_mutex_assert_owner(&LOCK_binlog);
+  DBUG_ASSERT(waiter->queued);
 
-  DBUG_ENTER("Repl_semi_sync_master::cond_timewait()");
+  if (waiter->prev)
+    waiter->prev->next= waiter->next;
+  else
+    m_waiters_front= waiter->next;
+  if (waiter->next)
+    waiter->next->prev= waiter->prev;
+  else
+    m_waiters_rear= waiter->prev;
+  waiter->queued= false;
+}
 
-  wait_res= mysql_cond_timedwait(&COND_binlog_send,
-                                 &LOCK_binlog, wait_time);
+void Repl_semi_sync_master::wake_waiters(const char *log_file_name,
+                                         my_off_t log_file_pos)
+{
+  mysql_mutex_assert_owner(&LOCK_binlog);
 
-  DBUG_RETURN(wait_res);
+  while (m_waiters_front &&
+         (!log_file_name ||
+          Active_tranx::compare(m_waiters_front->log_name,
+                                m_waiters_front->log_pos,
+                                log_file_name, log_file_pos) <= 0))
+  {
+    Semisync_waiter *waiter= m_waiters_front;
+    remove_waiter(waiter);
+    mysql_cond_signal(&waiter->cond);
+  }
 }
 
 void Repl_semi_sync_master::add_slave()
@@ -516,16 +552,15 @@ void Repl_semi_sync_master::remove_slave()
   unlock();
 }
 
-int Repl_semi_sync_master::report_reply_packet(uint32 server_id,
-                                               const uchar *packet,
-                                               ulong packet_len)
+int Repl_semi_sync_master::read_reply_packet(const uchar *packet,
+                                             ulong packet_len,
+                                             char *log_file_name,
+                                             my_off_t *log_file_pos)
 {
   int result= -1;
-  char log_file_name[FN_REFLEN+1];
-  my_off_t log_file_pos;
   ulong log_file_len = 0;
 
-  DBUG_ENTER("Repl_semi_sync_master::report_reply_packet");
+  DBUG_ENTER("Repl_semi_sync_master::read_reply_packet");
 
   if (unlikely(packet[REPLY_MAGIC_NUM_OFFSET] !=
                Repl_semi_sync_master::k_packet_magic_num))
@@ -540,7 +575,7 @@ int Repl_semi_sync_master::report_reply_packet(uint32 server_id,
     goto l_end;
   }
 
-  log_file_pos = uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
+  *log_file_pos = uint8korr(packet + REPLY_BINLOG_POS_OFFSET);
   log_file_len = packet_len - REPLY_BINLOG_NAME_OFFSET;
   if (unlikely(log_file_len >= FN_REFLEN))
   {
@@ -552,12 +587,12 @@ int Repl_semi_sync_master::report_reply_packet(uint32 server_id,
 
   DBUG_ASSERT(dirname_length(log_file_name) == 0);
 
-  DBUG_PRINT("semisync", ("%s: Got reply(%s, %lu) from server %u",
-                          "Repl_semi_sync_master::report_reply_packet",
-                          log_file_name, (ulong)log_file_pos, server_id));
+  DBUG_PRINT("semisync", ("%s: Got reply(%s, %lu)",
+                          "Repl_semi_sync_master::read_reply_packet",
+                          log_file_name, (ulong)*log_file_pos));
 
   rpl_semi_sync_master_get_ack++;
-  report_reply_binlog(server_id, log_file_name, log_file_pos);
+  result= 0;
 
 l_end:
 
@@ -569,7 +604,6 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
                                                my_off_t log_file_pos)
 {
   int   cmp;
-  bool  can_release_threads = false;
   bool  need_copy_send_pos = true;
 
   DBUG_ENTER("Repl_semi_sync_master::report_reply_binlog");
@@ -628,34 +662,15 @@ int Repl_semi_sync_master::report_reply_binlog(uint32 server_id,
                             log_file_name, (ulong)log_file_pos));
   }
 
-  if (rpl_semi_sync_master_wait_sessions > 0)
-  {
-    /* Let us check if some of the waiting threads doing a trx
-     * commit can now proceed.
-     */
-    cmp = Active_tranx::compare(m_reply_file_name, m_reply_file_pos,
-                                m_wait_file_name, m_wait_file_pos);
-    if (cmp >= 0)
-    {
-      /* Yes, at least one waiting thread can now proceed:
-       * let us release all waiting threads with a broadcast
-       */
-      can_release_threads = true;
-      m_wait_file_name_inited = false;
-    }
-  }
+  /* Let the waiting threads whose transactions are now replicated
+   * proceed; the others keep sleeping.
+   */
+  if (m_reply_file_name_inited)
+    wake_waiters(m_reply_file_name, m_reply_file_pos);
 
  l_end:
   unlock();
 
-  if (can_release_threads)
-  {
-    DBUG_PRINT("semisync", ("%s: signal all waiting threads.",
-                            "Repl_semi_sync_master::report_reply_binlog"));
-
-    cond_broadcast();
-  }
-
   DBUG_RETURN(0);
 }
 
@@ -790,15 +805,21 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
     int wait_result;
     PSI_stage_info old_stage;
     THD *thd= current_thd;
+    Semisync_waiter waiter;
 
     set_timespec(start_ts, 0);
 
+    waiter.log_name= trx_wait_binlog_name;
+    waiter.log_pos= trx_wait_binlog_pos;
+    waiter.queued= false;
+    mysql_cond_init(key_COND_binlog_send, &waiter.cond, NULL);
+
     DEBUG_SYNC(thd, "rpl_semisync_master_commit_trx_before_lock");
     /* Acquire the mutex. */
     lock();
 
     /* This must be called after acquired the lock */
-    THD_ENTER_COND(thd, &COND_binlog_send, &LOCK_binlog,
+    THD_ENTER_COND(thd, &waiter.cond, &LOCK_binlog,
                    & stage_waiting_for_semi_sync_ack_from_slave,
                    & old_stage);
 
@@ -831,36 +852,11 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
         }
       }
 
-      /* Let us update the info about the minimum binlog position of waiting
-       * threads.
+      /* Queue this thread, so that a reply covering its position wakes
+       * it up; replies to earlier positions do not.
        */
-      if (m_wait_file_name_inited)
-      {
-        int cmp = Active_tranx::compare(trx_wait_binlog_name,
-                                        trx_wait_binlog_pos,
-                                        m_wait_file_name, m_wait_file_pos);
-        if (cmp <= 0)
-	{
-          /* This thd has a lower position, let's update the minimum info. */
-          strmake_buf(m_wait_file_name, trx_wait_binlog_name);
-          m_wait_file_pos = trx_wait_binlog_pos;
-
-          rpl_semi_sync_master_wait_pos_backtraverse++;
-          DBUG_PRINT("semisync", ("%s: move back wait position (%s, %lu),",
-                                  "Repl_semi_sync_master::commit_trx",
-                                  m_wait_file_name, (ulong)m_wait_file_pos));
-        }
-      }
-      else
-      {
-        strmake_buf(m_wait_file_name, trx_wait_binlog_name);
-        m_wait_file_pos = trx_wait_binlog_pos;
-        m_wait_file_name_inited = true;
-
-        DBUG_PRINT("semisync", ("%s: init wait position (%s, %lu),",
-                                "Repl_semi_sync_master::commit_trx",
-                                m_wait_file_name, (ulong)m_wait_file_pos));
-      }
+      if (!waiter.queued)
+        add_waiter(&waiter);
 
       /* Calcuate the waiting period. */
       long diff_secs = (long) (m_wait_timeout / TIME_THOUSAND);
@@ -882,9 +878,11 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
       DBUG_PRINT("semisync", ("%s: wait %lu ms for binlog sent (%s, %lu)",
                               "Repl_semi_sync_master::commit_trx",
                               m_wait_timeout,
-                              m_wait_file_name, (ulong)m_wait_file_pos));
+                              trx_wait_binlog_name,
+                              (ulong)trx_wait_binlog_pos));
 
-      wait_result = cond_timewait(&abstime);
+      wait_result = mysql_cond_timedwait(&waiter.cond, &LOCK_binlog,
+                                         &abstime);
       rpl_semi_sync_master_wait_sessions--;
 
       if (wait_result != 0)
@@ -924,13 +922,17 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
       At this point, the binlog file and position of this transaction
       must have been removed from Active_tranx.
       m_active_tranxs may be NULL if someone disabled semi sync during
-      cond_timewait()
+      the wait
     */
     assert(thd_killed(thd) || !m_active_tranxs ||
            !m_active_tranxs->is_tranx_end_pos(trx_wait_binlog_name,
                                              trx_wait_binlog_pos));
 
   l_end:
+    /* The thread was killed, or semi-sync was disabled while waiting */
+    if (waiter.queued)
+      remove_waiter(&waiter);
+
     /* Update the status counter. */
     if (is_on())
       rpl_semi_sync_master_yes_transactions++;
@@ -940,6 +942,7 @@ int Repl_semi_sync_master::commit_trx(const char* trx_wait_binlog_name,
     /* The lock held will be released by thd_exit_cond, so no need to
        call unlock() here */
     THD_EXIT_COND(thd, &old_stage);
+    mysql_cond_destroy(&waiter.cond);
   }
 
   DBUG_RETURN(0);
@@ -974,10 +977,9 @@ void Repl_semi_sync_master::switch_off()
   m_active_tranxs->clear_active_tranx_nodes(NULL, 0);
 
   rpl_semi_sync_master_off_times++;
-  m_wait_file_name_inited   = false;
   m_reply_file_name_inited  = false;
   sql_print_information("Semi-sync replication switched OFF.");
-  cond_broadcast();                            /* wake up all waiting threads */
+  wake_waiters(NULL, 0);                       /* wake up all waiting threads */
 
   DBUG_VOID_RETURN;
 }
@@ -1079,10 +1081,11 @@ int Repl_semi_sync_master::update_sync_header(THD* thd, unsigned char *packet,
       }
     }
 
-    if (m_wait_file_name_inited)
+    if (m_waiters_front)
     {
       cmp = Active_tranx::compare(log_file_name, log_file_pos,
-                                 m_wait_file_name, m_wait_file_pos);
+                                  m_waiters_front->log_name,
+                                  m_waiters_front->log_pos);
     }
     else
     {
@@ -1258,9 +1261,10 @@ int Repl_semi_sync_master::after_reset_master()
   else
     m_state = get_master_enabled()? 1 : 0;
 
-  m_wait_file_name_inited   = false;
   m_reply_file_name_inited  = false;
   m_commit_file_name_inited = false;
+  /* Let any waiters recheck their positions against the new binlog */
+  wake_waiters(NULL, 0);
 
   rpl_semi_sync_master_yes_transactions = 0;
   rpl_semi_sync_master_no_transactions = 0;
@@ -361,6 +361,20 @@ class Active_tranx
 
 };
 
+/**
+   A session waiting in Repl_semi_sync_master::commit_trx() for the reply
+   to the end position of its transaction. Waiters are queued in binlog
+   position order, so that a reply wakes up only those waiters whose
+   positions it covers.
+*/
+struct Semisync_waiter {
+  const char       *log_name;
+  my_off_t          log_pos;
+  mysql_cond_t      cond;              /* signalled when woken up */
+  Semisync_waiter  *prev, *next;
+  bool              queued;            /* whether it is in the queue */
+};
+
 /**
    The extension class for the master of semi-synchronous replication
 */
@@ -372,13 +386,8 @@ class Repl_semi_sync_master
   /* True when init_object has been called */
   bool m_init_done;
 
-  /* This cond variable is signaled when enough binlog has been sent to slave,
-   * so that a waiting trx can return the 'ok' to the client for a commit.
-   */
-  mysql_cond_t  COND_binlog_send;
-
-  /* Mutex that protects the following state variables and the active
-   * transaction list.
+  /* Mutex that protects the following state variables, the active
+   * transaction list and the queue of waiting sessions.
    * Under no cirumstances we can acquire mysql_bin_log.LOCK_log if we are
    * already holding m_LOCK_binlog because it can cause deadlocks.
    */
@@ -393,19 +402,12 @@ class Repl_semi_sync_master
   /* The position in that file up to which we have the reply from any slaves. */
   my_off_t        m_reply_file_pos;
 
-  /* This is set to true when we know the 'smallest' wait position. */
-  bool            m_wait_file_name_inited;
-
-  /* NULL, or the 'smallest' filename that a transaction is waiting for
-   * slave replies.
+  /* The sessions waiting for slave replies, in binlog position order. The
+   * first one waits for the 'smallest' position: it can proceed and send an
+   * 'ok' to the client when the master has got the reply from the slave
+   * indicating that it already got the binlog events.
    */
-  char            m_wait_file_name[FN_REFLEN];
-
-  /* The smallest position in that file that a trx is waiting for: the trx
-   * can proceed and send an 'ok' to the client when the master has got the
-   * reply from the slave indicating that it already got the binlog events.
-   */
-  my_off_t        m_wait_file_pos;
+  Semisync_waiter *m_waiters_front, *m_waiters_rear;
 
   /* This is set to true when we know the 'largest' transaction commit
    * position in the binlog file.
@@ -433,8 +435,13 @@ class Repl_semi_sync_master
 
   void lock();
   void unlock();
-  void cond_broadcast();
-  int  cond_timewait(struct timespec *wait_time);
+
+  /* Queue a waiter in position order. */
+  void add_waiter(Semisync_waiter *waiter);
+  /* Remove a waiter from the queue without waking it up. */
+  void remove_waiter(Semisync_waiter *waiter);
+  /* Wake up the waiters up to the position, or all if log_file_name is NULL */
+  void wake_waiters(const char *log_file_name, my_off_t log_file_pos);
 
   /* Is semi-sync replication on? */
   bool is_on() {
@@ -500,9 +507,19 @@ class Repl_semi_sync_master
   /* Remove a semi-sync replication slave */
   void remove_slave();
 
-  /* It parses a reply packet and call report_reply_binlog to handle it. */
-  int report_reply_packet(uint32 server_id, const uchar *packet,
-                        ulong packet_len);
+  /* It parses a reply packet into the binlog position that it confirms.
+   *
+   * Input:
+   *  packet        - (IN)  the reply packet
+   *  packet_len    - (IN)  its length
+   *  log_file_name - (OUT) binlog file name, of at least FN_REFLEN bytes
+   *  log_file_pos  - (OUT) the offset in the binlog file
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  int read_reply_packet(const uchar *packet, ulong packet_len,
+                        char *log_file_name, my_off_t *log_file_pos);
 
   /* In semi-sync replication, reports up to which binlog position we have
    * received replies from the slave indicating that it already get the events.
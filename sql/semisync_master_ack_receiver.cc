@@ -216,6 +216,10 @@ void Ack_receiver::run()
     int ret;
     uint slave_count __attribute__((unused))= 0;
     Slave *slave;
+    /* The largest position replied by any slave in this round */
+    char ack_file_name[FN_REFLEN];
+    my_off_t ack_file_pos= 0;
+    uint32 ack_server_id= 0;
 
     mysql_mutex_lock(&m_mutex);
     if (unlikely(m_status == ST_STOPPING))
@@ -258,6 +262,7 @@ void Ack_receiver::run()
     }
 
     set_stage_info(stage_reading_semi_sync_ack);
+    ack_file_name[0]= 0;
     Slave_ilist_iterator it(m_slaves);
     while ((slave= it++))
     {
@@ -275,13 +280,34 @@ void Ack_receiver::run()
 
         len= my_net_read(&net);
         if (likely(len != packet_error))
-          repl_semisync_master.report_reply_packet(slave->server_id(),
-                                                   net.read_pos, len);
+        {
+          char log_file_name[FN_REFLEN];
+          my_off_t log_file_pos;
+          if (!repl_semisync_master.read_reply_packet(net.read_pos, len,
+                                                      log_file_name,
+                                                      &log_file_pos) &&
+              (!ack_file_name[0] ||
+               Active_tranx::compare(log_file_name, log_file_pos,
+                                     ack_file_name, ack_file_pos) > 0))
+          {
+            strmake_buf(ack_file_name, log_file_name);
+            ack_file_pos= log_file_pos;
+            ack_server_id= slave->server_id();
+          }
+        }
         else if (net.last_errno == ER_NET_READ_ERROR)
           listener.clear_socket_info(slave);
       }
     }
     mysql_mutex_unlock(&m_mutex);
+
+    /*
+      Report the replies of all slaves that were read together at once,
+      as any of them lets the transactions up to that position proceed.
+    */
+    if (ack_file_name[0])
+      repl_semisync_master.report_reply_binlog(ack_server_id, ack_file_name,
+                                               ack_file_pos);
   }
 end:
   sql_print_information("Stopping ack receiver thread");
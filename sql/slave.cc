@@ -171,7 +171,8 @@ static int safe_connect(THD* thd, MYSQL* mysql, Master_info* mi);
 static int safe_reconnect(THD*, MYSQL*, Master_info*, bool);
 static int connect_to_master(THD*, MYSQL*, Master_info*, bool, bool);
 static Log_event* next_event(rpl_group_info* rgi, ulonglong *event_size);
-static int queue_event(Master_info* mi,const char* buf,ulong event_len);
+static int queue_event(Master_info* mi,const char* buf,ulong event_len,
+                       bool in_payload= false);
 static int terminate_slave_thread(THD *, mysql_mutex_t *, mysql_cond_t *,
                                   volatile uint *, bool);
 static bool check_io_slave_killed(Master_info *mi, const char *info);
@@ -2329,8 +2330,11 @@ when it try to get the value of TIME_ZONE global variable from master.";
     int rc= DBUG_EVALUATE_IF("simulate_slave_capability_old_53",
         mysql_real_query(mysql, STRING_WITH_LEN("SET @mariadb_slave_capability="
                          STRINGIFY_ARG(MARIA_SLAVE_CAPABILITY_ANNOTATE))),
+      DBUG_EVALUATE_IF("simulate_slave_capability_gtid",
         mysql_real_query(mysql, STRING_WITH_LEN("SET @mariadb_slave_capability="
-                         STRINGIFY_ARG(MARIA_SLAVE_CAPABILITY_MINE))));
+                         STRINGIFY_ARG(MARIA_SLAVE_CAPABILITY_GTID))),
+        mysql_real_query(mysql, STRING_WITH_LEN("SET @mariadb_slave_capability="
+                         STRINGIFY_ARG(MARIA_SLAVE_CAPABILITY_MINE)))));
     if (unlikely(rc))
     {
       err_code= mysql_errno(mysql);
@@ -6114,6 +6118,66 @@ static int queue_old_event(Master_info *mi, const char *buf,
   }
 }
 
+/*
+  queue_transaction_payload()
+
+  Uncompresses a Transaction_payload_log_event and queues the events it
+  carries one by one, as if they had been received from the master, so the
+  relay log, the SQL thread and parallel replication never see the payload.
+
+  The events have no position of their own in the master's binlog, so
+  mi->master_log_pos stays at the start of the payload while they are
+  queued, and is moved past it at the end.
+*/
+
+static int queue_transaction_payload(Master_info *mi, const char *buf,
+                                     ulong event_len,
+                                     enum enum_binlog_checksum_alg checksum_alg)
+{
+  int error= 0;
+  char *events;
+  ulong events_len;
+  ulonglong inc_pos, event_pos;
+  DBUG_ENTER("queue_transaction_payload");
+
+  if (transaction_payload_uncompress(mi->rli.relay_log.
+                                     description_event_for_queue,
+                                     checksum_alg == BINLOG_CHECKSUM_ALG_CRC32,
+                                     buf, event_len, &events, &events_len))
+  {
+    char llbuf[22];
+    StringBuffer<1024> error_msg;
+    error_msg.append(STRING_WITH_LEN("binlog uncompress error, master log_pos: "));
+    llstr(mi->master_log_pos, llbuf);
+    error_msg.append(llbuf, strlen(llbuf));
+    mi->report(ERROR_LEVEL, ER_BINLOG_UNCOMPRESS_ERROR, NULL,
+               ER_DEFAULT(ER_BINLOG_UNCOMPRESS_ERROR), error_msg.ptr());
+    DBUG_RETURN(ER_BINLOG_UNCOMPRESS_ERROR);
+  }
+
+  for (const char *ev= events; !error && ev < events + events_len; )
+  {
+    ulong ev_len= uint4korr(ev + EVENT_LEN_OFFSET);
+    error= queue_event(mi, ev, ev_len, true);
+    ev+= ev_len;
+  }
+  my_free(events);
+
+  if (likely(!error))
+  {
+    mysql_mutex_lock(&mi->data_lock);
+    inc_pos= event_len;
+    /* Account for master-side filtering, as queue_event() does */
+    if ((event_pos= uint4korr(buf + LOG_POS_OFFSET)) >
+        mi->master_log_pos + inc_pos)
+      inc_pos= event_pos - mi->master_log_pos;
+    mi->master_log_pos+= inc_pos;
+    DBUG_PRINT("info", ("master_log_pos: %lu", (ulong) mi->master_log_pos));
+    mysql_mutex_unlock(&mi->data_lock);
+  }
+  DBUG_RETURN(error);
+}
+
 /*
   queue_event()
 
@@ -6122,9 +6186,13 @@ static int queue_old_event(Master_info *mi, const char *buf,
   no format conversion, it's pure read/write of bytes.
   So a 5.0.0 slave's relay log can contain events in the slave's format or in
   any >=5.0.0 format.
+
+  in_payload is set for the events of a Transaction_payload_log_event,
+  queued by queue_transaction_payload().
 */
 
-static int queue_event(Master_info* mi,const char* buf, ulong event_len)
+static int queue_event(Master_info* mi,const char* buf, ulong event_len,
+                       bool in_payload)
 {
   int error= 0;
   StringBuffer<1024> error_msg;
@@ -6209,6 +6277,9 @@ static int queue_event(Master_info* mi,const char* buf, ulong event_len)
       (uchar)buf[EVENT_TYPE_OFFSET] != FORMAT_DESCRIPTION_EVENT /* a way to escape */)
     DBUG_RETURN(queue_old_event(mi,buf,event_len));
 
+  if ((uchar)buf[EVENT_TYPE_OFFSET] == TRANSACTION_PAYLOAD_EVENT)
+    DBUG_RETURN(queue_transaction_payload(mi, buf, event_len, checksum_alg));
+
 #ifdef ENABLED_DEBUG_SYNC
   /*
     A (+d,dbug.rows_events_to_delay_relay_logging)-test is supposed to
@@ -6811,6 +6882,13 @@ static int queue_event(Master_info* mi,const char* buf, ulong event_len)
     break;
   }
 
+  /*
+    The events of a transaction payload take no room of their own in the
+    master's binlog, see queue_transaction_payload().
+  */
+  if (in_payload)
+    inc_pos= 0;
+
   /*
     Integrity of Rows- event group check.
     A sequence of Rows- events must end with STMT_END_F flagged one.
@@ -6961,7 +7039,27 @@ static int queue_event(Master_info* mi,const char* buf, ulong event_len)
   }
   else
   {
-    if (likely(!rli->relay_log.write_event_buffer((uchar*)buf, event_len)))
+    /*
+      With --slave-relay-log-bypass-size, hand the event to the SQL thread
+      in memory. Events that the SQL thread treats specially when reading
+      the relay log are always written.
+    */
+    if (opt_slave_relay_log_bypass_size &&
+        mi->using_gtid != Master_info::USE_GTID_NO &&
+        !mi->using_parallel() &&
+        (uchar)buf[EVENT_TYPE_OFFSET] != FORMAT_DESCRIPTION_EVENT &&
+        (uchar)buf[EVENT_TYPE_OFFSET] != ROTATE_EVENT &&
+        (uchar)buf[EVENT_TYPE_OFFSET] != STOP_EVENT &&
+        (uchar)buf[EVENT_TYPE_OFFSET] != START_ENCRYPTION_EVENT &&
+        !rli->queue_relay_event((uchar*)buf, event_len))
+    {
+      mi->master_log_pos+= inc_pos;
+      DBUG_PRINT("info", ("master_log_pos: %lu, event queued in memory",
+                          (ulong) mi->master_log_pos));
+      rli->relay_log.signal_relay_log_update();
+    }
+    else if (likely(!rli->relay_log.write_event_buffer((uchar*)buf,
+                                                       event_len)))
     {
       mi->master_log_pos+= inc_pos;
       DBUG_PRINT("info", ("master_log_pos: %lu", (ulong) mi->master_log_pos));
@@ -7468,6 +7566,31 @@ static Log_event* next_event(rpl_group_info *rgi, ulonglong *event_size)
                   my_b_tell(cur_log) == rli->event_relay_log_pos);
     }
 #endif
+    /*
+      Events the IO thread kept in memory (--slave-relay-log-bypass-size)
+      come before whatever was written to the relay log at the same
+      position. They do not advance the relay log position.
+    */
+    if (!rli->mi->using_parallel() &&
+        rli->relay_queue_last_seq > rli->relay_queue_read_seq)
+    {
+      if (!hot_log)
+        mysql_mutex_lock(log_lock);
+      if (rli->read_relay_queue(my_b_tell(cur_log), &ev, event_size, &errmsg))
+      {
+        mysql_mutex_unlock(log_lock);
+        goto err;
+      }
+      if (ev)
+      {
+        rli->future_event_relay_log_pos= rli->event_relay_log_pos;
+        mysql_mutex_unlock(log_lock);
+        rli->sql_thread_caught_up= false;
+        DBUG_RETURN(ev);
+      }
+      if (!hot_log)
+        mysql_mutex_unlock(log_lock);
+    }
     /*
       Relay log is always in new format - if the master is 3.23, the
       I/O thread will convert the format for us.
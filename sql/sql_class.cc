@@ -6882,6 +6882,8 @@ int THD::binlog_write_row(TABLE* table, bool is_trans,
   if (variables.option_bits & OPTION_GTID_BEGIN)
     is_trans= 1;
 
+  binlog_writeset_add_row(table, is_trans, record, false);
+
   Rows_log_event* ev;
   if (binlog_should_compress(len))
     ev =
@@ -6917,6 +6919,13 @@ int THD::binlog_update_row(TABLE* table, bool is_trans,
   */
   MY_BITMAP *old_read_set= table->read_set;
 
+  binlog_writeset_add_row(table, is_trans ||
+                          (variables.option_bits & OPTION_GTID_BEGIN),
+                          before_record, true);
+  binlog_writeset_add_row(table, is_trans ||
+                          (variables.option_bits & OPTION_GTID_BEGIN),
+                          after_record, true);
+
   /**
      This will remove spurious fields required during execution but
      not needed for binlogging. This is done according to the:
@@ -6996,6 +7005,10 @@ int THD::binlog_delete_row(TABLE* table, bool is_trans,
   */
   MY_BITMAP *old_read_set= table->read_set;
 
+  binlog_writeset_add_row(table, is_trans ||
+                          (variables.option_bits & OPTION_GTID_BEGIN),
+                          record, true);
+
   /** 
      This will remove spurious fields required during execution but
      not needed for binlogging. This is done according to the:
@@ -111,6 +111,9 @@ enum enum_slave_run_triggers_for_rbr { SLAVE_RUN_TRIGGERS_FOR_RBR_NO,
                                        SLAVE_RUN_TRIGGERS_FOR_RBR_ENFORCE};
 enum enum_slave_type_conversions { SLAVE_TYPE_CONVERSIONS_ALL_LOSSY,
                                    SLAVE_TYPE_CONVERSIONS_ALL_NON_LOSSY};
+enum enum_slave_rows_search_algorithms { SLAVE_ROWS_TABLE_SCAN,
+                                         SLAVE_ROWS_INDEX_SCAN,
+                                         SLAVE_ROWS_HASH_SCAN };
 
 /*
   MARK_COLUMNS_READ:  A column is goind to be read.
@@ -674,6 +677,7 @@ typedef struct system_variables
   */
   ulonglong slave_skip_counter;
   ulonglong max_relay_log_size;
+  ulonglong slave_parallel_weight;
 
   ha_rows select_limit;
   ha_rows max_join_size;
@@ -2847,6 +2851,8 @@ class THD: public THD_count, /* this must be first */
                         const uchar *buf);
   int binlog_update_row(TABLE* table, bool is_transactional,
                         const uchar *old_data, const uchar *new_data);
+  void binlog_writeset_add_row(TABLE *table, bool is_transactional,
+                               const uchar *record, bool read_only);
   bool prepare_handlers_for_update(uint flag);
   bool binlog_write_annotated_row(Log_event_writer *writer);
   void binlog_prepare_for_row_logging();
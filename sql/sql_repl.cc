@@ -30,6 +30,7 @@
 #include "debug_sync.h"
 #include "semisync_master.h"
 #include "semisync_slave.h"
+#include "gtid_index.h"
 #include "mysys_err.h"
 
 
@@ -42,6 +43,7 @@ enum enum_gtid_until_state {
 
 int max_binlog_dump_events = 0; // unlimited
 my_bool opt_sporadic_binlog_dump_fail = 0;
+ulong opt_binlog_dump_sendfile_min_size= 0;
 #ifndef DBUG_OFF
 static int binlog_dump_count = 0;
 #endif
@@ -161,6 +163,8 @@ struct binlog_send_info {
 
   bool clear_initial_log_pos;
   bool should_stop;
+  /** connection can take events with sendfile(), see send_event_from_file() */
+  bool sendfile_ok;
   size_t dirlen;
 
   binlog_send_info(THD *thd_arg, String *packet_arg, ushort flags_arg,
@@ -180,7 +184,8 @@ struct binlog_send_info {
       hb_info_counter(0),
 #endif
       clear_initial_log_pos(false),
-      should_stop(false)
+      should_stop(false),
+      sendfile_ok(false)
   {
     error_text[0] = 0;
     bzero(&error_gtid, sizeof(error_gtid));
@@ -1010,13 +1015,14 @@ get_binlog_list(MEM_ROOT *memroot, bool reverse= true,
   to start at the very first GTID in domain D.
 */
 static bool
-contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
+contains_all_slave_gtid(slave_connection_state *st, const rpl_gtid *list,
+                        uint32 count)
 {
   uint32 i;
 
-  for (i= 0; i < glev->count; ++i)
+  for (i= 0; i < count; ++i)
   {
-    uint32 gl_domain_id= glev->list[i].domain_id;
+    uint32 gl_domain_id= list[i].domain_id;
     const rpl_gtid *gtid= st->find(gl_domain_id);
     if (!gtid)
     {
@@ -1026,15 +1032,15 @@ contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
       */
       return false;
     }
-    if (gtid->server_id == glev->list[i].server_id &&
-        gtid->seq_no <= glev->list[i].seq_no)
+    if (gtid->server_id == list[i].server_id &&
+        gtid->seq_no <= list[i].seq_no)
     {
       /*
         The slave needs to start after gtid, but it is contained in an earlier
         binlog file. So we need to search back further, unless it was the very
         last gtid logged for the domain in earlier binlog files.
       */
-      if (gtid->seq_no < glev->list[i].seq_no)
+      if (gtid->seq_no < list[i].seq_no)
         return false;
 
       /*
@@ -1047,7 +1053,7 @@ contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
         beginning of this group, per the special case explained in comment at
         the start of this function. If not, then we need to search back further.
       */
-      if (i+1 < glev->count && gl_domain_id == glev->list[i+1].domain_id)
+      if (i+1 < count && gl_domain_id == list[i+1].domain_id)
         return false;
     }
   }
@@ -1056,6 +1062,68 @@ contains_all_slave_gtid(slave_connection_state *st, Gtid_list_log_event *glev)
 }
 
 
+/*
+  Adjust the slave connection state for starting at a position in the binlog
+  where the GTID state is list, after contains_all_slave_gtid() returned true
+  for it.
+
+  As a special case, we allow to start from binlog file N if the
+  requested GTID is the last event (in the corresponding domain) in
+  binlog file (N-1), but then we need to remove that GTID from the slave
+  state, rather than skipping events waiting for it to turn up.
+
+  If slave is doing START SLAVE UNTIL, check for any UNTIL conditions
+  that are already included in a previous binlog file. Delete any such
+  from the UNTIL hash, to mark that such domains have already reached
+  their UNTIL condition.
+*/
+static void
+gtid_start_at_state(slave_connection_state *state, const rpl_gtid *list,
+                    uint32 count, slave_connection_state *until_gtid_state)
+{
+  uint32 i;
+
+  for (i= 0; i < count; ++i)
+  {
+    const rpl_gtid *gtid= state->find(list[i].domain_id);
+    if (!gtid)
+    {
+      /*
+        Contains_all_slave_gtid() returns false if there is any domain in
+        Gtid_list_event which is not in the requested slave position.
+
+        We may delete a domain from the slave state inside this loop, but
+        we only do this when it is the very last GTID logged for that
+        domain in earlier binlogs, and then we can not encounter it in any
+        further GTIDs in the Gtid_list.
+      */
+      DBUG_ASSERT(0);
+    } else if (gtid->server_id == list[i].server_id &&
+               gtid->seq_no == list[i].seq_no)
+    {
+      /*
+        The slave requested to start from the very beginning of this
+        domain in this binlog file. So delete the entry from the state,
+        we do not need to skip anything.
+      */
+      state->remove(gtid);
+    }
+
+    if (until_gtid_state &&
+        (gtid= until_gtid_state->find(list[i].domain_id)) &&
+        gtid->server_id == list[i].server_id &&
+        gtid->seq_no <= list[i].seq_no)
+    {
+      /*
+        We've already reached the stop position in UNTIL for this domain,
+        since it is before the start position.
+      */
+      until_gtid_state->remove(gtid);
+    }
+  }
+}
+
+
 static void
 give_error_start_pos_missing_in_binlog(int *err, const char **errormsg,
                                        rpl_gtid *error_gtid)
@@ -1273,11 +1341,67 @@ check_slave_start_position(binlog_send_info *info, const char **errormsg,
   return err;
 }
 
+/*
+  Use the GTID index of a binlog file (see gtid_index.h) to find the last
+  offset before which the slave has already received every event group.
+
+  @param name           the binlog file, whose Gtid_list_log_event already
+                        satisfied contains_all_slave_gtid()
+  @param state          the GTID position requested by the slave
+  @param[out] out_pos   the offset to start reading at
+  @param[out] out_count the number of GTIDs in the returned state
+
+  @return the binlog GTID state at out_pos, to be freed with my_free(), or
+          NULL if the file must be read from the start.
+*/
+static rpl_gtid *
+gtid_index_find_pos(const char *name, slave_connection_state *state,
+                    my_off_t *out_pos, uint32 *out_count)
+{
+  Gtid_index_reader reader;
+  rpl_gtid *found= NULL, *list;
+  my_off_t offset;
+  uint32 count;
+
+  if (!opt_binlog_gtid_index)
+    return NULL;
+  if (reader.open(name))
+  {
+    statistic_increment(binlog_gtid_index_miss, &LOCK_status);
+    return NULL;
+  }
+
+  /*
+    The binlog state only grows through the file, so once an entry contains
+    a GTID that the slave still needs, so do all later entries.
+  */
+  while (!reader.read_entry(&offset, &list, &count))
+  {
+    if (!contains_all_slave_gtid(state, list, count))
+    {
+      my_free(list);
+      break;
+    }
+    my_free(found);
+    found= list;
+    *out_pos= offset;
+    *out_count= count;
+  }
+  if (found)
+    statistic_increment(binlog_gtid_index_hit, &LOCK_status);
+  else
+    statistic_increment(binlog_gtid_index_miss, &LOCK_status);
+  return found;
+}
+
+
 /*
   Find the name of the binlog file to start reading for a slave that connects
   using GTID state.
 
-  Returns the file name in out_name, which must be of size at least FN_REFLEN.
+  Returns the file name in out_name, which must be of size at least FN_REFLEN,
+  and the offset to start reading at in out_pos. The offset is the start of
+  the file unless its GTID index allows to skip a part of it.
 
   Returns NULL on ok, error message on error.
 
@@ -1302,7 +1426,9 @@ check_slave_start_position(binlog_send_info *info, const char **errormsg,
 */
 static const char *
 gtid_find_binlog_file(slave_connection_state *state, char *out_name,
-                      slave_connection_state *until_gtid_state)
+                      my_off_t *out_pos,
+                      slave_connection_state *until_gtid_state,
+                      rpl_binlog_state *until_binlog_state)
 {
   MEM_ROOT memroot;
   binlog_file_entry *list;
@@ -1353,62 +1479,35 @@ gtid_find_binlog_file(slave_connection_state *state, char *out_name,
     if (unlikely(errormsg))
       goto end;
 
-    if (!glev || contains_all_slave_gtid(state, glev))
+    if (!glev || contains_all_slave_gtid(state, glev->list, glev->count))
     {
       strmake(out_name, buf, FN_REFLEN);
+      *out_pos= BIN_LOG_HEADER_SIZE;
 
       if (glev)
       {
-        uint32 i;
-
-        /*
-          As a special case, we allow to start from binlog file N if the
-          requested GTID is the last event (in the corresponding domain) in
-          binlog file (N-1), but then we need to remove that GTID from the slave
-          state, rather than skipping events waiting for it to turn up.
-
-          If slave is doing START SLAVE UNTIL, check for any UNTIL conditions
-          that are already included in a previous binlog file. Delete any such
-          from the UNTIL hash, to mark that such domains have already reached
-          their UNTIL condition.
-        */
-        for (i= 0; i < glev->count; ++i)
+        my_off_t index_pos;
+        uint32 index_count;
+        rpl_gtid *index_list= gtid_index_find_pos(buf, state, &index_pos,
+                                                  &index_count);
+        if (!index_list)
+          gtid_start_at_state(state, glev->list, glev->count,
+                              until_gtid_state);
+        else
         {
-          const rpl_gtid *gtid= state->find(glev->list[i].domain_id);
-          if (!gtid)
-          {
-            /*
-              Contains_all_slave_gtid() returns false if there is any domain in
-              Gtid_list_event which is not in the requested slave position.
-
-              We may delete a domain from the slave state inside this loop, but
-              we only do this when it is the very last GTID logged for that
-              domain in earlier binlogs, and then we can not encounter it in any
-              further GTIDs in the Gtid_list.
-            */
-            DBUG_ASSERT(0);
-          } else if (gtid->server_id == glev->list[i].server_id &&
-                     gtid->seq_no == glev->list[i].seq_no)
-          {
-            /*
-              The slave requested to start from the very beginning of this
-              domain in this binlog file. So delete the entry from the state,
-              we do not need to skip anything.
-            */
-            state->remove(gtid);
-          }
-
+          gtid_start_at_state(state, index_list, index_count,
+                              until_gtid_state);
+          /*
+            The Gtid_list_log_event at the start of the file will not be
+            read, so initialise the state for START SLAVE UNTIL from the
+            index instead.
+          */
           if (until_gtid_state &&
-              (gtid= until_gtid_state->find(glev->list[i].domain_id)) &&
-              gtid->server_id == glev->list[i].server_id &&
-              gtid->seq_no <= glev->list[i].seq_no)
-          {
-            /*
-              We've already reached the stop position in UNTIL for this domain,
-              since it is before the start position.
-            */
-            until_gtid_state->remove(gtid);
-          }
+              until_binlog_state->load(index_list, index_count))
+            errormsg= "Out of memory while looking for GTID position in "
+              "binlog";
+          *out_pos= index_pos;
+          my_free(index_list);
         }
       }
 
@@ -1707,6 +1806,71 @@ is_until_reached(binlog_send_info *info, ulong *ev_offset,
 }
 
 
+/*
+  Send the events carried by a Transaction_payload_log_event one by one, to
+  a slave that does not understand the payload event.
+
+  The events have the end_log_pos of the payload, but take more room than
+  it, so the slave would count its position in our binlog past the end of
+  the payload. A fake Rotate event to the end of the payload sets the
+  position right again; the SQL thread ignores it inside an event group.
+
+  Returns NULL on success, error message string on error.
+*/
+static const char *
+send_transaction_payload_events(binlog_send_info *info, IO_CACHE *log,
+                                ulong ev_offset)
+{
+  String *const packet= info->packet;
+  const char *errmsg= NULL;
+  char *events;
+  ulong events_len;
+
+  if (transaction_payload_uncompress(info->fdev,
+                                     info->current_checksum_alg ==
+                                     BINLOG_CHECKSUM_ALG_CRC32,
+                                     packet->ptr() + ev_offset,
+                                     packet->length() - ev_offset,
+                                     &events, &events_len))
+  {
+    info->error= ER_MASTER_FATAL_ERROR_READING_BINLOG;
+    return "Failed to uncompress a transaction payload event";
+  }
+
+  for (const char *ev= events; ev < events + events_len; )
+  {
+    ulong ev_len= uint4korr(ev + EVENT_LEN_OFFSET);
+    ulong offset;
+
+    if (reset_transmit_packet(info, info->flags, &offset, &errmsg))
+      break;
+    if (packet->append(ev, ev_len))
+    {
+      info->error= ER_OUTOFMEMORY;
+      errmsg= "Failed due to out-of-memory expanding a transaction payload";
+      break;
+    }
+    if (my_net_write(info->net, (uchar*) packet->ptr(), packet->length()))
+    {
+      info->error= ER_UNKNOWN_ERROR;
+      errmsg= "Failed on my_net_write()";
+      break;
+    }
+    ev+= ev_len;
+  }
+  my_free(events);
+
+  if (!errmsg &&
+      fake_rotate_event(info, my_b_tell(log), &errmsg,
+                        info->current_checksum_alg))
+  {
+    if (!errmsg)
+      errmsg= info->errmsg;
+  }
+  return errmsg;
+}
+
+
 /*
   Helper function for mysql_binlog_send() to write an event down the slave
   connection.
@@ -2031,6 +2195,10 @@ send_event_to_slave(binlog_send_info *info, Log_event_type event_type,
 
   THD_STAGE_INFO(info->thd, stage_sending_binlog_event_to_slave);
 
+  if (unlikely(event_type == TRANSACTION_PAYLOAD_EVENT) &&
+      mariadb_slave_capability < MARIA_SLAVE_CAPABILITY_TRANSACTION_PAYLOAD)
+    return send_transaction_payload_events(info, log, ev_offset);
+
   pos= my_b_tell(log);
   if (repl_semisync_master.update_sync_header(info->thd,
                                               (uchar*) packet->c_ptr_safe(),
@@ -2147,6 +2315,18 @@ static int init_binlog_sender(binlog_send_info *info,
       info->dbug_reconnect_counter= 22;
     });
 
+#ifdef HAVE_SENDFILE
+  /*
+    Events can only go from the binlog file to the socket unchanged when
+    nothing sits between the packet layer and the socket, and the slave
+    does not need GTID events rewritten.
+  */
+  info->sendfile_ok= !info->net->compress &&
+    (vio_type(info->net->vio) == VIO_TYPE_TCPIP ||
+     vio_type(info->net->vio) == VIO_TYPE_SOCKET) &&
+    info->mariadb_slave_capability >= MARIA_SLAVE_CAPABILITY_GTID;
+#endif
+
   if (global_system_variables.log_warnings > 1)
   {
     sql_print_information(
@@ -2200,15 +2380,13 @@ static int init_binlog_sender(binlog_send_info *info,
       return 1;
     }
     if ((info->errmsg= gtid_find_binlog_file(&info->gtid_state,
-                                             search_file_name,
-                                             info->until_gtid_state)))
+                                             search_file_name, pos,
+                                             info->until_gtid_state,
+                                             &info->until_binlog_state)))
     {
       info->error= ER_MASTER_FATAL_ERROR_READING_BINLOG;
       return 1;
     }
-
-    /* start from beginning of binlog file */
-    *pos = 4;
   }
   else
   {
@@ -2667,6 +2845,90 @@ static my_off_t get_binlog_end_pos(binlog_send_info *info,
  * return 0 - OK
  *        else NOK
  */
+#ifdef HAVE_SENDFILE
+/*
+  Helper function for send_events(): send the event at the current position
+  of log with sendfile() straight from the binlog file, without reading it
+  into the packet buffer.
+
+  This is only done for big events that send_event_to_slave() would send
+  unchanged, see @@binlog_dump_sendfile_min_size. The rest of the event
+  header is checked here, so an event that needs any rewriting or skipping
+  goes the normal way.
+
+  Returns 0 if the event was sent, -1 if the event must be sent the normal
+  way (log is then left at the start of the event), 1 on error.
+*/
+static int send_event_from_file(binlog_send_info *info, IO_CACHE *log,
+                                my_off_t end_pos)
+{
+  THD *thd= info->thd;
+  ulong min_size= opt_binlog_dump_sendfile_min_size;
+  uchar head[1 + LOG_EVENT_MINIMAL_HEADER_LEN];
+  uchar *header= head + 1;
+  my_off_t event_pos= my_b_tell(log);
+  ulong event_len;
+  Log_event_type event_type;
+
+  if (!min_size || !info->sendfile_ok || thd->semi_sync_slave ||
+      opt_master_verify_checksum || info->fdev->crypto_data.scheme ||
+      info->gtid_skip_group != GTID_SKIP_NOT || info->until_gtid_state ||
+      info->send_fake_gtid_list ||
+      event_pos + LOG_EVENT_MINIMAL_HEADER_LEN > end_pos)
+    return -1;
+#ifndef DBUG_OFF
+  if (info->dbug_reconnect_counter > 0)
+    return -1;
+#endif
+
+  if (my_b_read(log, header, LOG_EVENT_MINIMAL_HEADER_LEN))
+  {
+    /* Let the normal path report the read error */
+    my_b_seek(log, event_pos);
+    return -1;
+  }
+
+  event_len= uint4korr(header + EVENT_LEN_OFFSET);
+  event_type= (Log_event_type) header[EVENT_TYPE_OFFSET];
+  if (event_len < MY_MAX(min_size, LOG_EVENT_MINIMAL_HEADER_LEN + 1) ||
+      event_len + 1 >= MAX_PACKET_LENGTH ||
+      event_len > MY_MAX(thd->variables.max_allowed_packet,
+                         opt_binlog_rows_event_max_size +
+                         MAX_LOG_EVENT_HEADER) ||
+      event_pos + event_len > end_pos ||
+      !(LOG_EVENT_IS_WRITE_ROW(event_type) ||
+        LOG_EVENT_IS_UPDATE_ROW(event_type) ||
+        LOG_EVENT_IS_DELETE_ROW(event_type) ||
+        event_type == QUERY_EVENT || event_type == QUERY_COMPRESSED_EVENT ||
+        event_type == TRANSACTION_PAYLOAD_EVENT ||
+        event_type == APPEND_BLOCK_EVENT ||
+        event_type == BEGIN_LOAD_QUERY_EVENT) ||
+      ((thd->variables.option_bits & OPTION_SKIP_REPLICATION) &&
+       (uint2korr(header + FLAGS_OFFSET) & LOG_EVENT_SKIP_REPLICATION_F)))
+  {
+    my_b_seek(log, event_pos);
+    return -1;
+  }
+
+  THD_STAGE_INFO(thd, stage_sending_binlog_event_to_slave);
+
+  /* The OK byte and the event header, then the event body from the file */
+  head[0]= 0;
+  if (net_write_packet_from_file(info->net, head, sizeof(head),
+                                 log->file,
+                                 event_pos + LOG_EVENT_MINIMAL_HEADER_LEN,
+                                 event_len - LOG_EVENT_MINIMAL_HEADER_LEN))
+  {
+    info->error= ER_UNKNOWN_ERROR;
+    info->errmsg= "Failed on net_write_packet_from_file()";
+    return 1;
+  }
+  my_b_seek(log, event_pos + event_len);
+  return 0;
+}
+#endif /* HAVE_SENDFILE */
+
+
 static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
                        my_off_t end_pos)
 {
@@ -2683,6 +2945,17 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
     if (should_stop(info))
       return 0;
 
+#ifdef HAVE_SENDFILE
+    info->last_pos= linfo->pos;
+    if ((error= send_event_from_file(info, log, end_pos)) >= 0)
+    {
+      if (error)
+        return 1;
+      linfo->pos= my_b_tell(log);
+      continue;
+    }
+#endif
+
     /* reset the transmit packet for the event read from binary log
        file */
     if (reset_transmit_packet(info, info->flags, &ev_offset, &info->errmsg))
@@ -3260,6 +3533,19 @@ int start_slave(THD* thd , Master_info* mi,  bool net_report)
                      Sql_condition::WARN_LEVEL_NOTE, ER_UNTIL_COND_IGNORED,
                      ER_THD(thd, ER_UNTIL_COND_IGNORED));
 
+      /*
+        Events that the IO thread kept in memory for a serial SQL thread
+        (--slave-relay-log-bypass-size) do not advance the relay log
+        position, so the parallel applier could not retry or resume them.
+        They are discarded with the relay logs when both threads start
+        together, see start_slave_threads().
+      */
+      if (!slave_errno && (thread_mask & SLAVE_SQL) && mi->using_parallel() &&
+          (mi->slave_running ||
+           mi->using_gtid == Master_info::USE_GTID_NO) &&
+          mi->rli.relay_queue_last_seq > mi->rli.group_relay_queue_seq)
+        slave_errno= ER_SLAVE_RELAY_QUEUE_NOT_EMPTY;
+
       if (!slave_errno)
         slave_errno = start_slave_threads(thd,
                                           1,
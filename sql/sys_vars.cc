@@ -62,6 +62,8 @@
 #include "sql_repl.h"
 #include "opt_range.h"
 #include "rpl_parallel.h"
+#include "rpl_writeset.h"
+#include "gtid_index.h"
 #include "semisync_master.h"
 #include "semisync_slave.h"
 #include <ssl_compat.h>
@@ -1454,6 +1456,17 @@ Sys_log_bin_compress_min_len(
   GLOBAL_VAR(opt_bin_log_compress_min_len),
   CMD_LINE(OPT_ARG), VALID_RANGE(10, 1024), DEFAULT(256), BLOCK_SIZE(1));
 
+static Sys_var_on_access_global<Sys_var_mybool,
+                    PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS_TRANSACTIONS>
+Sys_log_bin_compress_transactions(
+  "log_bin_compress_transactions",
+  "Compress all events of a transaction together into one "
+  "Transaction_payload event in the binary log. Only transactions that "
+  "fit in binlog_cache_size are compressed. Slaves that do not understand "
+  "the event receive the events it carries uncompressed",
+  GLOBAL_VAR(opt_bin_log_compress_transactions), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE));
+
 static Sys_var_on_access_global<Sys_var_mybool,
                     PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_TRUST_FUNCTION_CREATORS>
 Sys_trust_function_creators(
@@ -2271,6 +2284,18 @@ Sys_slave_parallel_max_queued(
        GLOBAL_VAR(opt_slave_parallel_max_queued), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0,2147483647), DEFAULT(131072), BLOCK_SIZE(1));
 
+static Sys_var_on_access_global<Sys_var_ulong,
+                     PRIV_SET_SYSTEM_GLOBAL_VAR_SLAVE_RELAY_LOG_BYPASS_SIZE>
+Sys_slave_relay_log_bypass_size(
+       "slave_relay_log_bypass_size",
+       "Limit on how much memory the IO thread may use to pass events "
+       "directly to the SQL thread without writing them to the relay log. "
+       "Events are kept in memory until their transaction is committed. "
+       "Only used with GTID replication when --slave-parallel-threads=0. "
+       "0 disables the bypass.",
+       GLOBAL_VAR(opt_slave_relay_log_bypass_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0,2147483647), DEFAULT(0), BLOCK_SIZE(1));
+
 
 bool
 Sys_var_slave_parallel_mode::global_update(THD *thd, set_var *var)
@@ -2447,6 +2472,57 @@ Sys_binlog_commit_wait_usec(
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
 
+static Sys_var_on_access_global<Sys_var_mybool,
+                                PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_GTID_INDEX>
+Sys_binlog_gtid_index(
+       "binlog_gtid_index",
+       "Write a sparse GTID index next to each binlog file, and use it to "
+       "find the position of a slave that connects with a GTID position "
+       "without reading the binlog file from its start. A change takes "
+       "effect for writing at the next binlog rotation.",
+       GLOBAL_VAR(opt_binlog_gtid_index), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
+
+
+static Sys_var_on_access_global<Sys_var_ulong,
+                                PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_GTID_INDEX>
+Sys_binlog_gtid_index_span_min(
+       "binlog_gtid_index_span_min",
+       "Minimum number of bytes of the binlog between two entries of the "
+       "GTID index. Smaller values make the index larger, and make slaves "
+       "skip fewer events before their GTID position after connecting.",
+       GLOBAL_VAR(opt_binlog_gtid_index_span_min), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 1024*1024*1024), DEFAULT(65536), BLOCK_SIZE(1));
+
+
+static const char *binlog_transaction_dependency_tracking_names[]=
+  {"COMMIT_ORDER", "WRITESET", NullS};
+static Sys_var_on_access_global<Sys_var_enum,
+                  PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_DEPENDENCY>
+Sys_binlog_transaction_dependency_tracking(
+       "binlog_transaction_dependency_tracking",
+       "How the commit_id that lets a slave in "
+       "--slave-parallel-mode=conservative apply transactions in parallel is "
+       "chosen. COMMIT_ORDER: transactions that were committed in the same "
+       "binlog group commit. WRITESET: additionally, transactions of later "
+       "group commits that do not modify any primary or unique key value "
+       "that was modified by an earlier transaction with the same commit_id.",
+       GLOBAL_VAR(opt_binlog_transaction_dependency_tracking),
+       CMD_LINE(REQUIRED_ARG), binlog_transaction_dependency_tracking_names,
+       DEFAULT(BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER));
+
+
+static Sys_var_on_access_global<Sys_var_ulong,
+                  PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_DEPENDENCY>
+Sys_binlog_transaction_dependency_history_size(
+       "binlog_transaction_dependency_history_size",
+       "Maximum number of key hashes that are remembered for "
+       "binlog_transaction_dependency_tracking=WRITESET. When the limit is "
+       "reached, the next transaction starts a new commit_id.",
+       GLOBAL_VAR(opt_binlog_transaction_dependency_history_size),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 1000000), DEFAULT(25000),
+       BLOCK_SIZE(1));
+
+
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
   SV *sv= type == OPT_GLOBAL ? &global_system_variables : &thd->variables;
@@ -3341,6 +3417,35 @@ Slave_type_conversions(
        slave_type_conversions_name,
        DEFAULT(0));
 
+static const char *slave_rows_search_algorithms_names[]=
+  {"TABLE_SCAN", "INDEX_SCAN", "HASH_SCAN", 0};
+static Sys_var_on_access_global<Sys_var_set,
+                 PRIV_SET_SYSTEM_GLOBAL_VAR_SLAVE_ROWS_SEARCH_ALGORITHMS>
+Slave_rows_search_algorithms(
+       "slave_rows_search_algorithms",
+       "How the slave locates the rows of row-based UPDATE and DELETE events. "
+       "INDEX_SCAN: look each row up in the primary key or the best index. "
+       "HASH_SCAN: when no index is used, match all rows of an event against "
+       "the table in a single table scan. A table scan for each row "
+       "(TABLE_SCAN) is used when neither applies",
+       GLOBAL_VAR(slave_rows_search_algorithms_options), CMD_LINE(REQUIRED_ARG),
+       slave_rows_search_algorithms_names,
+       DEFAULT((1ULL << SLAVE_ROWS_TABLE_SCAN) |
+               (1ULL << SLAVE_ROWS_INDEX_SCAN)));
+
+static Sys_var_on_access_global<Sys_var_mybool,
+                 PRIV_SET_SYSTEM_GLOBAL_VAR_SLAVE_ROWS_PREFETCH>
+Sys_slave_rows_prefetch(
+       "slave_rows_prefetch",
+       "Before applying a row-based UPDATE or DELETE event that locates its "
+       "rows through an index, read all of them in key order with one "
+       "multi-range read, so that the rows are then found in the buffer "
+       "pool instead of being read from disk one by one. The multi-range "
+       "read uses the disk-sweep implementation if optimizer_switch has "
+       "mrr=on",
+       GLOBAL_VAR(opt_slave_rows_prefetch), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 static Sys_var_on_access_global<Sys_var_mybool,
                            PRIV_SET_SYSTEM_GLOBAL_VAR_SLAVE_SQL_VERIFY_CHECKSUM>
 Sys_slave_sql_verify_checksum(
@@ -3361,6 +3466,19 @@ Sys_master_verify_checksum(
        GLOBAL_VAR(opt_master_verify_checksum), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_on_access_global<Sys_var_ulong,
+                    PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_DUMP_SENDFILE_MIN_SIZE>
+Sys_binlog_dump_sendfile_min_size(
+       "binlog_dump_sendfile_min_size",
+       "Events of at least this many bytes are sent to slaves with "
+       "sendfile() straight from the binary log file, instead of being "
+       "copied through a buffer. Only used for slaves that get the events "
+       "unchanged: not over SSL, compressed protocol or semi-sync, and not "
+       "with an encrypted binary log or master_verify_checksum. "
+       "0 disables it. Ignored where sendfile() is not available",
+       GLOBAL_VAR(opt_binlog_dump_sendfile_min_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, MAX_PACKET_LENGTH), DEFAULT(0), BLOCK_SIZE(1));
+
 /* These names must match RPL_SKIP_XXX #defines in slave.h. */
 static const char *replicate_events_marked_for_skip_names[]= {
   "REPLICATE", "FILTER_ON_SLAVE", "FILTER_ON_MASTER", 0
@@ -5534,6 +5652,23 @@ static Sys_var_multi_source_ulonglong Sys_max_relay_log_size(
        VALID_RANGE(0, 1024L*1024*1024), DEFAULT(0), BLOCK_SIZE(IO_SIZE),
        ON_UPDATE(update_max_relay_log_size));
 
+static bool update_slave_parallel_weight(sys_var *self, THD *thd,
+                                         Master_info *mi)
+{
+  mi->parallel_weight= thd->variables.slave_parallel_weight;
+  return false;
+}
+
+static Sys_var_multi_source_ulonglong Sys_slave_parallel_weight(
+       "slave_parallel_weight",
+       "When several master connections wait for a parallel replication "
+       "worker thread, the free threads are shared between them in "
+       "proportion to this value",
+       SESSION_VAR(slave_parallel_weight), CMD_LINE(REQUIRED_ARG),
+       MASTER_INFO_VAR(parallel_weight),
+       VALID_RANGE(1, 1000), DEFAULT(1), BLOCK_SIZE(1),
+       ON_UPDATE(update_slave_parallel_weight));
+
 static Sys_var_charptr Sys_slave_skip_errors(
        "slave_skip_errors", "Tells the slave thread to continue "
        "replication when a query event returns an error from the "
@@ -1391,6 +1391,7 @@ btr_cur_search_to_nth_level_func(
 
 	cursor->flag = BTR_CUR_BINARY;
 	cursor->index = index;
+	cursor->parent_page_no = FIL_NULL;
 
 #ifndef BTR_CUR_ADAPT
 	guess = NULL;
@@ -2029,6 +2030,10 @@ btr_cur_search_to_nth_level_func(
 		const rec_t*	node_ptr;
 		ut_ad(height > 0);
 
+		if (height == 1) {
+			cursor->parent_page_no = block->page.id().page_no();
+		}
+
 		height--;
 		guess = NULL;
 
@@ -2609,6 +2614,7 @@ btr_cur_open_at_index_side(
 
 	page_cursor = btr_cur_get_page_cur(cursor);
 	cursor->index = index;
+	cursor->parent_page_no = FIL_NULL;
 
 	page_id_t		page_id(index->table->space_id, index->page);
 	const ulint		zip_size = index->table->space->zip_size();
@@ -2769,6 +2775,10 @@ btr_cur_open_at_index_side(
 			btr_cur_add_path_info(cursor, height, root_height);
 		}
 
+		if (height == 1) {
+			cursor->parent_page_no = block->page.id().page_no();
+		}
+
 		height--;
 
 		node_ptr = page_cur_get_rec(page_cursor);
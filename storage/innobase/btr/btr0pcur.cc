@@ -28,6 +28,8 @@ Created 2/23/1996 Heikki Tuuri
 #include "ut0byte.h"
 #include "rem0cmp.h"
 #include "trx0trx.h"
+#include "buf0rea.h"
+#include "srv0srv.h"
 
 /**************************************************************//**
 Allocates memory for a persistent cursor object and initializes the cursor.
@@ -460,6 +462,88 @@ btr_pcur_restore_position(
 	return(FALSE);
 }
 
+/** Issue asynchronous reads for the leaf pages that follow the current
+page of a persistent cursor in key order. The child page numbers are read
+from the level 1 page through which the cursor was positioned and from
+its successor. Because the cursor is holding a leaf page latch, the
+parent pages are only latched if that is possible without waiting.
+@param cursor  persistent cursor on a leaf page
+@param n       maximum number of pages to read */
+static void btr_pcur_read_ahead(btr_pcur_t *cursor, ulint n)
+{
+  btr_cur_t *btr_cur= btr_pcur_get_btr_cur(cursor);
+  const dict_index_t *index= btr_cur->index;
+  const buf_block_t *block= btr_pcur_get_block(cursor);
+  const page_id_t id{block->page.id()};
+  const ulint zip_size= block->zip_size();
+  uint32_t pages[BTR_PCUR_READ_AHEAD_MAX];
+  ulint n_pages= 0;
+  bool found= false;
+  mem_heap_t *heap= nullptr;
+  rec_offs offsets_[REC_OFFS_NORMAL_SIZE];
+  rec_offs *offsets= offsets_;
+  rec_offs_init(offsets_);
+
+  ut_ad(n <= BTR_PCUR_READ_AHEAD_MAX);
+
+  /* The current page is normally found in the remembered parent page,
+  or in its successor if the scan has already moved past the last child
+  of the remembered parent page. */
+  for (uint32_t parent= btr_cur->parent_page_no, hops= 0;
+       parent != FIL_NULL && hops < 3 && n_pages < n; hops++)
+  {
+    mtr_t mtr;
+    mtr.start();
+    buf_block_t *p= buf_page_get_gen(page_id_t(id.space(), parent), zip_size,
+                                     RW_NO_LATCH, nullptr, BUF_GET_IF_IN_POOL,
+                                     &mtr);
+    if (!p || !p->lock.s_lock_try())
+    {
+      mtr.commit();
+      break;
+    }
+
+    const page_t *page= p->frame;
+    parent= FIL_NULL;
+
+    if (fil_page_index_page_check(page) &&
+        btr_page_get_index_id(page) == index->id &&
+        btr_page_get_level(page) == 1)
+    {
+      for (const rec_t *rec= page_rec_get_next_const(page_get_infimum_rec(page));
+           rec && !page_rec_is_supremum(rec) && n_pages < n;
+           rec= page_rec_get_next_const(rec))
+      {
+        offsets= rec_get_offsets(rec, index, offsets, 0, ULINT_UNDEFINED,
+                                 &heap);
+        const uint32_t child= btr_node_ptr_get_child_page_no(rec, offsets);
+        if (found)
+          pages[n_pages++]= child;
+        else if (child == id.page_no())
+        {
+          found= true;
+          btr_cur->parent_page_no= p->page.id().page_no();
+        }
+      }
+
+      parent= btr_page_get_next(page);
+    }
+
+    p->lock.s_unlock();
+    mtr.commit();
+  }
+
+  if (UNIV_LIKELY_NULL(heap))
+    mem_heap_free(heap);
+
+  if (!found)
+    /* The tree was reorganized. Do not look for the parent again until
+    the cursor is repositioned from the root page. */
+    btr_cur->parent_page_no= FIL_NULL;
+
+  buf_read_ahead_logical(id.space(), pages, n_pages, zip_size);
+}
+
 /*********************************************************//**
 Moves the persistent cursor to the first record on the next page. Releases the
 latch on the current page, and bufferunfixes it. Note that there must not be
@@ -497,6 +581,17 @@ btr_pcur_move_to_next_page(
 		mode = BTR_MODIFY_LEAF;
 	}
 
+	if (srv_logical_read_ahead && mode == BTR_SEARCH_LEAF
+	    && page_is_leaf(page)
+	    && !btr_pcur_get_btr_cur(cursor)->index->is_spatial()
+	    && !btr_pcur_get_btr_cur(cursor)->index->is_ibuf()
+	    && btr_pcur_get_btr_cur(cursor)->parent_page_no != FIL_NULL
+	    && !buf_pool.page_hash_contains(
+		    page_id_t(btr_pcur_get_block(cursor)->page.id().space(),
+			      next_page_no))) {
+		btr_pcur_read_ahead(cursor, srv_logical_read_ahead);
+	}
+
 	buf_block_t* next_block = btr_block_get(
 		*btr_pcur_get_btr_cur(cursor)->index, next_page_no, mode,
 		page_is_leaf(page), mtr);
@@ -381,6 +381,21 @@ static bool buf_tmp_page_decrypt(byte* tmp_frame, byte* src_frame)
 	return true; /* page was decrypted */
 }
 
+/** The task group that compresses page_compressed pages for writing and
+decompresses them after reading, limited to innodb_page_compression_threads */
+tpool::task_group buf_page_compression_group;
+
+/** Update innodb_page_compression_threads.
+@param n  maximum number of pages to compress or decompress concurrently,
+or 0 to do it in the thread that writes or reads the page */
+void buf_page_compression_threads(uint n)
+{
+  /* Tasks that were submitted before the limit was set to 0
+  will still be run. */
+  if (n)
+    buf_page_compression_group.set_max_tasks(n);
+}
+
 /** Decrypt a page.
 @param[in,out]	bpage	Page control block
 @param[in]	node	data file
@@ -443,9 +458,14 @@ static bool buf_page_decrypt_after_read(buf_page_t *bpage,
 decompress_with_slot:
 		ut_d(fil_page_type_validate(node.space, dst_frame));
 
+		const ulonglong start = my_interval_timer();
 		ulint write_size = fil_page_decompress(
-			slot->crypt_buf, dst_frame, flags);
+			slot->crypt_buf, dst_frame, flags,
+			node.space->zstd_dict);
 		slot->release();
+		node.space->page_compression.decompress_usec
+			+= ulint((my_interval_timer() - start) / 1000);
+		node.space->page_compression.decompressed++;
 		ut_ad(!write_size
 		      || fil_page_type_validate(node.space, dst_frame));
 		ut_ad(node.space->referenced());
@@ -993,7 +1013,7 @@ buf_block_init(buf_block_t* block, byte* frame)
 /** Allocate a chunk of buffer frames.
 @param bytes    requested size
 @return whether the allocation succeeded */
-inline bool buf_pool_t::chunk_t::create(size_t bytes)
+inline bool buf_pool_t::chunk_t::allocate(size_t bytes)
 {
   DBUG_EXECUTE_IF("ib_buf_chunk_init_fails", return false;);
   /* Round down to a multiple of page size, although it already should be. */
@@ -1061,16 +1081,32 @@ inline bool buf_pool_t::chunk_t::create(size_t bytes)
   for (auto i= size; i--; ) {
     buf_block_init(block, frame);
     MEM_UNDEFINED(block->frame, srv_page_size);
+    block++;
+    frame+= srv_page_size;
+  }
+
+  return true;
+}
+
+inline void buf_pool_t::chunk_t::attach()
+{
+  buf_block_t *block= blocks;
+
+  for (auto i= size; i--; block++)
+  {
     /* Add the block to the free list */
     UT_LIST_ADD_LAST(buf_pool.free, &block->page);
-
     ut_d(block->page.in_free_list = TRUE);
-    block++;
-    frame+= srv_page_size;
   }
 
   reg();
+}
 
+inline bool buf_pool_t::chunk_t::create(size_t bytes)
+{
+  if (!allocate(bytes))
+    return false;
+  attach();
   return true;
 }
 
@@ -1132,6 +1168,29 @@ static void buf_block_free_mutexes(buf_block_t* block)
 	block->lock.free();
 }
 
+inline void buf_pool_t::chunk_t::free()
+{
+  /* buf_LRU_block_free_non_file_page() invokes
+  MEM_NOACCESS() on any buf_pool.free blocks.
+  We must cancel the effect of that. In
+  MemorySanitizer, MEM_NOACCESS() is no-op, so
+  we must not do anything special for it here. */
+#ifdef HAVE_valgrind
+# if !__has_feature(memory_sanitizer)
+  MEM_MAKE_DEFINED(mem, mem_size());
+# endif
+#else
+  MEM_MAKE_ADDRESSABLE(mem, size);
+#endif
+
+  buf_block_t *block= blocks;
+
+  for (auto i= size; i--; block++)
+    buf_block_free_mutexes(block);
+
+  buf_pool.allocator.deallocate_large_dodump(mem, &mem_pfx);
+}
+
 /** Create the hash table.
 @param n  the lower bound of n_cells */
 void buf_pool_t::page_hash_table::create(ulint n)
@@ -1217,6 +1276,7 @@ bool buf_pool_t::create()
 
   page_hash.create(2 * curr_size);
   zip_hash.create(2 * curr_size);
+  buf_LRU_ghost_create(curr_size);
   last_printout_time= time(NULL);
 
   mysql_mutex_init(flush_list_mutex_key, &flush_list_mutex,
@@ -1244,6 +1304,7 @@ bool buf_pool_t::create()
 
   chunk_t::map_ref= chunk_t::map_reg;
   buf_LRU_old_ratio_update(100 * 3 / 8, false);
+  buf_page_compression_threads(srv_page_compression_threads);
   btr_search_sys_create();
   ut_ad(is_initialised());
   return false;
@@ -1294,6 +1355,7 @@ void buf_pool_t::close()
   ut_free(chunks);
   chunks= nullptr;
   page_hash.free();
+  buf_LRU_ghost_free();
   while (page_hash_table *old_page_hash= freed_page_hash)
   {
     freed_page_hash= static_cast<page_hash_table*>
@@ -1842,6 +1904,49 @@ inline void buf_pool_t::resize()
 		return;
 	}
 
+	/* Allocate and initialize any additional chunks before blocking
+	buf_pool.page_hash, so that the critical section only needs to
+	link their blocks to buf_pool.free. */
+	chunk_t*	added = NULL;
+	ulint		n_added = 0;
+
+	if (n_chunks_new > n_chunks) {
+		const ulint	n_add = n_chunks_new - n_chunks;
+
+		added = static_cast<chunk_t*>(
+			ut_zalloc_nokey_nofatal(n_add * sizeof *added));
+
+		if (!added) {
+			ib::error() << "failed to allocate"
+				" the chunk array.";
+			warning = true;
+		}
+
+		while (added && n_added < n_add) {
+			buf_resize_status("Allocating buffer pool chunk "
+					  ULINTPF "/" ULINTPF ".",
+					  n_added + 1, n_add);
+
+			if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+				while (n_added) {
+					added[--n_added].free();
+				}
+				ut_free(added);
+				return;
+			}
+
+			if (!added[n_added].allocate(
+				    srv_buf_pool_chunk_unit)) {
+				ib::error() << "failed to allocate"
+					" memory for buffer pool chunk";
+				warning = true;
+				break;
+			}
+
+			n_added++;
+		}
+	}
+
 	/* Indicate critical path */
 	resizing.store(true, std::memory_order_relaxed);
 
@@ -1856,37 +1961,23 @@ inline void buf_pool_t::resize()
 			  ULINTPF " to " ULINTPF ".",
 			  n_chunks, n_chunks_new);
 
+	/* chunks whose blocks were all withdrawn; their memory will be
+	freed after the critical section */
+	chunk_t*	removed = NULL;
+	ulint		n_removed = 0;
+
 	if (n_chunks_new < n_chunks) {
 		/* delete chunks */
-		chunk_t* chunk = chunks + n_chunks_new;
-		const chunk_t* const echunk = chunks + n_chunks;
+		n_removed = n_chunks - n_chunks_new;
+		removed = static_cast<chunk_t*>(
+			ut_malloc_nokey(n_removed * sizeof *removed));
+		memcpy(removed, chunks + n_chunks_new,
+		       n_removed * sizeof *removed);
 
 		ulint	sum_freed = 0;
 
-		while (chunk < echunk) {
-			/* buf_LRU_block_free_non_file_page() invokes
-			MEM_NOACCESS() on any buf_pool.free blocks.
-			We must cancel the effect of that. In
-			MemorySanitizer, MEM_NOACCESS() is no-op, so
-			we must not do anything special for it here. */
-#ifdef HAVE_valgrind
-# if !__has_feature(memory_sanitizer)
-			MEM_MAKE_DEFINED(chunk->mem, chunk->mem_size());
-# endif
-#else
-			MEM_MAKE_ADDRESSABLE(chunk->mem, chunk->size);
-#endif
-
-			buf_block_t*	block = chunk->blocks;
-
-			for (ulint j = chunk->size; j--; block++) {
-				buf_block_free_mutexes(block);
-			}
-
-			allocator.deallocate_large_dodump(
-				chunk->mem, &chunk->mem_pfx);
-			sum_freed += chunk->size;
-			++chunk;
+		for (ulint i = 0; i < n_removed; i++) {
+			sum_freed += removed[i].size;
 		}
 
 		/* discard withdraw list */
@@ -1935,32 +2026,22 @@ inline void buf_pool_t::resize()
 	}
 
 	if (n_chunks_new > n_chunks) {
-		/* add chunks */
+		/* add the chunks that were allocated above */
 		ulint	sum_added = 0;
-		ulint	n = n_chunks;
-		const size_t unit = srv_buf_pool_chunk_unit;
-
-		for (chunk_t* chunk = chunks + n_chunks,
-		     * const echunk = chunks + n_chunks_new;
-		     chunk != echunk; chunk++) {
-			if (!chunk->create(unit)) {
-				ib::error() << "failed to allocate"
-					" memory for buffer pool chunk";
-
-				warning = true;
-				n_chunks_new = n_chunks;
-				break;
-			}
 
+		for (ulint i = 0; i < n_added; i++) {
+			chunk_t* chunk = chunks + n_chunks + i;
+			*chunk = added[i];
+			chunk->attach();
 			sum_added += chunk->size;
-			++n;
 		}
 
-		ib::info() << n_chunks_new - n_chunks
+		ib::info() << n_added
 			   << " chunks (" << sum_added
 			   << " blocks) were added.";
 
-		n_chunks = n;
+		n_chunks += n_added;
+		n_added = 0;
 	}
 calc_buf_pool_size:
 	/* recalc curr_size */
@@ -2009,6 +2090,8 @@ inline void buf_pool_t::resize()
 		ib::info() << "hash tables were resized";
 	}
 
+	buf_LRU_ghost_resize(curr_size);
+
   mysql_mutex_unlock(&mutex);
   write_unlock_all_page_hash();
 
@@ -2016,6 +2099,21 @@ inline void buf_pool_t::resize()
 
 	resizing.store(false, std::memory_order_relaxed);
 
+	if (n_removed) {
+		buf_resize_status("Freeing " ULINTPF " buffer pool chunks.",
+				  n_removed);
+		while (n_removed) {
+			removed[--n_removed].free();
+		}
+	}
+	ut_free(removed);
+
+	/* Free any allocated chunks that could not be added. */
+	while (n_added) {
+		added[--n_added].free();
+	}
+	ut_free(added);
+
 	/* Normalize other components, if the new size is too different */
 	if (!warning && new_size_too_diff) {
 		srv_buf_pool_base_size = srv_buf_pool_size;
@@ -52,14 +52,19 @@ inline void buf_dblwr_t::init(const byte *header)
 {
   ut_ad(!active_slot->first_free);
   ut_ad(!active_slot->reserved);
-  ut_ad(!batch_running);
+  ut_ad(!active_slot->batch_running);
 
   mysql_mutex_init(buf_dblwr_mutex_key, &mutex, nullptr);
   pthread_cond_init(&cond, nullptr);
   block1= page_id_t(0, mach_read_from_4(header + TRX_SYS_DOUBLEWRITE_BLOCK1));
   block2= page_id_t(0, mach_read_from_4(header + TRX_SYS_DOUBLEWRITE_BLOCK2));
 
-  const uint32_t buf_size= 2 * block_size();
+  batch_size= 2 * block_size();
+  if (srv_doublewrite_pages && srv_doublewrite_pages < batch_size)
+    batch_size= srv_doublewrite_pages;
+
+  /* init_or_load_pages() reads a doublewrite block into each slot. */
+  const uint32_t buf_size= std::max(batch_size, block_size());
   for (int i= 0; i < 2; i++)
   {
     slots[i].write_buf= static_cast<byte*>
@@ -67,6 +72,8 @@ inline void buf_dblwr_t::init(const byte *header)
     slots[i].buf_block_arr= static_cast<element*>
       (ut_zalloc_nokey(buf_size * sizeof(element)));
   }
+  slots[0].block= block1;
+  slots[1].block= pipelined() ? block2 : block1;
   active_slot= &slots[0];
 }
 
@@ -269,59 +276,61 @@ dberr_t buf_dblwr_t::init_or_load_pages(pfs_os_file_t file, const char *path)
                      TRX_SYS_DOUBLEWRITE + read_buf) !=
     TRX_SYS_DOUBLEWRITE_SPACE_ID_STORED_N;
 
-  auto write_buf= active_slot->write_buf;
-  /* Read the pages from the doublewrite buffer to memory */
-  err= os_file_read(IORequestRead, file, write_buf,
-                    block1.page_no() << srv_page_size_shift,
-                    size << srv_page_size_shift);
-
-  if (err != DB_SUCCESS)
+  /* Read the pages from the doublewrite buffer to memory. Each
+  doublewrite block is read into one slot. */
+  for (const slot &s : slots)
   {
-    ib::error() << "Failed to read the first double write buffer extent";
-    goto func_exit;
-  }
+    const page_id_t block= &s == slots ? block1 : block2;
+    err= os_file_read(IORequestRead, file, s.write_buf,
+                      block.page_no() << srv_page_size_shift,
+                      size << srv_page_size_shift);
 
-  err= os_file_read(IORequestRead, file,
-                    write_buf + (size << srv_page_size_shift),
-                    block2.page_no() << srv_page_size_shift,
-                    size << srv_page_size_shift);
-  if (err != DB_SUCCESS)
-  {
-    ib::error() << "Failed to read the second double write buffer extent";
-    goto func_exit;
+    if (err != DB_SUCCESS)
+    {
+      ib::error() << "Failed to read the "
+                  << (&s == slots ? "first" : "second")
+                  << " double write buffer extent";
+      goto func_exit;
+    }
   }
 
-  byte *page= write_buf;
-
   if (UNIV_UNLIKELY(upgrade_to_innodb_file_per_table))
   {
     ib::info() << "Resetting space id's in the doublewrite buffer";
 
-    for (ulint i= 0; i < size * 2; i++, page += srv_page_size)
+    for (const slot &s : slots)
     {
-      memset(page + FIL_PAGE_SPACE_ID, 0, 4);
-      /* For pre-MySQL-4.1 innodb_checksum_algorithm=innodb, we do not need to
-      calculate new checksums for the pages because the field
-      .._SPACE_ID does not affect them. Write the page back to where
-      we read it from. */
-      const ulint source_page_no= i < size
-        ? block1.page_no() + i
-        : block2.page_no() + i - size;
-      err= os_file_write(IORequestWrite, path, file, page,
-                         source_page_no << srv_page_size_shift, srv_page_size);
-      if (err != DB_SUCCESS)
+      const page_id_t block= &s == slots ? block1 : block2;
+      byte *page= s.write_buf;
+      for (ulint i= 0; i < size; i++, page += srv_page_size)
       {
-        ib::error() << "Failed to upgrade the double write buffer";
-        goto func_exit;
+        memset(page + FIL_PAGE_SPACE_ID, 0, 4);
+        /* For pre-MySQL-4.1 innodb_checksum_algorithm=innodb, we do not
+        need to calculate new checksums for the pages because the field
+        .._SPACE_ID does not affect them. Write the page back to where
+        we read it from. */
+        const ulint source_page_no= block.page_no() + i;
+        err= os_file_write(IORequestWrite, path, file, page,
+                           source_page_no << srv_page_size_shift,
+                           srv_page_size);
+        if (err != DB_SUCCESS)
+        {
+          ib::error() << "Failed to upgrade the double write buffer";
+          goto func_exit;
+        }
       }
     }
     os_file_flush(file);
   }
   else
-    for (ulint i= 0; i < size * 2; i++, page += srv_page_size)
-      if (mach_read_from_8(my_assume_aligned<8>(page + FIL_PAGE_LSN)))
-        /* Each valid page header must contain a nonzero FIL_PAGE_LSN field. */
-        recv_sys.dblwr.add(page);
+    for (const slot &s : slots)
+    {
+      byte *page= s.write_buf;
+      for (ulint i= 0; i < size; i++, page += srv_page_size)
+        if (mach_read_from_8(my_assume_aligned<8>(page + FIL_PAGE_LSN)))
+          /* Each valid page header must contain a nonzero FIL_PAGE_LSN. */
+          recv_sys.dblwr.add(page);
+    }
 
   err= DB_SUCCESS;
   goto func_exit;
@@ -443,7 +452,12 @@ void buf_dblwr_t::close()
   /* Free the double write data structures. */
   ut_ad(!active_slot->reserved);
   ut_ad(!active_slot->first_free);
-  ut_ad(!batch_running);
+  ut_ad(!slots[0].batch_running);
+  ut_ad(!slots[1].batch_running);
+  ut_ad(!dblwr_slot);
+  ut_ad(!write_slot);
+  ut_ad(!ready_slot);
+  ut_ad(!deferred_slot);
 
   pthread_cond_destroy(&cond);
   for (int i= 0; i < 2; i++)
@@ -467,8 +481,9 @@ void buf_dblwr_t::write_completed()
 
   mysql_mutex_lock(&mutex);
 
-  ut_ad(batch_running);
-  slot *flush_slot= active_slot == &slots[0] ? &slots[1] : &slots[0];
+  slot *flush_slot= write_slot;
+  ut_ad(flush_slot);
+  ut_ad(flush_slot->batch_running);
   ut_ad(flush_slot->reserved);
   ut_ad(flush_slot->reserved <= flush_slot->first_free);
 
@@ -479,10 +494,21 @@ void buf_dblwr_t::write_completed()
     fil_flush_file_spaces();
     mysql_mutex_lock(&mutex);
 
-    /* We can now reuse the doublewrite memory buffer: */
+    /* We can now reuse the doublewrite memory buffer and block: */
     flush_slot->first_free= 0;
-    batch_running= false;
+    flush_slot->batch_running= false;
+    /* Start writing the pages of a batch that was written to the
+    other doublewrite block meanwhile. */
+    flush_slot= write_slot= ready_slot;
+    ready_slot= nullptr;
     pthread_cond_broadcast(&cond);
+
+    if (flush_slot)
+    {
+      mysql_mutex_unlock(&mutex);
+      write_pages(*flush_slot);
+      return;
+    }
   }
 
   mysql_mutex_unlock(&mutex);
@@ -551,30 +577,38 @@ static void buf_dblwr_check_block(const buf_page_t *bpage)
 bool buf_dblwr_t::flush_buffered_writes(const ulint size)
 {
   mysql_mutex_assert_owner(&mutex);
-  ut_ad(size == block_size());
+  ut_ad(size == batch_size);
 
   for (;;)
   {
-    if (!active_slot->first_free)
+    /* A slot whose batch is running holds no buffered writes. */
+    if (active_slot->batch_running || !active_slot->first_free)
       return false;
-    if (!batch_running)
+    /* Only one batch at a time may be written to the doublewrite
+    buffer, so that flush_buffered_writes_completed() knows which one
+    it was. If the slots share the doublewrite blocks, the data pages
+    of the previous batch must have been written before its copy in
+    the doublewrite buffer is overwritten. */
+    if (!dblwr_slot && (pipelined() || !write_slot))
       break;
     my_cond_wait(&cond, &mutex.m_mutex);
   }
 
   ut_ad(active_slot->reserved == active_slot->first_free);
-  ut_ad(!flushing_buffered_writes);
 
   /* Disallow anyone else to start another batch of flushing. */
   slot *flush_slot= active_slot;
-  /* Switch the active slot */
+  /* Switch the active slot. The other slot may still be running a
+  batch; add_to_batch() will wait for it to complete. */
   active_slot= active_slot == &slots[0] ? &slots[1] : &slots[0];
-  ut_a(active_slot->first_free == 0);
-  batch_running= true;
+  flush_slot->batch_running= true;
+  dblwr_slot= flush_slot;
   const ulint old_first_free= flush_slot->first_free;
   auto write_buf= flush_slot->write_buf;
-  const bool multi_batch= block1 + static_cast<uint32_t>(size) != block2 &&
-    old_first_free > size;
+  const ulint block_pages= block_size();
+  const bool multi_batch= old_first_free > block_pages &&
+    block1 + static_cast<uint32_t>(block_pages) != block2;
+  ut_ad(!multi_batch || !pipelined());
   flushing_buffered_writes= 1 + multi_batch;
   pages_submitted+= old_first_free;
   /* Now safe to release the mutex. */
@@ -602,15 +636,16 @@ bool buf_dblwr_t::flush_buffered_writes(const ulint size)
     fil_system.sys_space->reacquire();
     os_aio(request, write_buf,
            os_offset_t{block1.page_no()} << srv_page_size_shift,
-           size << srv_page_size_shift);
-    os_aio(request, write_buf + (size << srv_page_size_shift),
+           block_pages << srv_page_size_shift);
+    os_aio(request, write_buf + (block_pages << srv_page_size_shift),
            os_offset_t{block2.page_no()} << srv_page_size_shift,
-           (old_first_free - size) << srv_page_size_shift);
+           (old_first_free - block_pages) << srv_page_size_shift);
   }
   else
     os_aio(request, write_buf,
-           os_offset_t{block1.page_no()} << srv_page_size_shift,
+           os_offset_t{flush_slot->block.page_no()} << srv_page_size_shift,
            old_first_free << srv_page_size_shift);
+  ut_d(write_deferred(true));
   return true;
 }
 
@@ -624,7 +659,10 @@ void buf_dblwr_t::flush_buffered_writes_completed(const IORequest &request)
   ut_ad(request.node == fil_system.sys_space->chain.start);
   ut_ad(request.type == IORequest::DBLWR_BATCH);
   mysql_mutex_lock(&mutex);
-  ut_ad(batch_running);
+  slot *const flush_slot= dblwr_slot;
+  ut_ad(flush_slot);
+  ut_ad(flush_slot->batch_running);
+  ut_ad(flush_slot->reserved == flush_slot->first_free);
   ut_ad(flushing_buffered_writes);
   ut_ad(flushing_buffered_writes <= 2);
   writes_completed++;
@@ -634,8 +672,6 @@ void buf_dblwr_t::flush_buffered_writes_completed(const IORequest &request)
     return;
   }
 
-  slot *const flush_slot= active_slot == &slots[0] ? &slots[1] : &slots[0];
-  ut_ad(flush_slot->reserved == flush_slot->first_free);
   /* increment the doublewrite flushed pages counter */
   pages_written+= flush_slot->first_free;
   mysql_mutex_unlock(&mutex);
@@ -643,11 +679,51 @@ void buf_dblwr_t::flush_buffered_writes_completed(const IORequest &request)
   /* Now flush the doublewrite buffer data to disk */
   fil_system.sys_space->flush<false>();
 
+  mysql_mutex_lock(&mutex);
+  ut_ad(dblwr_slot == flush_slot);
+  /* Allow the other slot to be written to its doublewrite block. */
+  dblwr_slot= nullptr;
+  bool wait= write_slot != nullptr;
+  if (wait)
+  {
+    /* The pages of the previous batch are still being written.
+    write_completed() will write our pages once they have completed. */
+    ut_ad(write_slot != flush_slot);
+    ut_ad(!ready_slot);
+    ready_slot= flush_slot;
+  }
+  else
+  {
+    write_slot= flush_slot;
+#ifdef UNIV_DEBUG
+    if (pipelined() &&
+        DBUG_EVALUATE_IF("ib_dblwr_write_pages_pause", true, false))
+    {
+      /* Let the thread that submits the next batch write the pages. */
+      deferred_slot= flush_slot;
+      wait= true;
+    }
+#endif
+  }
+  pthread_cond_broadcast(&cond);
+  mysql_mutex_unlock(&mutex);
+
+  if (!wait)
+    write_pages(*flush_slot);
+}
+
+/** Write the pages of a batch to the data files, after the batch
+has been written to the doublewrite block and made durable.
+@param flush_slot  the batch to write */
+void buf_dblwr_t::write_pages(const slot &flush_slot)
+{
+  ut_ad(flush_slot.batch_running);
+
   /* The writes have been flushed to disk now and in recovery we will
   find them in the doublewrite buffer blocks. Next, write the data pages. */
-  for (ulint i= 0, first_free= flush_slot->first_free; i < first_free; i++)
+  for (ulint i= 0, first_free= flush_slot.first_free; i < first_free; i++)
   {
-    auto e= flush_slot->buf_block_arr[i];
+    auto e= flush_slot.buf_block_arr[i];
     buf_page_t* bpage= e.request.bpage;
     ut_ad(bpage->in_file());
 
@@ -674,6 +750,31 @@ void buf_dblwr_t::flush_buffered_writes_completed(const IORequest &request)
   }
 }
 
+#ifdef UNIV_DEBUG
+void buf_dblwr_t::write_deferred(bool submitted)
+{
+  mysql_mutex_lock(&mutex);
+  slot *flush_slot= deferred_slot;
+  if (flush_slot &&
+      (submitted ||
+       !DBUG_EVALUATE_IF("ib_dblwr_write_pages_pause", true, false)))
+    deferred_slot= nullptr;
+  else
+    flush_slot= nullptr;
+  mysql_mutex_unlock(&mutex);
+
+  if (!flush_slot)
+    return;
+
+  /* The next batch was submitted while the pages of the previous one
+  are still to be written. Keep it that way while the test wants. */
+  while (DBUG_EVALUATE_IF("ib_dblwr_write_pages_pause", true, false))
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  write_pages(*flush_slot);
+}
+#endif
+
 /** Flush possible buffered writes to persistent storage.
 It is very important to call this function after a batch of writes has been
 posted, and also when we may have to wait for a page latch!
@@ -688,11 +789,14 @@ void buf_dblwr_t::flush_buffered_writes()
   }
 
   ut_ad(!srv_read_only_mode);
-  const ulint size= block_size();
+  const ulint size= batch_size;
 
   mysql_mutex_lock(&mutex);
   if (!flush_buffered_writes(size))
+  {
     mysql_mutex_unlock(&mutex);
+    ut_d(write_deferred(false));
+  }
 }
 
 /** Schedule a page write. If the doublewrite memory buffer is full,
@@ -710,17 +814,19 @@ void buf_dblwr_t::add_to_batch(const IORequest &request, size_t size)
   ut_ad(request.node->space->referenced());
   ut_ad(!srv_read_only_mode);
 
-  const ulint buf_size= 2 * block_size();
+  const ulint buf_size= batch_size;
 
   mysql_mutex_lock(&mutex);
 
   for (;;)
   {
     ut_ad(active_slot->first_free <= buf_size);
-    if (active_slot->first_free != buf_size)
+    if (active_slot->batch_running)
+      /* Wait for the previous batch of this slot to complete. */
+      my_cond_wait(&cond, &mutex.m_mutex);
+    else if (active_slot->first_free != buf_size)
       break;
-
-    if (flush_buffered_writes(buf_size / 2))
+    else if (flush_buffered_writes(buf_size))
       mysql_mutex_lock(&mutex);
   }
 
@@ -747,6 +853,6 @@ void buf_dblwr_t::add_to_batch(const IORequest &request, size_t size)
   active_slot->reserved= active_slot->first_free;
 
   if (active_slot->first_free != buf_size ||
-      !flush_buffered_writes(buf_size / 2))
+      !flush_buffered_writes(buf_size))
     mysql_mutex_unlock(&mutex);
 }
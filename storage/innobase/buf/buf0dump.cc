@@ -33,14 +33,19 @@ Created April 08, 2011 Vasil Dimov
 
 #include "buf0buf.h"
 #include "buf0dump.h"
+#include "buf0rea.h"
 #include "dict0dict.h"
+#include "fil0crypt.h"
+#include "log0recv.h"
 #include "os0file.h"
 #include "os0thread.h"
 #include "srv0srv.h"
 #include "srv0start.h"
 #include "ut0byte.h"
+#include "ut0crc32.h"
 
 #include <algorithm>
+#include <set>
 
 #include "mysql/service_wsrep.h" /* wsrep_recovery */
 #include <my_service_manager.h>
@@ -61,6 +66,49 @@ static volatile bool	buf_load_should_start;
 
 static bool	buf_load_abort_flag;
 
+/** Suffix of the page image file name (innodb_buffer_pool_dump_pages) */
+#define BUF_DUMP_PAGES_SUFFIX	".pages"
+
+/** The page image consists of a header page, followed by copies of
+buffer pool pages in the order of buf_pool.LRU. The page identifier of
+each page is stored in FIL_PAGE_SPACE_ID and FIL_PAGE_OFFSET. */
+/** @{ */
+/** Magic string at the start of the header page */
+static const char	BUF_DUMP_PAGES_MAGIC[8] = {'I','b','P','a','g','e','s','1'};
+/** The shutdown LSN; 8 bytes */
+#define BUF_DUMP_PAGES_LSN	8
+/** innodb_page_size; 4 bytes */
+#define BUF_DUMP_PAGES_PAGE_SIZE	16
+/** number of pages after the header page; 4 bytes */
+#define BUF_DUMP_PAGES_N	20
+/** CRC-32C of the preceding bytes of the header; 4 bytes */
+#define BUF_DUMP_PAGES_CHECKSUM	24
+/** Size of the header, excluding padding to srv_page_size */
+#define BUF_DUMP_PAGES_HDR_SIZE	28
+/** @} */
+
+/** Number of pages to write or read with one system call */
+static constexpr ulint BUF_DUMP_PAGES_BATCH = 64;
+
+lsn_t	buf_load_pages_lsn;
+/** Number of pages in the page image; valid if buf_load_pages_lsn != 0 */
+static ulint	buf_load_pages_n;
+/** Pages that were modified and evicted after startup, before
+buf_load_pages() got to them; protected by buf_pool.mutex */
+static std::set<page_id_t>	buf_load_pages_stale_ids;
+/** Tablespaces that were discarded, dropped or closed after startup.
+IMPORT TABLESPACE writes the data file outside the buffer pool and keeps
+the tablespace identifier, so no page of these may be loaded from the page
+image. Protected by buf_pool.mutex. */
+static std::set<uint32_t>	buf_load_pages_stale_spaces;
+/** Whether too many pages or tablespaces were invalidated to keep track of
+them, so that the page image must not be used at all; protected by
+buf_pool.mutex */
+static bool	buf_load_pages_abandoned;
+/** Maximum number of entries in buf_load_pages_stale_ids and
+buf_load_pages_stale_spaces */
+static constexpr size_t BUF_LOAD_PAGES_MAX_STALE = 4096;
+
 /** Start the buffer pool dump/load task and instructs it to start a dump. */
 void buf_dump_start()
 {
@@ -415,6 +463,208 @@ buf_dump(
 	export_vars.innodb_buffer_pool_load_incomplete = 0;
 }
 
+/** Check whether the pages of a tablespace can be part of a page image.
+ROW_FORMAT=COMPRESSED and page_compressed pages have a different format
+in the buffer pool than in the data file, and the pages of encrypted
+tablespaces must not be written to the file system in plain text.
+@param space	tablespace
+@return whether the pages of space may be copied to a page image */
+static bool buf_dump_pages_space_ok(const fil_space_t &space)
+{
+	if (space.zip_size() || space.is_compressed()) {
+		return false;
+	}
+
+	return space.crypt_data
+		? space.crypt_data->type == CRYPT_SCHEME_UNENCRYPTED
+		: !srv_encrypt_tables;
+}
+
+/** Write the hottest pages of the buffer pool to
+innodb_buffer_pool_filename.pages, if innodb_buffer_pool_dump_pages is set.
+This is invoked after the final log checkpoint of a shutdown, when no
+page is dirty.
+@param lsn	the shutdown LSN */
+void buf_dump_pages(lsn_t lsn)
+{
+	ut_ad(srv_shutdown_state == SRV_SHUTDOWN_LAST_PHASE);
+
+	if (!srv_buffer_pool_dump_at_shutdown || !srv_buffer_pool_dump_pages
+	    || srv_read_only_mode || !buf_pool.is_initialised()) {
+		return;
+	}
+
+	if (export_vars.innodb_buffer_pool_load_incomplete) {
+		buf_dump_status(STATUS_INFO,
+				"Dumping of buffer pool pages not started"
+				" as load was incomplete");
+		return;
+	}
+
+#ifdef WITH_WSREP
+	if (get_wsrep_recovery()) {
+		return;
+	}
+#endif /* WITH_WSREP */
+
+	char	full_filename[OS_FILE_MAX_PATH];
+	char	filename[OS_FILE_MAX_PATH + sizeof BUF_DUMP_PAGES_SUFFIX];
+	char	tmp_filename[OS_FILE_MAX_PATH + sizeof BUF_DUMP_PAGES_SUFFIX
+			     + sizeof "incomplete"];
+
+	buf_dump_generate_path(full_filename, sizeof full_filename);
+	snprintf(filename, sizeof filename, "%s" BUF_DUMP_PAGES_SUFFIX,
+		 full_filename);
+	snprintf(tmp_filename, sizeof tmp_filename, "%s.incomplete",
+		 filename);
+
+	buf_dump_status(STATUS_INFO, "Dumping buffer pool pages to %s",
+			filename);
+
+	FILE*	f = fopen(tmp_filename, "wb" STR_O_CLOEXEC);
+
+	if (f == NULL) {
+		buf_dump_status(STATUS_ERR,
+				"Cannot open '%s' for writing: %s",
+				tmp_filename, strerror(errno));
+		return;
+	}
+
+	ulint	n_pages = UT_LIST_GET_LEN(buf_pool.LRU);
+
+	if (srv_buf_pool_dump_pct != 100) {
+		n_pages = std::min(n_pages, buf_pool.curr_size
+				   * srv_buf_pool_dump_pct / 100);
+	}
+
+	const buf_block_t**	dump = static_cast<const buf_block_t**>(
+		ut_malloc_nokey(std::max<ulint>(n_pages, 1) * sizeof *dump));
+	byte*	buf = static_cast<byte*>(
+		aligned_malloc(BUF_DUMP_PAGES_BATCH << srv_page_size_shift,
+			       srv_page_size));
+	ulint	j = 0;
+
+	/* All other threads have been shut down, and no page is dirty.
+	The blocks cannot be evicted after we release buf_pool.mutex. */
+	mysql_mutex_lock(&buf_pool.mutex);
+
+	for (const buf_page_t* bpage = UT_LIST_GET_FIRST(buf_pool.LRU);
+	     bpage != NULL && j < n_pages;
+	     bpage = UT_LIST_GET_NEXT(LRU, bpage)) {
+		ut_ad(!bpage->oldest_modification());
+
+		if (bpage->state() != BUF_BLOCK_FILE_PAGE
+		    || bpage->zip.data
+		    || bpage->status == buf_page_t::FREED
+		    || bpage->id().space() == SRV_TMP_SPACE_ID) {
+			continue;
+		}
+
+		dump[j++] = reinterpret_cast<const buf_block_t*>(bpage);
+	}
+
+	mysql_mutex_unlock(&buf_pool.mutex);
+
+	n_pages = j;
+
+	/* Leave room for the header page. It will be written last. */
+	memset(buf, 0, srv_page_size);
+	bool	ok = fwrite(buf, srv_page_size, 1, f) == 1;
+	ulint	n_written = 0;
+	ulint	space_id = ULINT_UNDEFINED;
+	bool	space_ok = false;
+
+	for (j = 0; ok && j < n_pages; ) {
+		ulint	n = 0;
+
+		for (; j < n_pages && n < BUF_DUMP_PAGES_BATCH; j++) {
+			const buf_block_t*	block = dump[j];
+			const page_id_t		id(block->page.id());
+
+			if (id.space() != space_id) {
+				space_id = id.space();
+				const fil_space_t* space
+					= fil_space_get(space_id);
+				space_ok = space
+					&& buf_dump_pages_space_ok(*space);
+			}
+
+			/* The page identifier in the frame may differ
+			for uninitialized pages, or for the system
+			tablespace pages that were created before
+			MySQL 4.1.1. Such pages are not worth loading. */
+			if (!space_ok
+			    || mach_read_from_4(block->frame
+						+ FIL_PAGE_SPACE_ID)
+			    != id.space()
+			    || mach_read_from_4(block->frame + FIL_PAGE_OFFSET)
+			    != id.page_no()) {
+				continue;
+			}
+
+			memcpy_aligned<UNIV_PAGE_SIZE_MIN>(
+				buf + (n++ << srv_page_size_shift),
+				block->frame, srv_page_size);
+		}
+
+		if (n) {
+			ok = fwrite(buf, srv_page_size, n, f) == n;
+			n_written += n;
+		}
+
+		service_manager_extend_timeout(
+			INNODB_EXTEND_TIMEOUT_INTERVAL,
+			"Dumping buffer pool page "
+			ULINTPF "/" ULINTPF, j, n_pages);
+	}
+
+	ut_free(dump);
+
+	if (ok) {
+		memset(buf, 0, srv_page_size);
+		memcpy(buf, BUF_DUMP_PAGES_MAGIC, sizeof BUF_DUMP_PAGES_MAGIC);
+		mach_write_to_8(buf + BUF_DUMP_PAGES_LSN, lsn);
+		mach_write_to_4(buf + BUF_DUMP_PAGES_PAGE_SIZE, srv_page_size);
+		mach_write_to_4(buf + BUF_DUMP_PAGES_N, n_written);
+		mach_write_to_4(buf + BUF_DUMP_PAGES_CHECKSUM,
+				ut_crc32(buf, BUF_DUMP_PAGES_CHECKSUM));
+		ok = !fseek(f, 0, SEEK_SET)
+			&& fwrite(buf, srv_page_size, 1, f) == 1;
+	}
+
+	aligned_free(buf);
+
+	if (!ok) {
+		fclose(f);
+		buf_dump_status(STATUS_ERR, "Cannot write to '%s': %s",
+				tmp_filename, strerror(errno));
+		/* leave tmp_filename to exist */
+		return;
+	}
+
+	if (IF_WIN(my_fclose(f,0),fclose(f))) {
+		buf_dump_status(STATUS_ERR, "Cannot close '%s': %s",
+				tmp_filename, strerror(errno));
+		return;
+	}
+
+	if (unlink(filename) && errno != ENOENT) {
+		buf_dump_status(STATUS_ERR, "Cannot delete '%s': %s",
+				filename, strerror(errno));
+		return;
+	}
+
+	if (rename(tmp_filename, filename)) {
+		buf_dump_status(STATUS_ERR, "Cannot rename '%s' to '%s': %s",
+				tmp_filename, filename, strerror(errno));
+		return;
+	}
+
+	buf_dump_status(STATUS_INFO,
+			"Buffer pool(s) dump completed with " ULINTPF
+			" pages at LSN " LSN_PF, n_written, lsn);
+}
+
 /*****************************************************************//**
 Artificially delay the buffer pool loading if necessary. The idea of
 this function is to prevent hogging the server with IO and slowing down
@@ -482,6 +732,310 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Check at startup whether the page image that was written by
+buf_dump_pages() at the previous shutdown matches the data files.
+If it does, buf_load() will load the pages from it. This must be
+invoked before any page is modified. */
+void buf_load_pages_prepare()
+{
+	ut_ad(!buf_load_pages_lsn);
+
+	if (!srv_buffer_pool_load_at_startup || !srv_buffer_pool_dump_pages
+	    || srv_read_only_mode || srv_operation != SRV_OPERATION_NORMAL
+	    || recv_needed_recovery) {
+		return;
+	}
+
+#ifdef WITH_WSREP
+	if (get_wsrep_recovery()) {
+		return;
+	}
+#endif /* WITH_WSREP */
+
+	char	full_filename[OS_FILE_MAX_PATH];
+	char	filename[OS_FILE_MAX_PATH + sizeof BUF_DUMP_PAGES_SUFFIX];
+
+	buf_dump_generate_path(full_filename, sizeof full_filename);
+	snprintf(filename, sizeof filename, "%s" BUF_DUMP_PAGES_SUFFIX,
+		 full_filename);
+
+	FILE*	f = fopen(filename, "rb" STR_O_CLOEXEC);
+
+	if (f == NULL) {
+		return;
+	}
+
+	byte	hdr[BUF_DUMP_PAGES_HDR_SIZE];
+	const bool ok = fread(hdr, sizeof hdr, 1, f) == 1;
+	fclose(f);
+
+	if (!ok || memcmp(hdr, BUF_DUMP_PAGES_MAGIC, sizeof BUF_DUMP_PAGES_MAGIC)
+	    || mach_read_from_4(hdr + BUF_DUMP_PAGES_CHECKSUM)
+	    != ut_crc32(hdr, BUF_DUMP_PAGES_CHECKSUM)
+	    || mach_read_from_4(hdr + BUF_DUMP_PAGES_PAGE_SIZE)
+	    != srv_page_size) {
+		buf_load_status(STATUS_INFO, "Ignoring '%s': not a page image"
+				" for innodb_page_size=%lu",
+				filename, srv_page_size);
+		return;
+	}
+
+	/* If the data files were modified after the page image was
+	written, or if the log was discarded, the LSN would not match. */
+	const lsn_t	lsn = mach_read_from_8(hdr + BUF_DUMP_PAGES_LSN);
+
+	if (lsn != log_sys.get_lsn()) {
+		buf_load_status(STATUS_INFO, "Ignoring '%s': the page image"
+				" is for LSN " LSN_PF ", not " LSN_PF,
+				filename, lsn, log_sys.get_lsn());
+		return;
+	}
+
+	buf_load_pages_n = mach_read_from_4(hdr + BUF_DUMP_PAGES_N);
+	buf_load_pages_lsn = lsn;
+}
+
+/** Note that a page is being removed from the buffer pool
+while buf_load_pages_lsn is set.
+@param bpage	page that is being removed */
+void buf_load_pages_evicted(const buf_page_t &bpage)
+{
+	mysql_mutex_assert_owner(&buf_pool.mutex);
+	ut_ad(buf_load_pages_lsn);
+
+	if (bpage.state() != BUF_BLOCK_FILE_PAGE || bpage.zip.data) {
+		/* ROW_FORMAT=COMPRESSED pages are not in the page image. */
+		return;
+	}
+
+	/* Any page that was modified after startup carries a newer LSN.
+	A freed page might not be written back at all. */
+	if (buf_load_pages_abandoned
+	    || (bpage.status != buf_page_t::FREED
+		&& mach_read_from_8(reinterpret_cast<const buf_block_t&>(
+					    bpage).frame + FIL_PAGE_LSN)
+		<= buf_load_pages_lsn)) {
+		return;
+	}
+
+	if (buf_load_pages_stale_ids.size() >= BUF_LOAD_PAGES_MAX_STALE) {
+		buf_load_pages_abandoned = true;
+		buf_load_pages_stale_ids.clear();
+	} else {
+		buf_load_pages_stale_ids.emplace(bpage.id());
+	}
+}
+
+/** Note that a tablespace is about to be discarded, dropped or closed.
+Its identifier may be reused by IMPORT TABLESPACE, so that the page image
+is no longer valid for it.
+@param id	tablespace identifier */
+void buf_load_pages_space_stopping(uint32_t id)
+{
+	mysql_mutex_lock(&buf_pool.mutex);
+	if (buf_load_pages_lsn && !buf_load_pages_abandoned) {
+		if (buf_load_pages_stale_spaces.size()
+		    >= BUF_LOAD_PAGES_MAX_STALE) {
+			buf_load_pages_abandoned = true;
+			buf_load_pages_stale_spaces.clear();
+		} else {
+			buf_load_pages_stale_spaces.emplace(id);
+		}
+	}
+	mysql_mutex_unlock(&buf_pool.mutex);
+}
+
+/** Check whether the page image may be older than the data file.
+@param id	page identifier
+@return whether the page was modified and evicted after startup, or
+its tablespace was discarded */
+bool buf_load_pages_stale(const page_id_t id)
+{
+	mysql_mutex_lock(&buf_pool.mutex);
+	const bool stale = buf_load_pages_abandoned
+		|| buf_load_pages_stale_spaces.count(id.space())
+		|| buf_load_pages_stale_ids.count(id);
+	mysql_mutex_unlock(&buf_pool.mutex);
+	return stale;
+}
+
+/** @return whether the page image may still be used */
+static bool buf_load_pages_usable()
+{
+	mysql_mutex_lock(&buf_pool.mutex);
+	const bool usable = !buf_load_pages_abandoned;
+	mysql_mutex_unlock(&buf_pool.mutex);
+	return usable;
+}
+
+/** Stop tracking evicted pages for buf_load_pages(). */
+static void buf_load_pages_end()
+{
+	mysql_mutex_lock(&buf_pool.mutex);
+	buf_load_pages_lsn = 0;
+	buf_load_pages_abandoned = false;
+	buf_load_pages_stale_ids.clear();
+	buf_load_pages_stale_spaces.clear();
+	mysql_mutex_unlock(&buf_pool.mutex);
+}
+
+/** Load the page image that buf_load_pages_prepare() found to be usable.
+Each page is copied to the buffer pool unless it is already there, its
+tablespace no longer exists, or it fails validation.
+@param full_filename	innodb_buffer_pool_filename
+@return whether the page image was loaded (or loading was aborted) */
+static bool buf_load_pages(const char *full_filename)
+{
+	const lsn_t	lsn = buf_load_pages_lsn;
+	const ulint	n_pages = buf_load_pages_n;
+	char		filename[OS_FILE_MAX_PATH
+				 + sizeof BUF_DUMP_PAGES_SUFFIX];
+	char		now[32];
+
+	ut_ad(lsn);
+
+	snprintf(filename, sizeof filename, "%s" BUF_DUMP_PAGES_SUFFIX,
+		 full_filename);
+
+	buf_load_status(STATUS_INFO,
+			"Loading buffer pool(s) from %s", filename);
+
+	FILE*	f = fopen(filename, "rb" STR_O_CLOEXEC);
+
+	if (f == NULL || fseek(f, long(srv_page_size), SEEK_SET)) {
+		buf_load_status(STATUS_INFO,
+				"Cannot open '%s' for reading: %s",
+				filename, strerror(errno));
+		if (f) {
+			fclose(f);
+		}
+		buf_load_pages_end();
+		return false;
+	}
+
+	byte*	buf = static_cast<byte*>(
+		aligned_malloc(BUF_DUMP_PAGES_BATCH << srv_page_size_shift,
+			       srv_page_size));
+
+	export_vars.innodb_buffer_pool_load_incomplete = 1;
+
+	PSI_stage_progress*	pfs_stage_progress __attribute__((unused))
+		= mysql_set_stage(srv_stage_buffer_pool_load.m_key);
+	mysql_stage_set_work_estimated(pfs_stage_progress, n_pages);
+	mysql_stage_set_work_completed(pfs_stage_progress, 0);
+
+	ulint		last_check_time = 0;
+	ulint		last_activity_cnt = 0;
+	ulint		n_read = 0, n_loaded = 0, n_io = 0;
+	fil_space_t*	space = nullptr;
+	ulint		space_id = ULINT_UNDEFINED;
+	bool		read_error = false;
+	bool		abandoned = false;
+
+	DBUG_EXECUTE_IF("ib_buf_load_pages_pause",
+			while (DBUG_EVALUATE_IF("ib_buf_load_pages_pause",
+						!SHUTTING_DOWN(), false)) {
+				std::this_thread::sleep_for(
+					std::chrono::milliseconds(10));
+			});
+
+	while (n_read < n_pages && !SHUTTING_DOWN()
+	       && !buf_load_abort_flag) {
+		if (!buf_load_pages_usable()) {
+			abandoned = true;
+			break;
+		}
+
+		const size_t n = fread(buf, srv_page_size,
+				       std::min(n_pages - n_read,
+						BUF_DUMP_PAGES_BATCH), f);
+		if (!n) {
+			read_error = true;
+			break;
+		}
+
+		for (size_t i = 0; i < n; i++) {
+			const byte*	frame = buf + (i << srv_page_size_shift);
+			const page_id_t	id(mach_read_from_4(
+						   frame + FIL_PAGE_SPACE_ID),
+					   mach_read_from_4(
+						   frame + FIL_PAGE_OFFSET));
+
+			if (id.space() != space_id) {
+				if (space) {
+					space->release();
+				}
+				space_id = id.space();
+				space = fil_space_t::get(space_id);
+			}
+
+			/* The data file was not modified since the
+			page image was written, but do not trust the
+			page image blindly. */
+			if (space && buf_dump_pages_space_ok(*space)
+			    && id.page_no() < space->get_size()
+			    && mach_read_from_8(frame + FIL_PAGE_LSN) <= lsn
+			    && !buf_page_is_corrupted(false, frame,
+						      space->flags)
+			    && buf_read_page_from_image(space, id, frame)) {
+				n_loaded++;
+			}
+		}
+
+		n_read += n;
+		mysql_stage_set_work_completed(pfs_stage_progress, n_read);
+		buf_load_throttle_if_needed(
+			&last_check_time, &last_activity_cnt, n_io++);
+	}
+
+	if (space) {
+		space->release();
+	}
+
+	aligned_free(buf);
+	fclose(f);
+	buf_load_pages_end();
+
+	ut_sprintf_timestamp(now);
+
+	if (read_error) {
+		buf_load_status(STATUS_ERR, "Error reading '%s' after "
+				ULINTPF " pages", filename, n_read);
+		mysql_end_stage();
+		/* Fall back to innodb_buffer_pool_filename. */
+		return false;
+	}
+
+	if (abandoned) {
+		buf_load_status(STATUS_INFO, "Stopped loading '%s' after "
+				ULINTPF " pages: too many pages were"
+				" modified since startup", filename, n_read);
+		mysql_end_stage();
+		/* Fall back to innodb_buffer_pool_filename. */
+		return false;
+	}
+
+	if (n_read == n_pages) {
+		buf_load_status(STATUS_INFO,
+				"Buffer pool(s) load completed at %s"
+				" (" ULINTPF " of " ULINTPF " pages loaded)",
+				now, n_loaded, n_pages);
+		export_vars.innodb_buffer_pool_load_incomplete = 0;
+	} else if (buf_load_abort_flag) {
+		buf_load_abort_flag = false;
+		buf_load_status(STATUS_INFO,
+				"Buffer pool(s) load aborted on request");
+	} else {
+		buf_load_status(STATUS_INFO,
+				"Buffer pool(s) load aborted due to shutdown"
+				" at %s", now);
+	}
+
+	mysql_stage_set_work_completed(pfs_stage_progress, n_pages);
+	mysql_end_stage();
+	return true;
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -508,6 +1062,10 @@ buf_load()
 
 	buf_dump_generate_path(full_filename, sizeof(full_filename));
 
+	if (buf_load_pages_lsn && buf_load_pages(full_filename)) {
+		return;
+	}
+
 	buf_load_status(STATUS_INFO,
 			"Loading buffer pool(s) from %s", full_filename);
 
@@ -827,4 +1385,7 @@ void buf_load_dump_end()
 {
   ut_ad(SHUTTING_DOWN());
   buf_dump_load_task.wait();
+  if (buf_load_pages_lsn)
+    /* buf_load() was never invoked */
+    buf_load_pages_end();
 }
@@ -40,6 +40,8 @@ Created 11/11/1995 Heikki Tuuri
 #include "log0crypt.h"
 #include "srv0mon.h"
 #include "fil0pagecompress.h"
+#include <condition_variable>
+#include <vector>
 #ifdef HAVE_LZO
 # include "lzo/lzo1x.h"
 #elif defined HAVE_SNAPPY
@@ -730,9 +732,14 @@ static byte *buf_page_encrypt(fil_space_t* space, buf_page_t* bpage, byte* s,
     /* First we compress the page content */
     buf_tmp_reserve_compression_buf(slot);
     byte *tmp= slot->comp_buf;
+    const ulonglong start= my_interval_timer();
     ulint len= fil_page_compress(s, tmp, space->flags,
                                  fil_space_get_block_size(space, page_no),
-                                 encrypted);
+                                 encrypted, space->zstd_dict);
+    space->page_compression.compress_usec+=
+      ulint((my_interval_timer() - start) / 1000);
+    space->page_compression.compressed++;
+    space->page_compression.compressed_bytes+= len ? len : *size;
 
     if (!len)
       goto not_compressed;
@@ -804,6 +811,183 @@ static void buf_release_freed_page(buf_page_t *bpage)
   mysql_mutex_unlock(&buf_pool.mutex);
 }
 
+/** Submit a page write.
+@param bpage   buffer page that is being written
+@param space   tablespace
+@param type    type of the write request
+@param frame   page frame to write
+@param size    number of bytes to write */
+static void buf_flush_submit(buf_page_t *bpage, fil_space_t *space,
+                             IORequest::Type type, byte *frame, size_t size)
+{
+  if (bpage->status != buf_page_t::NORMAL || !space->use_doublewrite())
+    space->io(IORequest(type, bpage),
+              bpage->physical_offset(), size, frame, bpage);
+  else
+    buf_dblwr.add_to_batch(IORequest(bpage, space->chain.start, type), size);
+}
+
+/** Compute the checksum, encrypt or compress a page for writing.
+@param block   block whose page is being written
+@param space   tablespace
+@param lru     true=buf_pool.LRU; false=buf_pool.flush_list
+@param size    number of bytes to write
+@param type    type of the write request
+@return page frame to write */
+static byte *buf_flush_prepare_block(buf_block_t *block, fil_space_t *space,
+                                     bool lru, size_t *size,
+                                     IORequest::Type *type)
+{
+  page_t *frame= block->page.zip.data;
+  byte *page= block->frame;
+  *size= block->physical_size();
+  *type= lru ? IORequest::WRITE_LRU : IORequest::WRITE_ASYNC;
+#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
+  const size_t orig_size= *size;
+#endif
+
+  if (space->full_crc32())
+  {
+    /* innodb_checksum_algorithm=full_crc32 is not implemented for
+    ROW_FORMAT=COMPRESSED pages. */
+    ut_ad(!frame);
+    page= buf_page_encrypt(space, &block->page, page, size);
+    buf_flush_init_for_writing(block, page, nullptr, true);
+  }
+  else
+  {
+    buf_flush_init_for_writing(block, page, frame ? &block->page.zip : nullptr,
+                               false);
+    page= buf_page_encrypt(space, &block->page, frame ? frame : page, size);
+  }
+
+#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
+  if (*size != orig_size && space->punch_hole)
+    *type= lru ? IORequest::PUNCH_LRU : IORequest::PUNCH;
+#endif
+
+  return page;
+}
+
+/** Compute the checksum, encrypt or compress a page, and submit the write.
+@param block   block whose page is being written
+@param space   tablespace
+@param lru     true=buf_pool.LRU; false=buf_pool.flush_list */
+static void buf_flush_write_block(buf_block_t *block, fil_space_t *space,
+                                  bool lru)
+{
+  size_t size;
+  IORequest::Type type;
+  byte *page= buf_flush_prepare_block(block, space, lru, &size, &type);
+  buf_flush_submit(&block->page, space, type, page, size);
+}
+
+struct buf_flush_compress_task;
+
+/** The page_compressed page writes of a flush batch that are being
+prepared in the thread pool (innodb_page_compression_threads), so that
+the CPU time of compression does not limit the page cleaner. The tasks
+only compress; the thread that runs the batch submits the writes, so that
+no thread pool worker waits in buf_dblwr_t::add_to_batch(). */
+struct buf_flush_compress_batch
+{
+  /** protects pending and ready */
+  std::mutex mutex;
+  /** signalled when a task has been added to ready */
+  std::condition_variable cond;
+  /** number of tasks that have not been added to ready */
+  ulint pending;
+  /** tasks whose write has not been submitted yet */
+  std::vector<buf_flush_compress_task*> ready;
+};
+
+/** The batches; at most one LRU and one flush_list batch can run at a time
+@see buf_flush_lists() */
+static buf_flush_compress_batch buf_flush_compress[2];
+
+/** A page_compressed page write that is being prepared in the thread pool */
+struct buf_flush_compress_task : tpool::task
+{
+  /** block whose page is being written */
+  buf_block_t *const block;
+  /** tablespace */
+  fil_space_t *const space;
+  /** true=buf_pool.LRU; false=buf_pool.flush_list */
+  const bool lru;
+  /** page frame to write */
+  byte *frame;
+  /** number of bytes to write */
+  size_t size;
+  /** type of the write request */
+  IORequest::Type type;
+
+  buf_flush_compress_task(buf_block_t *block, fil_space_t *space, bool lru) :
+    tpool::task(execute_callback, this, &buf_page_compression_group),
+    block(block), space(space), lru(lru) {}
+
+  static void execute_callback(void *arg)
+  {
+    auto t= static_cast<buf_flush_compress_task*>(arg);
+    t->frame= buf_flush_prepare_block(t->block, t->space, t->lru,
+                                      &t->size, &t->type);
+  }
+
+  /** Hand over the prepared write to the thread that runs the batch.
+  The task group will not access the task after this. */
+  void release() override
+  {
+    buf_flush_compress_batch &batch= buf_flush_compress[lru];
+    std::lock_guard<std::mutex> g(batch.mutex);
+    batch.ready.push_back(this);
+    batch.pending--;
+    batch.cond.notify_one();
+  }
+};
+
+/** Prepare a page_compressed page write in the thread pool.
+@param block   block whose page is being written
+@param space   tablespace
+@param lru     true=buf_pool.LRU; false=buf_pool.flush_list */
+static void buf_flush_compress_submit(buf_block_t *block, fil_space_t *space,
+                                      bool lru)
+{
+  {
+    buf_flush_compress_batch &batch= buf_flush_compress[lru];
+    std::lock_guard<std::mutex> g(batch.mutex);
+    batch.pending++;
+  }
+  srv_thread_pool->submit_task(new buf_flush_compress_task(block, space, lru));
+}
+
+/** Submit the page_compressed page writes of a batch that have been
+prepared by buf_flush_compress_submit().
+@param lru     true=buf_pool.LRU; false=buf_pool.flush_list
+@param wait    whether to wait until no writes are pending */
+static void buf_flush_compress_write(bool lru, bool wait)
+{
+  buf_flush_compress_batch &batch= buf_flush_compress[lru];
+  std::vector<buf_flush_compress_task*> ready;
+  std::unique_lock<std::mutex> lk(batch.mutex);
+
+  for (;;)
+  {
+    if (wait)
+      batch.cond.wait(lk, [&batch]
+                      { return !batch.pending || !batch.ready.empty(); });
+    if (batch.ready.empty())
+      return;
+    ready.swap(batch.ready);
+    lk.unlock();
+    for (buf_flush_compress_task *t : ready)
+    {
+      buf_flush_submit(&t->block->page, t->space, t->type, t->frame, t->size);
+      delete t;
+    }
+    ready.clear();
+    lk.lock();
+  }
+}
+
 /** Write a flushable page from buf_pool to a file.
 buf_pool.mutex must be held.
 @param bpage       buffer control block
@@ -888,65 +1072,34 @@ static bool buf_flush_page(buf_page_t *bpage, bool lru, fil_space_t *space)
   {
     space->reacquire();
     ut_ad(status == buf_page_t::NORMAL || status == buf_page_t::INIT_ON_FLUSH);
-    size_t size;
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-    size_t orig_size;
-#endif
-    IORequest::Type type= lru ? IORequest::WRITE_LRU : IORequest::WRITE_ASYNC;
+
+    if (lru)
+      buf_pool.n_flush_LRU++;
+    else
+      buf_pool.n_flush_list++;
 
     if (UNIV_UNLIKELY(!rw_lock)) /* ROW_FORMAT=COMPRESSED */
     {
       ut_ad(!space->full_crc32());
       ut_ad(!space->is_compressed()); /* not page_compressed */
-      size= bpage->zip_size();
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-      orig_size= size;
-#endif
+      size_t size= bpage->zip_size();
       buf_flush_update_zip_checksum(frame, size);
       frame= buf_page_encrypt(space, bpage, frame, &size);
       ut_ad(size == bpage->zip_size());
+      buf_flush_submit(bpage, space,
+                       lru ? IORequest::WRITE_LRU : IORequest::WRITE_ASYNC,
+                       frame, size);
     }
-    else
+    else if (srv_page_compression_threads && space->is_compressed() &&
+             bpage->id().page_no())
     {
-      byte *page= block->frame;
-      size= block->physical_size();
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-      orig_size= size;
-#endif
-
-      if (space->full_crc32())
-      {
-        /* innodb_checksum_algorithm=full_crc32 is not implemented for
-        ROW_FORMAT=COMPRESSED pages. */
-        ut_ad(!frame);
-	page= buf_page_encrypt(space, bpage, page, &size);
-	buf_flush_init_for_writing(block, page, nullptr, true);
-      }
-      else
-      {
-        buf_flush_init_for_writing(block, page, frame ? &bpage->zip : nullptr,
-                                   false);
-        page= buf_page_encrypt(space, bpage, frame ? frame : page, &size);
-      }
-
-#if defined HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE || defined _WIN32
-      if (size != orig_size && space->punch_hole)
-        type= lru ? IORequest::PUNCH_LRU : IORequest::PUNCH;
-#endif
-      frame=page;
+      buf_flush_compress_submit(block, space, lru);
+      /* Submit the writes of the pages that have been compressed
+      meanwhile, instead of waiting for the end of the batch. */
+      buf_flush_compress_write(lru, false);
     }
-
-    ut_ad(status == bpage->status);
-
-    if (lru)
-      buf_pool.n_flush_LRU++;
-    else
-      buf_pool.n_flush_list++;
-    if (status != buf_page_t::NORMAL || !space->use_doublewrite())
-      space->io(IORequest(type, bpage),
-                bpage->physical_offset(), size, frame, bpage);
     else
-      buf_dblwr.add_to_batch(IORequest(bpage, space->chain.start, type), size);
+      buf_flush_write_block(block, space, lru);
   }
 
   /* Increment the I/O operation count used for selecting LRU policy. */
@@ -1560,6 +1713,12 @@ ulint buf_flush_lists(ulint max_n, lsn_t lsn)
     ? buf_do_flush_list_batch(max_n, lsn)
     : buf_do_LRU_batch(max_n);
 
+  /* Any page_compressed pages of this batch must have been written or
+  added to the doublewrite batch before the batch is completed. */
+  mysql_mutex_unlock(&buf_pool.mutex);
+  buf_flush_compress_write(!lsn, true);
+  mysql_mutex_lock(&buf_pool.mutex);
+
   const auto n_flushing= --n_flush;
 
   buf_pool.try_LRU_scan= true;
@@ -1578,6 +1737,8 @@ ulint buf_flush_lists(ulint max_n, lsn_t lsn)
 
 
 /** Initiate a log checkpoint, discarding the start of the log.
+The caller must hold exclusive log_sys.latch and log_sys.mutex,
+which will be released by this function.
 @param oldest_lsn   the checkpoint LSN
 @param end_lsn      log_sys.get_lsn()
 @return true if success, false if a checkpoint write was already running */
@@ -1602,6 +1763,7 @@ static bool log_checkpoint_low(lsn_t oldest_lsn, lsn_t end_lsn)
     /* Do nothing, because nothing was logged (other than a
     FILE_CHECKPOINT record) since the previous checkpoint. */
     mysql_mutex_unlock(&log_sys.mutex);
+    log_sys.latch.wr_unlock();
     return true;
   }
 
@@ -1613,12 +1775,16 @@ static bool log_checkpoint_low(lsn_t oldest_lsn, lsn_t end_lsn)
 
   It is important that we write out the redo log before any further
   dirty pages are flushed to the tablespace files.  At this point,
-  because we hold log_sys.mutex, mtr_t::commit() in other threads will
+  because we hold log_sys.latch, mtr_t::commit() in other threads will
   be blocked, and no pages can be added to the flush lists. */
   lsn_t flush_lsn= oldest_lsn;
 
-  if (fil_names_clear(flush_lsn, oldest_lsn != end_lsn ||
-                      srv_shutdown_state <= SRV_SHUTDOWN_INITIATED))
+  const bool written= fil_names_clear(flush_lsn, oldest_lsn != end_lsn ||
+                                      srv_shutdown_state <=
+                                      SRV_SHUTDOWN_INITIATED);
+  log_sys.latch.wr_unlock();
+
+  if (written)
   {
     flush_lsn= log_sys.get_lsn();
     ut_ad(flush_lsn >= end_lsn + SIZE_OF_FILE_CHECKPOINT);
@@ -1669,6 +1835,7 @@ static bool log_checkpoint()
     fil_flush_file_spaces();
   }
 
+  log_sys.latch.wr_lock();
   mysql_mutex_lock(&log_sys.mutex);
   const lsn_t end_lsn= log_sys.get_lsn();
   mysql_mutex_lock(&log_sys.flush_order_mutex);
@@ -1815,6 +1982,7 @@ ATTRIBUTE_COLD static void buf_flush_sync_for_checkpoint(lsn_t lsn)
       fil_flush_file_spaces();
     }
 
+    log_sys.latch.wr_lock();
     mysql_mutex_lock(&log_sys.mutex);
     const lsn_t newest_lsn= log_sys.get_lsn();
     mysql_mutex_lock(&log_sys.flush_order_mutex);
@@ -1833,6 +2001,7 @@ ATTRIBUTE_COLD static void buf_flush_sync_for_checkpoint(lsn_t lsn)
     else
     {
       mysql_mutex_unlock(&log_sys.mutex);
+      log_sys.latch.wr_unlock();
       if (!measure)
         measure= LSN_MAX;
     }
@@ -29,6 +29,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "btr0btr.h"
 #include "buf0buddy.h"
 #include "buf0buf.h"
+#include "buf0dump.h"
 #include "buf0flu.h"
 #include "buf0rea.h"
 #include "btr0sea.h"
@@ -106,6 +107,95 @@ least this many milliseconds ago.  Not protected by any mutex or latch. */
 uint	buf_LRU_old_threshold_ms;
 /* @} */
 
+/** innodb_lru_policy */
+ulong	buf_LRU_policy;
+
+/** Identifiers of recently evicted pages, indexed by page_id_t::fold()
+modulo buf_LRU_ghost_size; nullptr unless innodb_lru_policy=ghost.
+Protected by buf_pool.mutex. */
+static uint64_t*	buf_LRU_ghost;
+/** Number of elements in buf_LRU_ghost */
+static ulint		buf_LRU_ghost_size;
+
+/** Allocate the list of recently evicted pages if innodb_lru_policy=ghost.
+@param n  number of pages in the buffer pool */
+void buf_LRU_ghost_create(ulint n)
+{
+  ut_ad(!buf_LRU_ghost);
+  if (buf_LRU_policy != BUF_LRU_GHOST)
+    return;
+  /* Like ARC, remember about as many evicted pages as fit in the
+  buffer pool. */
+  buf_LRU_ghost_size= ut_max(n, ulint{BUF_LRU_OLD_MIN_LEN});
+  buf_LRU_ghost= static_cast<uint64_t*>
+    (ut_malloc_nokey(buf_LRU_ghost_size * sizeof *buf_LRU_ghost));
+  memset(buf_LRU_ghost, 0xff, buf_LRU_ghost_size * sizeof *buf_LRU_ghost);
+}
+
+/** Resize the list of recently evicted pages with the buffer pool.
+The caller must hold buf_pool.mutex.
+@param n  number of pages in the buffer pool */
+void buf_LRU_ghost_resize(ulint n)
+{
+  mysql_mutex_assert_owner(&buf_pool.mutex);
+  if (!buf_LRU_ghost)
+    return;
+  n= ut_max(n, ulint{BUF_LRU_OLD_MIN_LEN});
+  if (n == buf_LRU_ghost_size)
+    return;
+  uint64_t *ghost= static_cast<uint64_t*>
+    (ut_malloc_nokey(n * sizeof *ghost));
+  memset(ghost, 0xff, n * sizeof *ghost);
+  for (ulint i= 0; i < buf_LRU_ghost_size; i++)
+    if (buf_LRU_ghost[i] != ~uint64_t{0})
+      ghost[page_id_t(buf_LRU_ghost[i]).fold() % n]= buf_LRU_ghost[i];
+  ut_free(buf_LRU_ghost);
+  buf_LRU_ghost= ghost;
+  buf_LRU_ghost_size= n;
+}
+
+/** Free the list of recently evicted pages. */
+void buf_LRU_ghost_free()
+{
+  ut_free(buf_LRU_ghost);
+  buf_LRU_ghost= nullptr;
+  buf_LRU_ghost_size= 0;
+}
+
+/** Remember that a page was evicted from the buffer pool. Only pages
+that were made young are remembered; a page that was only accessed
+within innodb_old_blocks_time of being read, such as by a table scan,
+is not.
+@param bpage  page that is being evicted */
+static void buf_LRU_ghost_add(const buf_page_t &bpage)
+{
+  mysql_mutex_assert_owner(&buf_pool.mutex);
+  if (!buf_LRU_ghost || !bpage.made_young)
+    return;
+  page_id_t id= bpage.id();
+  /* A direct-mapped slot replaces whichever page was evicted earlier
+  with the same hash value. */
+  buf_LRU_ghost[id.fold() % buf_LRU_ghost_size]= id.raw();
+  MONITOR_INC(MONITOR_LRU_GHOST_ADDED);
+}
+
+/** Check whether a page that is about to be read was evicted recently.
+The caller must hold buf_pool.mutex.
+@param id  page identifier
+@return whether the page should be added to the young sublist */
+bool buf_LRU_ghost_hit(page_id_t id)
+{
+  mysql_mutex_assert_owner(&buf_pool.mutex);
+  if (!buf_LRU_ghost)
+    return false;
+  uint64_t &ghost= buf_LRU_ghost[id.fold() % buf_LRU_ghost_size];
+  if (ghost != id.raw())
+    return false;
+  ghost= ~uint64_t{0};
+  MONITOR_INC(MONITOR_LRU_GHOST_HITS);
+  return true;
+}
+
 /** Remove bpage from buf_pool.LRU and buf_pool.page_hash.
 
 If bpage->state() == BUF_BLOCK_ZIP_PAGE && !bpage->oldest_modification(),
@@ -770,6 +860,7 @@ void buf_page_make_young(buf_page_t *bpage)
 
   buf_LRU_remove_block(bpage);
   buf_LRU_add_block(bpage, false);
+  bpage->made_young= true;
 
   mysql_mutex_unlock(&buf_pool.mutex);
 }
@@ -836,6 +927,10 @@ bool buf_LRU_free_page(buf_page_t *bpage, bool zip)
 
 	ut_ad(bpage->can_relocate());
 
+	if (!b) {
+		buf_LRU_ghost_add(*bpage);
+	}
+
 	if (!buf_LRU_block_remove_hashed(bpage, id, hash_lock, zip)) {
 		return(true);
 	}
@@ -1057,6 +1152,10 @@ static bool buf_LRU_block_remove_hashed(buf_page_t *bpage, const page_id_t id,
 
 	buf_pool.freed_page_clock += 1;
 
+	if (UNIV_UNLIKELY(buf_load_pages_lsn != 0)) {
+		buf_load_pages_evicted(*bpage);
+	}
+
 	switch (bpage->state()) {
 	case BUF_BLOCK_FILE_PAGE:
 		MEM_CHECK_ADDRESSABLE(bpage, sizeof(buf_block_t));
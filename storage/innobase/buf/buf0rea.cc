@@ -35,6 +35,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0lru.h"
 #include "buf0buddy.h"
 #include "buf0dblwr.h"
+#include "buf0dump.h"
 #include "ibuf0ibuf.h"
 #include "log0recv.h"
 #include "trx0sys.h"
@@ -80,10 +81,13 @@ and the lock released later.
 @param[in]	zip_size		ROW_FORMAT=COMPRESSED page size, or 0
 @param[in]	unzip			whether the uncompressed page is
 					requested (for ROW_FORMAT=COMPRESSED)
+@param[in]	demand			whether the page is being read
+					because it was requested, not ahead
 @return pointer to the block
 @retval	NULL	in case of an error */
 static buf_page_t* buf_page_init_for_read(ulint mode, const page_id_t page_id,
-                                          ulint zip_size, bool unzip)
+                                          ulint zip_size, bool unzip,
+                                          bool demand= false)
 {
   mtr_t mtr;
 
@@ -156,8 +160,11 @@ static buf_page_t* buf_page_init_for_read(ulint mode, const page_id_t page_id,
     HASH_INSERT(buf_page_t, hash, &buf_pool.page_hash, fold, bpage);
     hash_lock->write_unlock();
 
-    /* The block must be put to the LRU list, to the old blocks */
-    buf_LRU_add_block(bpage, true/* to old blocks */);
+    /* The block must be put to the LRU list, to the old blocks,
+    unless it was evicted recently and is requested again */
+    const bool young= demand && buf_LRU_ghost_hit(page_id);
+    buf_LRU_add_block(bpage, !young);
+    bpage->made_young= young;
 
     if (UNIV_UNLIKELY(zip_size))
     {
@@ -228,9 +235,12 @@ static buf_page_t* buf_page_init_for_read(ulint mode, const page_id_t page_id,
     bpage->set_io_fix(BUF_IO_READ);
     hash_lock->write_unlock();
 
-    /* The block must be put to the LRU list, to the old blocks.
+    /* The block must be put to the LRU list, to the old blocks,
+    unless it was evicted recently and is requested again.
     The zip size is already set into the page zip */
-    buf_LRU_add_block(bpage, true/* to old blocks */);
+    const bool young= demand && buf_LRU_ghost_hit(page_id);
+    buf_LRU_add_block(bpage, !young);
+    bpage->made_young= young;
   }
 
   mysql_mutex_unlock(&buf_pool.mutex);
@@ -261,6 +271,7 @@ flag is cleared and the x-lock released by an i/o-handler thread.
 @param[in] page_id	page id
 @param[in] zip_size	ROW_FORMAT=COMPRESSED page size, or 0
 @param[in] unzip	true=request uncompressed page
+@param[in] demand	whether the page was requested, not read ahead
 @return whether a read request was queued */
 static
 bool
@@ -271,7 +282,8 @@ buf_read_page_low(
 	ulint			mode,
 	const page_id_t		page_id,
 	ulint			zip_size,
-	bool			unzip)
+	bool			unzip,
+	bool			demand = false)
 {
 	buf_page_t*	bpage;
 
@@ -304,7 +316,8 @@ buf_read_page_low(
 	or is being dropped; if we succeed in initing the page in the buffer
 	pool for read, then DISCARD cannot proceed until the read has
 	completed */
-	bpage = buf_page_init_for_read(mode, page_id, zip_size, unzip);
+	bpage = buf_page_init_for_read(mode, page_id, zip_size, unzip,
+				       demand);
 
 	if (bpage == NULL) {
 		goto nothing_read;
@@ -481,7 +494,7 @@ dberr_t buf_read_page(const page_id_t page_id, ulint zip_size)
 
   dberr_t err;
   if (buf_read_page_low(&err, space, true, BUF_READ_ANY_PAGE,
-			page_id, zip_size, false))
+			page_id, zip_size, false, true))
     srv_stats.buf_pool_reads.add(1);
 
   buf_LRU_stat_inc_io();
@@ -534,6 +547,49 @@ void buf_read_page_background(fil_space_t *space, const page_id_t page_id,
 	ignore these in our heuristics. */
 }
 
+/** Add a page to the buffer pool from the page image that was written
+by buf_dump_pages() at the previous shutdown.
+@param space    tablespace (the caller must hold a reference)
+@param page_id  page identifier
+@param frame    contents of the page in the page image
+@return whether the page was added to the buffer pool */
+bool buf_read_page_from_image(fil_space_t *space, const page_id_t page_id,
+                              const byte *frame)
+{
+  ut_ad(!space->zip_size());
+  buf_page_t *bpage= buf_page_init_for_read(BUF_READ_ANY_PAGE, page_id, 0,
+                                            false);
+  if (!bpage)
+    /* The page is already in the buffer pool. */
+    return false;
+
+  ut_ad(bpage->state() == BUF_BLOCK_FILE_PAGE);
+  byte *dst= reinterpret_cast<buf_block_t*>(bpage)->frame;
+
+  /* Now that the page is in buf_pool.page_hash, it cannot be evicted
+  by anyone else. If it was modified and evicted before we got here,
+  read the current contents from the data file. */
+  if (UNIV_UNLIKELY(buf_load_pages_stale(page_id)))
+  {
+    space->reacquire();
+    auto fio= space->io(IORequest(IORequest::READ_SYNC),
+                        os_offset_t{page_id.page_no()} << srv_page_size_shift,
+                        srv_page_size, dst, bpage);
+    if (fio.err != DB_SUCCESS)
+    {
+      buf_pool.corrupted_evict(bpage);
+      return false;
+    }
+    space->release();
+    srv_stats.buf_pool_reads.add(1);
+  }
+  else
+    memcpy_aligned<UNIV_PAGE_SIZE_MIN>(dst, frame, srv_page_size);
+
+  return buf_page_read_complete(bpage, *UT_LIST_GET_FIRST(space->chain)) ==
+    DB_SUCCESS;
+}
+
 /** Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
 Does not read any page if the read-ahead mechanism is not activated. Note
@@ -717,6 +773,59 @@ buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf)
   return count;
 }
 
+/** Issue asynchronous reads for pages of a B-tree that a scan is about
+to access in key order (innodb_logical_read_ahead). Pages that are
+already in the buffer pool are skipped.
+NOTE: the calling thread may own latches on pages: this function does
+not wait for any page latches.
+@param space_id  tablespace identifier
+@param pages     page numbers, in the order in which they will be accessed
+@param n         number of elements in pages
+@param zip_size  ROW_FORMAT=COMPRESSED page size, or 0
+@return number of page read requests issued */
+ulint buf_read_ahead_logical(uint32_t space_id, const uint32_t *pages,
+                             ulint n, ulint zip_size)
+{
+  if (!n || srv_startup_is_before_trx_rollback_phase)
+    return 0;
+
+  if (buf_pool.n_pend_reads > buf_pool.curr_size / BUF_READ_AHEAD_PEND_LIMIT)
+    return 0;
+
+  fil_space_t *space= fil_space_t::get(space_id);
+  if (!space)
+    return 0;
+
+  ulint count= 0;
+
+  for (ulint i= 0; i < n; i++)
+  {
+    const page_id_t id{space_id, pages[i]};
+    if (space->is_stopping() || pages[i] > space->last_page_number())
+      break;
+    if (buf_pool.page_hash_contains(id))
+      continue;
+    dberr_t err;
+    space->reacquire();
+    if (buf_read_page_low(&err, space, false, BUF_READ_ANY_PAGE, id,
+                          zip_size, false))
+      count++;
+  }
+
+  if (count)
+    DBUG_PRINT("ib_buf", ("logical read-ahead %zu pages from %s",
+                          count, space->chain.start->name));
+  space->release();
+
+  /* Read ahead is considered one I/O operation for the purpose of
+  LRU policy decision. */
+  buf_LRU_stat_inc_io();
+
+  buf_pool.stat.n_ra_pages_read+= count;
+  srv_stats.buf_pool_reads.add(count);
+  return count;
+}
+
 /** Issues read requests for pages which recovery wants to read in.
 @param[in]	space_id	tablespace id
 @param[in]	page_nos	array of page numbers to read, with the
@@ -26,6 +26,7 @@ Created 10/25/1995 Heikki Tuuri
 
 #include "fil0fil.h"
 #include "fil0crypt.h"
+#include "fil0pagecompress.h"
 
 #include "btr0btr.h"
 #include "buf0buf.h"
@@ -47,6 +48,7 @@ Created 10/25/1995 Heikki Tuuri
 #include "buf0lru.h"
 #include "ibuf0ibuf.h"
 #include "buf0flu.h"
+#include "buf0dump.h"
 #ifdef UNIV_LINUX
 # include <sys/types.h>
 # include <sys/sysmacros.h>
@@ -280,6 +282,9 @@ static bool fil_comp_algo_validate(const fil_space_t* space)
 #ifdef HAVE_SNAPPY
 	case PAGE_SNAPPY_ALGORITHM:
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+#endif /* HAVE_ZSTD */
 		return true;
 	}
 
@@ -837,6 +842,7 @@ fil_space_free_low(
 	ut_ad(space->size == 0);
 
 	fil_space_destroy_crypt_data(&space->crypt_data);
+	fil_zstd_dict_free(space->zstd_dict);
 
 	space->~fil_space_t();
 	ut_free(space);
@@ -1586,6 +1592,8 @@ fil_space_t *fil_space_t::check_pending_operations(ulint id)
   if (!space)
     return nullptr;
 
+  buf_load_pages_space_stopping(uint32_t(id));
+
   for (ulint count= 0;; count++)
   {
     auto pending= space->referenced();
@@ -2994,6 +3002,57 @@ fil_io_t fil_space_t::io(const IORequest &type, os_offset_t offset, size_t len,
 
 #include <tpool.h>
 
+/** Complete a read of a page into the buffer pool, and release the
+tablespace reference that was acquired for the read.
+@param bpage   page that was read
+@param node    data file */
+static void fil_read_complete(buf_page_t *bpage, fil_node_t *node)
+{
+  /* IMPORTANT: since i/o handling for reads will read also the insert
+  buffer in fil_system.sys_space, we have to be very careful not to
+  introduce deadlocks. We never close fil_system.sys_space data
+  files and never issue asynchronous reads of change buffer pages. */
+  const page_id_t id(bpage->id());
+
+  if (dberr_t err= buf_page_read_complete(bpage, *node))
+  {
+    if (recv_recovery_is_on() && !srv_force_recovery)
+    {
+      mysql_mutex_lock(&recv_sys.mutex);
+      recv_sys.set_corrupt_fs();
+      mysql_mutex_unlock(&recv_sys.mutex);
+    }
+
+    ib::error() << "Failed to read page " << id.page_no()
+                << " from file '" << node->name << "': " << err;
+  }
+
+  node->space->release();
+}
+
+/** The completion of a page_compressed page read, which is decompressed
+in buf_page_compression_group (innodb_page_compression_threads) so that
+the CPU time of decompression does not hold up the read i/o callbacks */
+struct fil_decompress_task : tpool::task
+{
+  /** page that was read */
+  buf_page_t *const bpage;
+  /** data file */
+  fil_node_t *const node;
+
+  fil_decompress_task(buf_page_t *bpage, fil_node_t *node) :
+    tpool::task(execute_callback, this, &buf_page_compression_group),
+    bpage(bpage), node(node) {}
+
+  static void execute_callback(void *arg)
+  {
+    auto t= static_cast<const fil_decompress_task*>(arg);
+    fil_read_complete(t->bpage, t->node);
+  }
+
+  void release() override { delete this; }
+};
+
 /** Callback for AIO completion */
 void fil_aio_callback(const IORequest &request)
 {
@@ -3019,24 +3078,17 @@ void fil_aio_callback(const IORequest &request)
   {
     ut_ad(request.is_read());
 
-    /* IMPORTANT: since i/o handling for reads will read also the insert
-    buffer in fil_system.sys_space, we have to be very careful not to
-    introduce deadlocks. We never close fil_system.sys_space data
-    files and never issue asynchronous reads of change buffer pages. */
-    const page_id_t id(request.bpage->id());
-
-    if (dberr_t err= buf_page_read_complete(request.bpage, *request.node))
-    {
-      if (recv_recovery_is_on() && !srv_force_recovery)
-      {
-        mysql_mutex_lock(&recv_sys.mutex);
-        recv_sys.set_corrupt_fs();
-        mysql_mutex_unlock(&recv_sys.mutex);
-      }
-
-      ib::error() << "Failed to read page " << id.page_no()
-                  << " from file '" << request.node->name << "': " << err;
-    }
+    /* Recovery waits for the read i/o callbacks in
+    os_aio_wait_until_no_pending_reads(), so it must apply the log
+    in them. */
+    if (srv_page_compression_threads &&
+        request.node->space->is_compressed() &&
+        request.bpage->id().page_no() && !recv_recovery_is_on())
+      srv_thread_pool->submit_task(new fil_decompress_task(request.bpage,
+                                                           request.node));
+    else
+      fil_read_complete(request.bpage, request.node);
+    return;
   }
 
   request.node->space->release();
@@ -3229,7 +3281,7 @@ void fil_names_dirty_and_write(fil_space_t* space)
 {
 	mysql_mutex_assert_owner(&log_sys.mutex);
 	ut_d(fil_space_validate_for_mtr_commit(space));
-	ut_ad(space->max_lsn == log_sys.get_lsn());
+	ut_ad(space->max_lsn <= log_sys.get_lsn());
 
 	fil_system.named_spaces.push_back(*space);
 	mtr_t mtr;
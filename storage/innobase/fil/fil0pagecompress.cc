@@ -70,6 +70,330 @@ Updated 14/02/2015
 #ifdef HAVE_SNAPPY
 #include "snappy-c.h"
 #endif
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#include "zdict.h"
+#include <mutex>
+#include <vector>
+
+/** Magic bytes that precede the length of the zstd dictionary
+at the end of the first page of a page_compressed tablespace */
+static const byte FIL_ZSTD_DICT_MAGIC[4] = {'Z', 'D', 'I', 'C'};
+/** Size of the zstd dictionary trailer: magic and 4-byte length */
+static constexpr ulint FIL_ZSTD_DICT_TRAILER = sizeof FIL_ZSTD_DICT_MAGIC + 4;
+/** Bytes reserved for fil_space_crypt_t::write_page0() after the
+extent descriptors on the first page */
+static constexpr ulint FIL_ZSTD_DICT_CRYPT_RESERVED = 64;
+/** Maximum size of a zstd dictionary */
+static constexpr ulint FIL_ZSTD_DICT_MAX = 16384;
+/** Maximum number of index pages to train a zstd dictionary on */
+static constexpr ulint FIL_ZSTD_DICT_SAMPLES = 128;
+
+/** Number of compression levels of page_compression_level and
+innodb_compression_level (1 to 9), plus the unused level 0 */
+static constexpr unsigned FIL_ZSTD_DICT_LEVELS = 10;
+
+/** Serializes fil_zstd_dict_train() */
+static std::mutex fil_zstd_train_mutex;
+#endif /* HAVE_ZSTD */
+
+/** Trained zstd dictionary of a page_compressed tablespace */
+struct fil_zstd_dict_t
+{
+#ifdef HAVE_ZSTD
+	/** dictionary identifier, stored in each compressed frame */
+	unsigned	id;
+	/** dictionary digested for compression, indexed by the
+	compression level; created on demand by fil_zstd_dict_cdict() */
+	mutable std::atomic<ZSTD_CDict*> cdict[FIL_ZSTD_DICT_LEVELS];
+	/** dictionary digested for decompression */
+	ZSTD_DDict*	ddict;
+	/** length of data */
+	ulint		len;
+	/** the dictionary */
+	byte		data[1];
+#endif /* HAVE_ZSTD */
+};
+
+#ifdef HAVE_ZSTD
+/** zstd compression and decompression contexts of the current thread */
+static thread_local struct fil_zstd_ctx_t
+{
+	ZSTD_CCtx*	cctx = nullptr;
+	ZSTD_DCtx*	dctx = nullptr;
+
+	~fil_zstd_ctx_t()
+	{
+		ZSTD_freeCCtx(cctx);
+		ZSTD_freeDCtx(dctx);
+	}
+} fil_zstd_ctx;
+
+/** @return offset of the zstd dictionary trailer in the first page */
+static ulint fil_zstd_dict_trailer()
+{
+	return srv_page_size - FIL_PAGE_DATA_END - FIL_ZSTD_DICT_TRAILER;
+}
+
+/** @return maximum size of a zstd dictionary in the first page */
+static ulint fil_zstd_dict_max_len()
+{
+	const ulint start = FSP_HEADER_OFFSET
+		+ fsp_header_get_encryption_offset(0)
+		+ FIL_ZSTD_DICT_CRYPT_RESERVED;
+	return std::min(fil_zstd_dict_trailer() - start, FIL_ZSTD_DICT_MAX);
+}
+
+/** Digest a zstd dictionary.
+@param[in]	data	dictionary
+@param[in]	len	length of the dictionary
+@return the digested dictionary
+@retval	nullptr	if the dictionary is not valid */
+static fil_zstd_dict_t* fil_zstd_dict_create(const byte* data, ulint len)
+{
+	const unsigned id = ZDICT_getDictID(data, len);
+	if (!id) {
+		return nullptr;
+	}
+
+	void* ptr = ut_malloc_nokey(sizeof(fil_zstd_dict_t) + len);
+	if (!ptr) {
+		return nullptr;
+	}
+
+	fil_zstd_dict_t* dict = new (ptr) fil_zstd_dict_t;
+	dict->id = id;
+	for (auto& cdict : dict->cdict) {
+		cdict.store(nullptr, std::memory_order_relaxed);
+	}
+	dict->len = len;
+	memcpy(dict->data, data, len);
+	dict->ddict = ZSTD_createDDict(data, len);
+
+	if (!dict->ddict) {
+		fil_zstd_dict_free(dict);
+		return nullptr;
+	}
+
+	return dict;
+}
+
+/** Get the dictionary digested for compression at a level. The pages of
+a tablespace are compressed at its page_compression_level, or at the
+current innodb_compression_level, so each level is digested once, on
+first use.
+@param[in]	dict	dictionary
+@param[in]	level	compression level
+@return the digested dictionary
+@retval	nullptr	if out of memory */
+static const ZSTD_CDict* fil_zstd_dict_cdict(const fil_zstd_dict_t* dict,
+					     unsigned level)
+{
+	std::atomic<ZSTD_CDict*>& slot
+		= dict->cdict[std::min(level, FIL_ZSTD_DICT_LEVELS - 1)];
+
+	if (ZSTD_CDict* cdict = slot.load(std::memory_order_acquire)) {
+		return cdict;
+	}
+
+	ZSTD_CDict* cdict = ZSTD_createCDict(dict->data, dict->len,
+					     int(level));
+	ZSTD_CDict* expected = nullptr;
+
+	if (cdict && !slot.compare_exchange_strong(
+		    expected, cdict, std::memory_order_acq_rel)) {
+		/* Another thread digested the dictionary meanwhile. */
+		ZSTD_freeCDict(cdict);
+		cdict = expected;
+	}
+
+	return cdict;
+}
+#endif /* HAVE_ZSTD */
+
+/** Read the zstd dictionary from the first page of a page_compressed
+tablespace.
+@param[in]	page	first page of the tablespace
+@return the dictionary, to be freed by fil_zstd_dict_free()
+@retval	nullptr	if the page does not carry a dictionary */
+fil_zstd_dict_t* fil_zstd_dict_read(const byte* page)
+{
+#ifdef HAVE_ZSTD
+	const byte* trailer = page + fil_zstd_dict_trailer();
+
+	if (memcmp(trailer, FIL_ZSTD_DICT_MAGIC, sizeof FIL_ZSTD_DICT_MAGIC)) {
+		return nullptr;
+	}
+
+	const ulint len = mach_read_from_4(
+		trailer + sizeof FIL_ZSTD_DICT_MAGIC);
+
+	if (len && len <= fil_zstd_dict_max_len()) {
+		if (fil_zstd_dict_t* dict = fil_zstd_dict_create(
+			    trailer - len, len)) {
+			return dict;
+		}
+	}
+
+	ib::error() << "Ignoring invalid zstd dictionary in tablespace "
+		    << mach_read_from_4(page + FIL_PAGE_SPACE_ID);
+#endif /* HAVE_ZSTD */
+	return nullptr;
+}
+
+/** Free a zstd dictionary.
+@param[in,out]	dict	dictionary returned by fil_zstd_dict_read(),
+or nullptr */
+void fil_zstd_dict_free(fil_zstd_dict_t* dict)
+{
+	if (dict) {
+#ifdef HAVE_ZSTD
+		for (auto& cdict : dict->cdict) {
+			ZSTD_freeCDict(cdict.load(std::memory_order_relaxed));
+		}
+		ZSTD_freeDDict(dict->ddict);
+		dict->~fil_zstd_dict_t();
+#endif /* HAVE_ZSTD */
+		ut_free(dict);
+	}
+}
+
+/** Determine if fil_zstd_dict_train() can train a dictionary.
+@param[in]	space	tablespace
+@return whether the tablespace is page_compressed with zstd */
+bool fil_zstd_dict_applicable(const fil_space_t& space)
+{
+#ifdef HAVE_ZSTD
+	return space.is_compressed()
+		&& (space.full_crc32()
+		    ? space.get_compression_algo()
+		    : innodb_compression_algorithm) == PAGE_ZSTD_ALGORITHM;
+#else
+	return false;
+#endif /* HAVE_ZSTD */
+}
+
+/** Train a zstd dictionary on a sample of the index pages of a
+page_compressed tablespace, store it in the first page, and start
+compressing pages with it. Once stored, the dictionary is never replaced,
+because the pages that were compressed with it refer to it.
+@param[in,out]	space	page_compressed tablespace
+@return error code
+@retval	DB_SUCCESS	if the tablespace has a dictionary
+@retval	DB_UNSUPPORTED	if the tablespace is not compressed with zstd */
+dberr_t fil_zstd_dict_train(fil_space_t* space)
+{
+#ifdef HAVE_ZSTD
+	if (!fil_zstd_dict_applicable(*space)) {
+		return DB_UNSUPPORTED;
+	}
+
+	std::lock_guard<std::mutex> g(fil_zstd_train_mutex);
+
+	if (space->zstd_dict) {
+		return DB_SUCCESS;
+	}
+
+	if (!space->acquire()) {
+		return DB_TABLESPACE_DELETED;
+	}
+
+	/* Sample the index pages evenly across the file. Page 0 is the
+	file header, 1 the change buffer bitmap and 2 the index nodes. */
+	const uint32_t first = FSP_FIRST_INODE_PAGE_NO + 1;
+	const uint32_t limit = std::min(space->free_limit, space->size);
+	const uint32_t step = limit > first
+		? std::max<uint32_t>(1, uint32_t((limit - first)
+						 / FIL_ZSTD_DICT_SAMPLES))
+		: 1;
+	std::vector<byte> samples;
+	std::vector<size_t> sizes;
+	dberr_t err = DB_SUCCESS;
+
+	for (uint32_t page_no = first;
+	     page_no < limit && sizes.size() < FIL_ZSTD_DICT_SAMPLES
+	     && !space->is_stopping();
+	     page_no += step) {
+		mtr_t mtr;
+		mtr.start();
+		if (const buf_block_t* block = buf_page_get_gen(
+			    page_id_t(space->id, page_no), 0, RW_S_LATCH,
+			    nullptr, BUF_GET_POSSIBLY_FREED, &mtr)) {
+			if (block->page.status != buf_page_t::FREED
+			    && fil_page_get_type(block->frame)
+			    == FIL_PAGE_INDEX) {
+				samples.insert(samples.end(), block->frame,
+					       block->frame + srv_page_size);
+				sizes.push_back(srv_page_size);
+			}
+		}
+		mtr.commit();
+	}
+
+	std::vector<byte> data(fil_zstd_dict_max_len());
+	const size_t len = samples.empty()
+		? 0
+		: ZDICT_trainFromBuffer(data.data(), data.size(),
+					samples.data(), sizes.data(),
+					unsigned(sizes.size()));
+	fil_zstd_dict_t* dict = nullptr;
+
+	if (!len || ZDICT_isError(len)) {
+		ib::warn() << "Cannot train a zstd dictionary for "
+			   << space->chain.start->name << " on "
+			   << sizes.size() << " pages"
+			   << (len ? ": " : "")
+			   << (len ? ZDICT_getErrorName(len) : "");
+		err = DB_ERROR;
+		goto func_exit;
+	}
+
+	dict = fil_zstd_dict_create(data.data(), len);
+	if (!dict) {
+		err = DB_OUT_OF_MEMORY;
+		goto func_exit;
+	}
+
+	{
+		mtr_t mtr;
+		mtr.start();
+		buf_block_t* block = buf_page_get_gen(
+			page_id_t(space->id, 0), 0, RW_X_LATCH, nullptr,
+			BUF_GET_POSSIBLY_FREED, &mtr);
+		if (!block || block->page.status == buf_page_t::FREED) {
+			mtr.commit();
+			fil_zstd_dict_free(dict);
+			err = DB_CORRUPTION;
+			goto func_exit;
+		}
+
+		mtr.set_named_space(space);
+		byte* trailer = block->frame + fil_zstd_dict_trailer();
+		mtr.memcpy(*block, trailer - len, data.data(), len);
+		byte buf[FIL_ZSTD_DICT_TRAILER];
+		memcpy(buf, FIL_ZSTD_DICT_MAGIC, sizeof FIL_ZSTD_DICT_MAGIC);
+		mach_write_to_4(buf + sizeof FIL_ZSTD_DICT_MAGIC, len);
+		mtr.memcpy(*block, trailer, buf, sizeof buf);
+		mtr.commit();
+	}
+
+	/* The dictionary must be durable in the first page before
+	any page that was compressed with it can be written, because
+	fil_node_t::read_page0() loads it before any recovery. */
+	while (buf_flush_dirty_pages(space->id));
+	space->flush<true>();
+	space->zstd_dict = dict;
+
+	ib::info() << "Trained a zstd dictionary of " << len
+		   << " bytes for " << space->chain.start->name << " on "
+		   << sizes.size() << " pages";
+func_exit:
+	space->release();
+	return err;
+#else
+	return DB_UNSUPPORTED;
+#endif /* HAVE_ZSTD */
+}
 
 /** Compress a page for the given compression algorithm.
 @param[in]	buf		page to be compressed
@@ -77,14 +401,16 @@ Updated 14/02/2015
 @param[in]	header_len	header length of the page
 @param[in]	comp_algo	compression algorithm
 @param[in]	comp_level	compression level
+@param[in]	dict		zstd dictionary, or nullptr
 @return actual length of compressed page data
 @retval 0 if the page was not compressed */
 static ulint fil_page_compress_low(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		header_len,
-	ulint		comp_algo,
-	unsigned	comp_level)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			header_len,
+	ulint			comp_algo,
+	unsigned		comp_level,
+	const fil_zstd_dict_t*	dict)
 {
 	ulint write_size = srv_page_size - header_len;
 
@@ -180,6 +506,35 @@ static ulint fil_page_compress_low(
 		break;
 	}
 #endif /* HAVE_SNAPPY */
+
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM: {
+		ZSTD_CCtx*& cctx = fil_zstd_ctx.cctx;
+		if (!cctx && !(cctx = ZSTD_createCCtx())) {
+			break;
+		}
+
+		const ZSTD_CDict* cdict = dict
+			? fil_zstd_dict_cdict(dict, comp_level)
+			: nullptr;
+		if (dict && !cdict) {
+			break;
+		}
+
+		size_t len = cdict
+			? ZSTD_compress_usingCDict(
+				cctx, out_buf + header_len, write_size,
+				buf, srv_page_size, cdict)
+			: ZSTD_compressCCtx(
+				cctx, out_buf + header_len, write_size,
+				buf, srv_page_size, int(comp_level));
+
+		if (!ZSTD_isError(len)) {
+			return len;
+		}
+		break;
+	}
+#endif /* HAVE_ZSTD */
 	}
 
 	return 0;
@@ -190,14 +545,16 @@ static ulint fil_page_compress_low(
 @param[out]	out_buf		compressed page
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
+@param[in]	dict		zstd dictionary, or nullptr
 @return actual length of compressed page
 @retval 0 if the page was not compressed */
 static ulint fil_page_compress_for_full_crc32(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
 {
 	ulint comp_level = FSP_FLAGS_GET_PAGE_COMPRESSION_LEVEL(flags);
 
@@ -210,7 +567,7 @@ static ulint fil_page_compress_for_full_crc32(
 	ulint write_size = fil_page_compress_low(
 		buf, out_buf, header_len,
 		fil_space_t::get_compression_algo(flags),
-		static_cast<unsigned>(comp_level));
+		static_cast<unsigned>(comp_level), dict);
 
 	if (write_size == 0) {
 fail:
@@ -254,6 +611,10 @@ static ulint fil_page_compress_for_full_crc32(
 
 	srv_stats.page_compression_saved.add(srv_page_size - write_size);
 	srv_stats.pages_page_compressed.inc();
+	if (dict && fil_space_t::get_compression_algo(flags)
+	    == PAGE_ZSTD_ALGORITHM) {
+		srv_stats.pages_page_compressed_dict.inc();
+	}
 
 	return write_size;
 }
@@ -264,14 +625,16 @@ static ulint fil_page_compress_for_full_crc32(
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
 @param[in]	encrypted	whether the page will be subsequently encrypted
+@param[in]	dict		zstd dictionary, or nullptr
 @return actual length of compressed page
 @retval        0       if the page was not compressed */
 static ulint fil_page_compress_for_non_full_crc32(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
 {
 	uint comp_level = static_cast<uint>(
 		FSP_FLAGS_GET_PAGE_COMPRESSION_LEVEL(flags));
@@ -291,7 +654,7 @@ static ulint fil_page_compress_for_non_full_crc32(
 
 	ulint write_size = fil_page_compress_low(
 				buf, out_buf,
-				header_len, comp_algo, comp_level);
+				header_len, comp_algo, comp_level, dict);
 
 	if (write_size == 0) {
 		srv_stats.pages_page_compression_error.inc();
@@ -363,6 +726,9 @@ static ulint fil_page_compress_for_non_full_crc32(
 
 	srv_stats.page_compression_saved.add(srv_page_size - write_size);
 	srv_stats.pages_page_compressed.inc();
+	if (dict && comp_algo == PAGE_ZSTD_ALGORITHM) {
+		srv_stats.pages_page_compressed_dict.inc();
+	}
 
 	return write_size;
 }
@@ -373,14 +739,16 @@ static ulint fil_page_compress_for_non_full_crc32(
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
 @param[in]	encrypted	whether the page will be subsequently encrypted
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return actual length of compressed page
 @retval	0	if the page was not compressed */
 ulint fil_page_compress(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict)
 {
 	/* The full_crc32 page_compressed format assumes this. */
 	ut_ad(!(block_size & 255));
@@ -398,11 +766,12 @@ ulint fil_page_compress(
 
 	if (fil_space_t::full_crc32(flags)) {
 		return fil_page_compress_for_full_crc32(
-				buf, out_buf, flags, block_size, encrypted);
+				buf, out_buf, flags, block_size, encrypted,
+				dict);
 	}
 
 	return fil_page_compress_for_non_full_crc32(
-			buf, out_buf, flags, block_size, encrypted);
+			buf, out_buf, flags, block_size, encrypted, dict);
 }
 
 /** Decompress a page that may be subject to page_compressed compression.
@@ -411,13 +780,15 @@ ulint fil_page_compress(
 @param[in]	comp_algo	compression algorithm
 @param[in]	header_len	header length of the page
 @param[in]	actual size	actual size of the page
+@param[in]	dict		zstd dictionary, or nullptr
 @retval true if the page is decompressed or false */
 static bool fil_page_decompress_low(
-	byte*		tmp_buf,
-	byte*		buf,
-	ulint		comp_algo,
-	ulint		header_len,
-	ulint		actual_size)
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			comp_algo,
+	ulint			header_len,
+	ulint			actual_size,
+	const fil_zstd_dict_t*	dict)
 {
 	switch (comp_algo) {
 	default:
@@ -490,6 +861,32 @@ static bool fil_page_decompress_low(
 				&& olen == srv_page_size;
 		}
 #endif /* HAVE_SNAPPY */
+#ifdef HAVE_ZSTD
+	case PAGE_ZSTD_ALGORITHM:
+		{
+			ZSTD_DCtx*& dctx = fil_zstd_ctx.dctx;
+			if (!dctx && !(dctx = ZSTD_createDCtx())) {
+				return false;
+			}
+
+			const byte* src = buf + header_len;
+
+			if (unsigned id = ZSTD_getDictID_fromFrame(
+				    src, actual_size)) {
+				/* The dictionary is only ever stored once
+				per tablespace. */
+				return dict && dict->id == id
+					&& ZSTD_decompress_usingDDict(
+						dctx, tmp_buf, srv_page_size,
+						src, actual_size, dict->ddict)
+					== srv_page_size;
+			}
+
+			return ZSTD_decompressDCtx(
+				dctx, tmp_buf, srv_page_size,
+				src, actual_size) == srv_page_size;
+		}
+#endif /* HAVE_ZSTD */
 	}
 
 	return false;
@@ -499,10 +896,12 @@ static bool fil_page_decompress_low(
 @param[in,out]	tmp_buf	temporary buffer (of innodb_page_size)
 @param[in,out]	buf	possibly compressed page buffer
 @param[in]	flags	tablespace flags
+@param[in]	dict	zstd dictionary, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
-ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags)
+ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags,
+					 const fil_zstd_dict_t* dict)
 {
 	ut_ad(fil_space_t::full_crc32(flags));
 	bool compressed = false;
@@ -532,7 +931,7 @@ ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags)
 
 	if (!fil_page_decompress_low(tmp_buf, buf,
 				     fil_space_t::get_compression_algo(flags),
-				     header_len, size - header_len)) {
+				     header_len, size - header_len, dict)) {
 		return 0;
 	}
 
@@ -544,12 +943,14 @@ ulint fil_page_decompress_for_full_crc32(byte* tmp_buf, byte* buf, ulint flags)
 /** Decompress a page for non full crc32 format.
 @param[in,out] tmp_buf	temporary buffer (of innodb_page_size)
 @param[in,out] buf	possibly compressed page buffer
+@param[in]	dict	zstd dictionary, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
 ulint fil_page_decompress_for_non_full_crc32(
-	byte*	tmp_buf,
-	byte*	buf)
+	byte*			tmp_buf,
+	byte*			buf,
+	const fil_zstd_dict_t*	dict)
 {
 	ulint header_len;
 	uint comp_algo;
@@ -584,7 +985,7 @@ ulint fil_page_decompress_for_non_full_crc32(
 	}
 
 	if (!fil_page_decompress_low(tmp_buf, buf, comp_algo, header_len,
-				     actual_size)) {
+				     actual_size, dict)) {
 		return 0;
 	}
 
@@ -596,17 +997,21 @@ ulint fil_page_decompress_for_non_full_crc32(
 /** Decompress a page that may be subject to page_compressed compression.
 @param[in,out]	tmp_buf		temporary buffer (of innodb_page_size)
 @param[in,out]	buf		possibly compressed page buffer
+@param[in]	flags		tablespace flags
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
 ulint fil_page_decompress(
-	byte*	tmp_buf,
-	byte*	buf,
-	ulint	flags)
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			flags,
+	const fil_zstd_dict_t*	dict)
 {
 	if (fil_space_t::full_crc32(flags)) {
-		return fil_page_decompress_for_full_crc32(tmp_buf, buf, flags);
+		return fil_page_decompress_for_full_crc32(tmp_buf, buf, flags,
+							  dict);
 	}
 
-	return fil_page_decompress_for_non_full_crc32(tmp_buf, buf);
+	return fil_page_decompress_for_non_full_crc32(tmp_buf, buf, dict);
 }
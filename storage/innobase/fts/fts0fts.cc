@@ -3796,18 +3796,40 @@ fts_sync_add_deleted_cache(
 	return(error);
 }
 
+/** Stop releasing the cache lock while writing nodes, once the cache
+has grown past innodb_ft_cache_size. Both the nodes that are being written
+and the documents that were added while the lock was released count
+against that limit. This is only checked when a pass over the cache
+starts, so that a pass never starts blocking the writers halfway. Because
+the cache only grows until the SYNC clears it, the SYNC finishes even when
+insert/update keeps coming: eventually a pass writes the remaining nodes
+with the lock held.
+@param[in,out]	sync	sync state */
+static
+void
+fts_sync_check_cache_full(
+	fts_sync_t*	sync)
+{
+	const fts_cache_t*	cache = sync->table->fts->cache;
+
+	mysql_mutex_assert_owner(&cache->lock);
+
+	if (sync->unlock_cache && cache->total_size > fts_max_cache_size) {
+		sync->unlock_cache = false;
+	}
+}
+
 /** Write the words and ilist to disk.
-@param[in,out]	trx		transaction
+@param[in,out]	sync		sync state
 @param[in]	index_cache	index cache
-@param[in]	unlock_cache	whether unlock cache when write node
 @return DB_SUCCESS if all went well else error code */
 static MY_ATTRIBUTE((nonnull, warn_unused_result))
 dberr_t
 fts_sync_write_words(
-	trx_t*			trx,
-	fts_index_cache_t*	index_cache,
-	bool			unlock_cache)
+	fts_sync_t*		sync,
+	fts_index_cache_t*	index_cache)
 {
+	trx_t*		trx = sync->trx;
 	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
 	ulint		n_words = 0;
@@ -3815,6 +3837,7 @@ fts_sync_write_words(
 	dberr_t		error = DB_SUCCESS;
 	ibool		print_error = FALSE;
 	dict_table_t*	table = index_cache->index->table;
+	fts_cache_t*	cache = table->fts->cache;
 
 	FTS_INIT_INDEX_TABLE(
 		&fts_table, NULL, FTS_INDEX_TABLE, index_cache->index);
@@ -3858,9 +3881,10 @@ fts_sync_write_words(
 
 			/*FIXME: we need to handle the error properly. */
 			if (error == DB_SUCCESS) {
+				const bool unlock_cache = sync->unlock_cache;
+
 				if (unlock_cache) {
-					mysql_mutex_unlock(
-						&table->fts->cache->lock);
+					mysql_mutex_unlock(&cache->lock);
 				}
 
 				error = fts_write_node(
@@ -3869,6 +3893,9 @@ fts_sync_write_words(
 					&fts_table, &word->text, fts_node);
 
 				DEBUG_SYNC_C("fts_write_node");
+				if (sync->catch_up) {
+					DEBUG_SYNC_C("fts_sync_catch_up");
+				}
 				DBUG_EXECUTE_IF("fts_write_node_crash",
 					DBUG_SUICIDE(););
 
@@ -3878,8 +3905,7 @@ fts_sync_write_words(
 						std::chrono::seconds(1)););
 
 				if (unlock_cache) {
-					mysql_mutex_lock(
-						&table->fts->cache->lock);
+					mysql_mutex_lock(&cache->lock);
 				}
 			}
 		}
@@ -3949,7 +3975,7 @@ fts_sync_index(
 
 	ut_ad(rbt_validate(index_cache->words));
 
-	return(fts_sync_write_words(trx, index_cache, sync->unlock_cache));
+	return(fts_sync_write_words(sync, index_cache));
 }
 
 /** Check if index cache has been synced completely
@@ -4154,18 +4180,14 @@ fts_sync(
 	}
 
 	sync->unlock_cache = unlock_cache;
+	sync->catch_up = false;
 	sync->in_progress = true;
 
 	DEBUG_SYNC_C("fts_sync_begin");
 	fts_sync_begin(sync);
 
 begin_sync:
-	if (cache->total_size > fts_max_cache_size) {
-		/* Avoid the case: sync never finish when
-		insert/update keeps comming. */
-		ut_ad(sync->unlock_cache);
-		sync->unlock_cache = false;
-	}
+	fts_sync_check_cache_full(sync);
 
 	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
 		fts_index_cache_t*	index_cache;
@@ -4207,6 +4229,9 @@ fts_sync(
 			continue;
 		}
 
+		/* Write the nodes that were added while the previous pass
+		released the cache lock. */
+		sync->catch_up = true;
 		goto begin_sync;
 	}
 
@@ -35,6 +35,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "fts0types.h"
 #include "fts0plugin.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -57,6 +58,200 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 
 typedef std::vector<fts_string_t, ut_allocator<fts_string_t> >	word_vector_t;
 
+/** @return the doc id of an element of a doc id array */
+static inline doc_id_t fts_doc_id_of(doc_id_t doc_id) { return(doc_id); }
+
+/** @return the doc id of an element of a doc id array */
+template<typename T>
+static inline doc_id_t fts_doc_id_of(const T& elem) { return(elem.doc_id); }
+
+/** Find the first element of an array sorted by doc id that is not less
+than a doc id. The doc ids of an ilist and of the ranking trees are visited
+in ascending order, so the search gallops forward from where the previous
+lookup ended instead of bisecting the whole array for every doc id.
+@param[in]	arr	array sorted by doc id
+@param[in]	size	number of elements in arr
+@param[in]	lo	position where the previous lookup ended
+@param[in]	doc_id	doc id to look up
+@return position of the first element not less than doc_id */
+template<typename T>
+static
+ulint
+fts_gallop(
+	const T*	arr,
+	ulint		size,
+	ulint		lo,
+	doc_id_t	doc_id)
+{
+	ut_ad(lo <= size);
+
+	if (lo > 0 && fts_doc_id_of(arr[lo - 1]) >= doc_id) {
+		/* The doc ids are not ascending; restart the search. */
+		lo = 0;
+	}
+
+	/* All elements before lo are less than doc_id. Double the
+	stride until an element that is not less than doc_id is found. */
+	ulint	hi = lo;
+
+	for (ulint step = 1; hi < size && fts_doc_id_of(arr[hi]) < doc_id;
+	     step <<= 1) {
+		lo = hi + 1;
+		hi += step;
+	}
+
+	if (hi > size) {
+		hi = size;
+	}
+
+	/* Find the first element in [lo, hi) not less than doc_id. */
+	while (lo < hi) {
+		ulint	mid = (lo + hi) >> 1;
+
+		if (fts_doc_id_of(arr[mid]) < doc_id) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return(lo);
+}
+
+/** A set of elements that are identified by doc id, for looking up the
+doc ids of ilists. Each lookup gallops from the position where the
+previous one ended. Elements are inserted after a failed lookup of their
+doc id; while the lookups ascend, they are appended to a tail, which is
+merged into the sorted elements when the lookups restart from a lower doc
+id. That happens once per ilist or wildcard word, so an insertion never
+has to shift the whole array. */
+template<typename T>
+class fts_doc_id_set_t
+{
+	typedef std::vector<T, ut_allocator<T> >	vector_t;
+public:
+	fts_doc_id_set_t() : m_pos(0), m_tail_pos(0), m_last(0) {}
+
+	/** Look up a doc id.
+	@param[in]	doc_id	doc id to look up
+	@return the element, or NULL if there is none */
+	T* find(doc_id_t doc_id)
+	{
+		if (doc_id < m_last) {
+			merge();
+		}
+
+		m_last = doc_id;
+
+		m_pos = fts_gallop(m_elems.data(), m_elems.size(),
+				   m_pos, doc_id);
+
+		if (m_pos < m_elems.size()
+		    && m_elems[m_pos].doc_id == doc_id) {
+			return(&m_elems[m_pos]);
+		}
+
+		m_tail_pos = fts_gallop(m_tail.data(), m_tail.size(),
+					m_tail_pos, doc_id);
+
+		if (m_tail_pos < m_tail.size()
+		    && m_tail[m_tail_pos].doc_id == doc_id) {
+			return(&m_tail[m_tail_pos]);
+		}
+
+		return(NULL);
+	}
+
+	/** Insert an element whose doc id the previous find() did not find.
+	@param[in]	elem	element to insert
+	@return the inserted element */
+	T* insert(const T& elem)
+	{
+		ut_ad(elem.doc_id == m_last);
+		ut_ad(m_tail.empty() || m_tail.back().doc_id < elem.doc_id);
+		m_tail.push_back(elem);
+		return(&m_tail.back());
+	}
+
+	/** Append an element whose doc id is greater than that of any
+	element in the set.
+	@param[in]	elem	element to append */
+	void push_back(const T& elem)
+	{
+		ut_ad(m_tail.empty());
+		ut_ad(m_elems.empty() || m_elems.back().doc_id < elem.doc_id);
+		m_elems.push_back(elem);
+	}
+
+	/** @return the elements in ascending order of doc id */
+	const vector_t& elements()
+	{
+		merge();
+		return(m_elems);
+	}
+
+	/** @return the number of elements */
+	ulint size() const { return(m_elems.size() + m_tail.size()); }
+
+	/** Remove all elements */
+	void clear()
+	{
+		m_elems.clear();
+		m_tail.clear();
+		m_pos = m_tail_pos = 0;
+		m_last = 0;
+	}
+
+private:
+	/** Merge the tail into the sorted elements and restart the
+	lookups from the first element. */
+	void merge()
+	{
+		if (!m_tail.empty()) {
+			const ulint	n = m_elems.size();
+
+			m_elems.insert(m_elems.end(),
+				       m_tail.begin(), m_tail.end());
+			std::inplace_merge(m_elems.begin(),
+					   m_elems.begin() + n,
+					   m_elems.end(), less);
+			m_tail.clear();
+		}
+
+		m_pos = m_tail_pos = 0;
+		m_last = 0;
+	}
+
+	/** Order elements by doc id */
+	static bool less(const T& a, const T& b)
+	{
+		return(a.doc_id < b.doc_id);
+	}
+
+	/** Elements in ascending order of doc id */
+	vector_t	m_elems;
+	/** Elements inserted since the last merge(), in ascending
+	order of doc id */
+	vector_t	m_tail;
+	/** Position in m_elems where the previous lookup ended */
+	ulint		m_pos;
+	/** Position in m_tail where the previous lookup ended */
+	ulint		m_tail_pos;
+	/** The doc id of the previous lookup */
+	doc_id_t	m_last;
+};
+
+/** An element of fts_query_t::doc_ids, identified by doc id */
+struct fts_doc_ref_t {
+	doc_id_t	doc_id;		/*!< Document id */
+
+	fts_ranking_t*	ranking;	/*!< The element of doc_ids, or NULL
+					if it was removed from doc_ids */
+};
+
+typedef fts_doc_id_set_t<fts_doc_ref_t>	fts_doc_refs_t;
+typedef fts_doc_id_set_t<fts_ranking_t>	fts_intersection_t;
+
 struct fts_word_freq_t;
 
 /** State of an FTS query. */
@@ -77,6 +272,10 @@ struct fts_query_t {
 	fts_doc_ids_t*	deleted;	/*!< Deleted doc ids that need to be
 					filtered from the output */
 
+	ulint		deleted_pos;	/*!< Position in deleted->doc_ids
+					where the previous lookup by
+					fts_query_is_deleted() ended */
+
 	fts_ast_node_t*	root;		/*!< Abstract syntax tree */
 
 	fts_ast_node_t* cur_node;	/*!< Current tree node */
@@ -91,10 +290,17 @@ struct fts_query_t {
 					doc ids, elements are of
 					type fts_ranking_t */
 
-	ib_rbt_t*	intersection;	/*!< The doc ids that were found in
-					doc_ids, this tree will become
-					the new doc_ids, elements are of type
-					fts_ranking_t */
+	fts_doc_refs_t*	doc_refs;	/*!< The elements of doc_refs_of,
+					for looking up doc ids without
+					searching the tree; NULL if none
+					were looked up yet */
+
+	const ib_rbt_t*	doc_refs_of;	/*!< The doc_ids tree that doc_refs
+					was built from, or NULL */
+
+	fts_intersection_t* intersection;/*!< The doc ids that were found in
+					doc_ids, this set will become
+					the new doc_ids */
 
 					/*!< Prepared statement to read the
 					nodes from the FTS INDEX */
@@ -719,6 +925,86 @@ fts_query_add_doc_freq(
 	return(rbt_value(fts_doc_freq_t, parent.last));
 }
 
+/** Check whether a doc id is in the sorted array of deleted doc ids.
+@param[in,out]	query	query instance
+@param[in]	doc_id	doc id to look up
+@return whether the doc id has been deleted */
+static
+bool
+fts_query_is_deleted(
+	fts_query_t*	query,
+	doc_id_t	doc_id)
+{
+	const ulint	size = ib_vector_size(query->deleted->doc_ids);
+	const doc_id_t*	deleted = static_cast<const doc_id_t*>(
+		query->deleted->doc_ids->data);
+	const ulint	pos = fts_gallop(deleted, size, query->deleted_pos,
+					 doc_id);
+
+	query->deleted_pos = pos;
+
+	return(pos < size && deleted[pos] == doc_id);
+}
+
+/** Forget the lookup entries of query->doc_refs_of.
+@param[in,out]	query	query instance */
+static
+void
+fts_query_clear_doc_refs(
+	fts_query_t*	query)
+{
+	const ulint	size = query->doc_refs->size() * sizeof(fts_doc_ref_t);
+
+	ut_ad(query->total_size >= size);
+	query->total_size -= size;
+
+	query->doc_refs->clear();
+	query->doc_refs_of = NULL;
+}
+
+/** Look up a doc id in query->doc_ids. The first lookup after
+query->doc_ids was replaced copies the elements of the tree to
+query->doc_refs.
+@param[in,out]	query	query instance
+@param[in]	doc_id	doc id to look up
+@return the lookup entry of doc_id, or NULL if doc_id was never added */
+static
+fts_doc_ref_t*
+fts_query_find_doc_id(
+	fts_query_t*	query,
+	doc_id_t	doc_id)
+{
+	ut_ad(query->doc_ids);
+
+	if (query->doc_refs == NULL) {
+		query->doc_refs = UT_NEW_NOKEY(fts_doc_refs_t());
+	}
+
+	if (query->doc_refs_of != query->doc_ids) {
+		const ib_rbt_node_t*	node;
+
+		fts_query_clear_doc_refs(query);
+
+		for (node = rbt_first(query->doc_ids);
+		     node;
+		     node = rbt_next(query->doc_ids, node)) {
+
+			fts_doc_ref_t	ref;
+
+			ref.ranking = rbt_value(fts_ranking_t, node);
+			ref.doc_id = ref.ranking->doc_id;
+
+			query->doc_refs->push_back(ref);
+		}
+
+		query->doc_refs_of = query->doc_ids;
+		query->total_size += query->doc_refs->size()
+			* sizeof(fts_doc_ref_t);
+	}
+
+	return(query->doc_refs->find(doc_id));
+}
+
 /*******************************************************************//**
 Add the doc id to the query set only if it's not in the
 deleted array. */
@@ -731,24 +1017,44 @@ fts_query_union_doc_id(
 	fts_rank_t	rank)		/*!< in: if non-zero, it is the
 					rank associated with the doc_id */
 {
-	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	doc_id_t*	updates = (doc_id_t*) query->deleted->doc_ids->data;
+	fts_doc_ref_t*	ref;
 
 	/* Check if the doc id is deleted and it's not already in our set. */
-	if (fts_bsearch(updates, 0, static_cast<int>(size), doc_id) < 0
-	    && rbt_search(query->doc_ids, &parent, &doc_id) != 0) {
+	if (fts_query_is_deleted(query, doc_id)) {
+		return;
+	}
+
+	ref = fts_query_find_doc_id(query, doc_id);
+
+	if (ref == NULL || ref->ranking == NULL) {
 
 		fts_ranking_t	ranking;
+		fts_ranking_t*	added;
 
 		ranking.rank = rank;
 		ranking.doc_id = doc_id;
 		fts_ranking_words_create(query, &ranking);
 
-		rbt_add_node(query->doc_ids, &parent, &ranking);
+		added = rbt_value(fts_ranking_t,
+				  rbt_insert(query->doc_ids, &ranking,
+					     &ranking));
 
 		query->total_size += SIZEOF_RBT_NODE_ADD
 			+ sizeof(fts_ranking_t) + RANKING_WORDS_INIT_LEN;
+
+		if (ref != NULL) {
+			/* The doc id was removed and is added again. */
+			ref->ranking = added;
+		} else {
+			fts_doc_ref_t	new_ref;
+
+			new_ref.doc_id = doc_id;
+			new_ref.ranking = added;
+
+			query->doc_refs->insert(new_ref);
+
+			query->total_size += sizeof(fts_doc_ref_t);
+		}
 	}
 }
 
@@ -763,13 +1069,16 @@ fts_query_remove_doc_id(
 	doc_id_t	doc_id)		/*!< in: the doc id to add */
 {
 	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	doc_id_t*	updates = (doc_id_t*) query->deleted->doc_ids->data;
+	fts_doc_ref_t*	ref;
 
 	/* Check if the doc id is deleted and it's in our set. */
-	if (fts_bsearch(updates, 0, static_cast<int>(size), doc_id) < 0
-	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
+	if (!fts_query_is_deleted(query, doc_id)
+	    && (ref = fts_query_find_doc_id(query, doc_id)) != NULL
+	    && ref->ranking != NULL) {
+
+		ut_a(rbt_search(query->doc_ids, &parent, &doc_id) == 0);
 		ut_free(rbt_remove_node(query->doc_ids, parent.last));
+		ref->ranking = NULL;
 
 		ut_ad(query->total_size >=
 		      SIZEOF_RBT_NODE_ADD + sizeof(fts_ranking_t));
@@ -792,17 +1101,14 @@ fts_query_change_ranking(
 	doc_id_t	doc_id,		/*!< in: the doc id to add */
 	ibool		downgrade)	/*!< in: Whether to downgrade ranking */
 {
-	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	doc_id_t*	updates = (doc_id_t*) query->deleted->doc_ids->data;
+	fts_doc_ref_t*	ref;
 
 	/* Check if the doc id is deleted and it's in our set. */
-	if (fts_bsearch(updates, 0, static_cast<int>(size), doc_id) < 0
-	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
-
-		fts_ranking_t*	ranking;
+	if (!fts_query_is_deleted(query, doc_id)
+	    && (ref = fts_query_find_doc_id(query, doc_id)) != NULL
+	    && ref->ranking != NULL) {
 
-		ranking = rbt_value(fts_ranking_t, parent.last);
+		fts_ranking_t*	ranking = ref->ranking;
 
 		ranking->rank += downgrade ? RANK_DOWNGRADE : RANK_UPGRADE;
 
@@ -819,7 +1125,7 @@ fts_query_change_ranking(
 /*******************************************************************//**
 Check the doc id in the query set only if it's not in the
 deleted array. The doc ids that were found are stored in
-another rb tree (fts_query_t::intersect). */
+another set (fts_query_t::intersection). */
 static
 void
 fts_query_intersect_doc_id(
@@ -829,9 +1135,6 @@ fts_query_intersect_doc_id(
 	fts_rank_t	rank)		/*!< in: if non-zero, it is the
 					rank associated with the doc_id */
 {
-	ib_rbt_bound_t	parent;
-	ulint		size = ib_vector_size(query->deleted->doc_ids);
-	doc_id_t*	updates = (doc_id_t*) query->deleted->doc_ids->data;
 	fts_ranking_t*	ranking= NULL;
 
 	/* There are three types of intersect:
@@ -843,22 +1146,21 @@ fts_query_intersect_doc_id(
 	      if it matches 'b' and it's in doc_ids.(multi_exist = true). */
 
 	/* Check if the doc id is deleted and it's in our set */
-	if (fts_bsearch(updates, 0, static_cast<int>(size), doc_id) < 0) {
+	if (!fts_query_is_deleted(query, doc_id)) {
 		fts_ranking_t	new_ranking;
+		fts_doc_ref_t*	ref = fts_query_find_doc_id(query, doc_id);
 
-		if (rbt_search(query->doc_ids, &parent, &doc_id) != 0) {
+		if (ref == NULL || ref->ranking == NULL) {
 			if (query->multi_exist) {
 				return;
 			} else {
 				new_ranking.words = NULL;
 			}
 		} else {
-			ranking = rbt_value(fts_ranking_t, parent.last);
+			ranking = ref->ranking;
 
 			/* We've just checked the doc id before */
 			if (ranking->words == NULL) {
-				ut_ad(rbt_search(query->intersection, &parent,
-					ranking) == 0);
 				return;
 			}
 
@@ -878,8 +1180,7 @@ fts_query_intersect_doc_id(
 		new_ranking.rank = rank;
 		new_ranking.doc_id = doc_id;
 
-		if (rbt_search(query->intersection, &parent,
-			       &new_ranking) != 0) {
+		if (query->intersection->find(doc_id) == NULL) {
 			if (new_ranking.words == NULL) {
 				fts_ranking_words_create(query, &new_ranking);
 
@@ -890,8 +1191,7 @@ fts_query_intersect_doc_id(
 				ranking->words = NULL;
 			}
 
-			rbt_add_node(query->intersection,
-				     &parent, &new_ranking);
+			query->intersection->insert(new_ranking);
 
 			query->total_size += SIZEOF_RBT_NODE_ADD
 				+ sizeof(fts_ranking_t);
@@ -910,6 +1210,10 @@ fts_query_free_doc_ids(
 {
 	const ib_rbt_node_t*	node;
 
+	if (doc_ids == query->doc_refs_of) {
+		fts_query_clear_doc_refs(query);
+	}
+
 	for (node = rbt_first(doc_ids); node; node = rbt_first(doc_ids)) {
 
 		fts_ranking_t*	ranking;
@@ -934,6 +1238,70 @@ fts_query_free_doc_ids(
 	query->total_size -= SIZEOF_RBT_CREATE;
 }
 
+/** Start collecting the doc ids of query->doc_ids that are visited next.
+@param[in,out]	query	query instance */
+static
+void
+fts_query_intersection_create(
+	fts_query_t*	query)
+{
+	ut_a(!query->intersection);
+
+	query->intersection = UT_NEW_NOKEY(fts_intersection_t());
+
+	/* The intersection will become a tree of doc_ids. */
+	query->total_size += SIZEOF_RBT_CREATE;
+}
+
+/** Free the collected intersection.
+@param[in,out]	query	query instance */
+static
+void
+fts_query_intersection_free(
+	fts_query_t*	query)
+{
+	const ulint	size = SIZEOF_RBT_CREATE + query->intersection->size()
+		* (SIZEOF_RBT_NODE_ADD + sizeof(fts_ranking_t));
+
+	ut_ad(query->total_size >= size);
+	query->total_size -= size;
+
+	UT_DELETE(query->intersection);
+	query->intersection = NULL;
+}
+
+/** Make the collected intersection the current doc id set and free
+the old set.
+@param[in,out]	query	query instance */
+static
+void
+fts_query_intersection_apply(
+	fts_query_t*	query)
+{
+	ib_rbt_t*	doc_ids = rbt_create(
+		sizeof(fts_ranking_t), fts_ranking_doc_id_cmp);
+
+	const std::vector<fts_ranking_t, ut_allocator<fts_ranking_t> >&
+		elems = query->intersection->elements();
+
+	for (ulint i = 0; i < elems.size(); ++i) {
+		ib_rbt_bound_t	parent;
+
+		/* The elements are in ascending order, so this is
+		always the rightmost leaf. */
+		rbt_search(doc_ids, &parent, &elems[i]);
+		rbt_add_node(doc_ids, &parent, &elems[i]);
+	}
+
+	/* The memory that was accounted for the intersection is now
+	used by doc_ids. */
+	UT_DELETE(query->intersection);
+	query->intersection = NULL;
+
+	fts_query_free_doc_ids(query, query->doc_ids);
+	query->doc_ids = doc_ids;
+}
+
 /*******************************************************************//**
 Add the word to the documents "list" of matching words from
 the query. We make a copy of the word from the query heap. */
@@ -945,25 +1313,25 @@ fts_query_add_word_to_document(
 	doc_id_t		doc_id,	/*!< in: the document to update */
 	const fts_string_t*	word)	/*!< in: the token to add */
 {
-	ib_rbt_bound_t		parent;
 	fts_ranking_t*		ranking = NULL;
 
 	if (query->flags == FTS_OPT_RANKING) {
 		return;
 	}
 
-	/* First we search the intersection RB tree as it could have
+	/* First we search the intersection as it could have
 	taken ownership of the words rb tree instance. */
-	if (query->intersection
-	    && rbt_search(query->intersection, &parent, &doc_id) == 0) {
-
-		ranking = rbt_value(fts_ranking_t, parent.last);
+	if (query->intersection) {
+		ranking = query->intersection->find(doc_id);
 	}
 
-	if (ranking == NULL
-	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
+	if (ranking == NULL) {
+		const fts_doc_ref_t*	ref = fts_query_find_doc_id(
+			query, doc_id);
 
-		ranking = rbt_value(fts_ranking_t, parent.last);
+		if (ref != NULL) {
+			ranking = ref->ranking;
+		}
 	}
 
 	if (ranking != NULL) {
@@ -1238,16 +1606,11 @@ fts_query_intersect(
 		fts_cache_t*		cache = table->fts->cache;
 		dberr_t			error;
 
-		ut_a(!query->intersection);
-
 		n_doc_ids = rbt_size(query->doc_ids);
 
-		/* Create the rb tree that will hold the doc ids of
+		/* Create the set that will hold the doc ids of
 		the intersection. */
-		query->intersection = rbt_create(
-			sizeof(fts_ranking_t), fts_ranking_doc_id_cmp);
-
-		query->total_size += SIZEOF_RBT_CREATE;
+		fts_query_intersection_create(query);
 
 		/* This is to avoid decompressing the ilist if the
 		node's ilist doc ids are out of range. */
@@ -1320,11 +1683,9 @@ fts_query_intersect(
 		fts_que_graph_free(graph);
 
 		if (query->error == DB_SUCCESS) {
-			/* Make the intesection (rb tree) the current doc id
+			/* Make the intesection the current doc id
 			set and free the old set. */
-			fts_query_free_doc_ids(query, query->doc_ids);
-			query->doc_ids = query->intersection;
-			query->intersection = NULL;
+			fts_query_intersection_apply(query);
 
 			ut_a(!query->multi_exist || (query->multi_exist
 			     && rbt_size(query->doc_ids) <= n_doc_ids));
@@ -1527,11 +1888,7 @@ fts_merge_doc_ids(
 	/* To process FTS_EXIST operation (intersection), we need
 	to create a new result set for fts_query_intersect(). */
 	if (query->oper == FTS_EXIST) {
-
-		query->intersection = rbt_create(
-			sizeof(fts_ranking_t), fts_ranking_doc_id_cmp);
-
-		query->total_size += SIZEOF_RBT_CREATE;
+		fts_query_intersection_create(query);
 	}
 
 	/* Merge the elements to the result set. */
@@ -1560,9 +1917,7 @@ fts_merge_doc_ids(
 	/* If it is an intersection operation, reset query->doc_ids
 	to query->intersection and free the old result list. */
 	if (query->oper == FTS_EXIST && query->intersection != NULL) {
-		fts_query_free_doc_ids(query, query->doc_ids);
-		query->doc_ids = query->intersection;
-		query->intersection = NULL;
+		fts_query_intersection_apply(query);
 	}
 
 	DBUG_RETURN(DB_SUCCESS);
@@ -2995,11 +3350,7 @@ fts_query_visitor(
 	case FTS_AST_PARSER_PHRASE_LIST:
 
 		if (query->oper == FTS_EXIST) {
-			ut_ad(query->intersection == NULL);
-			query->intersection = rbt_create(
-				sizeof(fts_ranking_t), fts_ranking_doc_id_cmp);
-
-			query->total_size += SIZEOF_RBT_CREATE;
+			fts_query_intersection_create(query);
 		}
 
 		/* Set the current proximity distance. */
@@ -3013,9 +3364,7 @@ fts_query_visitor(
 		query->collect_positions = FALSE;
 
 		if (query->oper == FTS_EXIST) {
-			fts_query_free_doc_ids(query, query->doc_ids);
-			query->doc_ids = query->intersection;
-			query->intersection = NULL;
+			fts_query_intersection_apply(query);
 		}
 
 		break;
@@ -3654,9 +4003,6 @@ fts_query_prepare_result(
 
 	if (query->flags == FTS_OPT_RANKING) {
 		fts_word_freq_t*	word_freq;
-		ulint		size = ib_vector_size(query->deleted->doc_ids);
-		doc_id_t*	updates =
-			(doc_id_t*) query->deleted->doc_ids->data;
 
 		node = rbt_first(query->word_freqs);
 		ut_ad(node);
@@ -3671,8 +4017,7 @@ fts_query_prepare_result(
 			doc_freq = rbt_value(fts_doc_freq_t, node);
 
 			/* Don't put deleted docs into result */
-			if (fts_bsearch(updates, 0, static_cast<int>(size),
-					doc_freq->doc_id) >= 0) {
+			if (fts_query_is_deleted(query, doc_freq->doc_id)) {
 				/* one less matching doc count */
 				--word_freq->doc_count;
 				continue;
@@ -3798,13 +4143,17 @@ fts_query_free(
 	}
 
 	if (query->intersection) {
-		fts_query_free_doc_ids(query, query->intersection);
+		fts_query_intersection_free(query);
 	}
 
 	if (query->doc_ids) {
 		fts_query_free_doc_ids(query, query->doc_ids);
 	}
 
+	if (query->doc_refs) {
+		UT_DELETE(query->doc_refs);
+	}
+
 	if (query->word_freqs) {
 		const ib_rbt_node_t*	node;
 
@@ -91,6 +91,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "fts0types.h"
 #include "ibuf0ibuf.h"
 #include "lock0lock.h"
+#include "log0arch.h"
 #include "log0crypt.h"
 #include "mtr0mtr.h"
 #include "os0file.h"
@@ -383,6 +384,21 @@ static TYPELIB innodb_deadlock_report_typelib = {
 	NULL
 };
 
+/** Names of allowed values of innodb_lru_policy */
+static const char *innodb_lru_policy_names[]= {
+	"midpoint", /* BUF_LRU_MIDPOINT */
+	"ghost", /* BUF_LRU_GHOST */
+	NullS
+};
+
+/** Enumeration of innodb_lru_policy */
+static TYPELIB innodb_lru_policy_typelib = {
+	array_elements(innodb_lru_policy_names) - 1,
+	"innodb_lru_policy_typelib",
+	innodb_lru_policy_names,
+	NULL
+};
+
 /** Allowed values of innodb_change_buffering */
 static const char* innodb_change_buffering_names[] = {
 	"none",		/* IBUF_USE_NONE */
@@ -850,6 +866,7 @@ static ibool innodb_have_lz4=IF_LZ4(1, 0);
 static ibool innodb_have_lzma=IF_LZMA(1, 0);
 static ibool innodb_have_bzip2=IF_BZIP2(1, 0);
 static ibool innodb_have_snappy=IF_SNAPPY(1, 0);
+static ibool innodb_have_zstd=IF_ZSTD(1, 0);
 static ibool innodb_have_punch_hole=IF_PUNCH_HOLE(1, 0);
 
 static
@@ -975,6 +992,7 @@ static SHOW_VAR innodb_status_variables[]= {
   {"ibuf_merges", &ibuf.n_merges, SHOW_SIZE_T},
   {"ibuf_segment_size", &ibuf.seg_size, SHOW_SIZE_T},
   {"ibuf_size", &ibuf.size, SHOW_SIZE_T},
+  {"log_archive_stopped", &log_archive_stopped, SHOW_BOOL},
   {"log_waits", &export_vars.innodb_log_waits, SHOW_SIZE_T},
   {"log_write_requests", &export_vars.innodb_log_write_requests, SHOW_SIZE_T},
   {"log_writes", &export_vars.innodb_log_writes, SHOW_SIZE_T},
@@ -1030,6 +1048,8 @@ static SHOW_VAR innodb_status_variables[]= {
    &export_vars.innodb_non_index_pages_written, SHOW_LONGLONG},
   {"num_pages_page_compressed",
    &export_vars.innodb_pages_page_compressed, SHOW_LONGLONG},
+  {"num_pages_page_compressed_dict",
+   &export_vars.innodb_pages_page_compressed_dict, SHOW_LONGLONG},
   {"num_page_compressed_trim_op",
    &export_vars.innodb_page_compressed_trim_op, SHOW_LONGLONG},
   {"num_pages_page_decompressed",
@@ -1045,6 +1065,7 @@ static SHOW_VAR innodb_status_variables[]= {
   {"have_lzma", &innodb_have_lzma, SHOW_BOOL},
   {"have_bzip2", &innodb_have_bzip2, SHOW_BOOL},
   {"have_snappy", &innodb_have_snappy, SHOW_BOOL},
+  {"have_zstd", &innodb_have_zstd, SHOW_BOOL},
   {"have_punch_hole", &innodb_have_punch_hole, SHOW_BOOL},
 
   /* Defragmentation */
@@ -3358,6 +3379,15 @@ static int innodb_init_params()
 	}
 #endif
 
+#ifndef HAVE_ZSTD
+	if (innodb_compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		sql_print_error("InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				"InnoDB: libzstd is not installed. \n",
+				innodb_compression_algorithm);
+		DBUG_RETURN(HA_ERR_INITIALIZATION);
+	}
+#endif
+
 	if ((srv_encrypt_tables || srv_encrypt_log
 	     || innodb_encrypt_temporary_tables)
 	     && !encryption_key_id_exists(FIL_DEFAULT_ENCRYPTION_KEY)) {
@@ -3584,7 +3614,9 @@ static int innodb_init_params()
 	data_mysql_default_charset_coll = (ulint) default_charset_info->number;
 
 #ifndef _WIN32
-	if (srv_use_atomic_writes && my_may_have_atomic_write) {
+	if (srv_use_atomic_writes
+	    && (my_may_have_atomic_write
+		|| (srv_atomic_write_paths && *srv_atomic_write_paths))) {
 		/*
                   Force O_DIRECT on Unixes (on Windows writes are always
                   unbuffered)
@@ -16895,6 +16927,98 @@ static int innodb_ft_aux_table_validate(THD *thd, st_mysql_sys_var*,
 	}
 }
 
+/** The latest table that innodb_zstd_train_dictionary was assigned */
+static char* innodb_zstd_train_dictionary;
+
+/** Validate SET GLOBAL innodb_zstd_train_dictionary.
+@param[in]	thd	connection
+@param[out]	save	new value of innodb_zstd_train_dictionary
+@param[in]	value	name of a page_compressed table
+@return 0 on success, 1 on failure */
+static int innodb_zstd_train_dictionary_validate(THD *thd, st_mysql_sys_var*,
+						 void* save,
+						 st_mysql_value* value)
+{
+	char buf[STRING_BUFFER_USUAL_SIZE];
+	int len = sizeof buf;
+	const char* table_name = value->val_str(value, buf, &len);
+
+	if (!table_name) {
+		*static_cast<char**>(save) = NULL;
+		return 0;
+	}
+
+	dict_table_t* table = dict_table_open_on_name(
+		table_name, FALSE, TRUE, DICT_ERR_IGNORE_NONE);
+	if (!table) {
+		return 1;
+	}
+
+	const bool applicable = table->space
+		&& fil_zstd_dict_applicable(*table->space);
+	dict_table_close(table, FALSE, FALSE);
+
+	if (!applicable) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: Cannot train a zstd dictionary"
+				    " for %s: %s", table_name,
+				    ut_strerr(DB_UNSUPPORTED));
+		return 1;
+	}
+
+	if (table_name == buf) {
+		ut_ad(static_cast<size_t>(len) < sizeof buf);
+		table_name = thd_strmake(thd, table_name, len);
+	}
+
+	*static_cast<const char**>(save) = table_name;
+	return 0;
+}
+
+/** Train a zstd dictionary on SET GLOBAL innodb_zstd_train_dictionary.
+Sampling the pages and flushing the dictionary can take a while, so
+LOCK_global_system_variables is released meanwhile.
+@param[in]	thd	connection
+@param[out]	var_ptr	innodb_zstd_train_dictionary
+@param[in]	save	name of a page_compressed table */
+static void innodb_zstd_train_dictionary_update(THD* thd, st_mysql_sys_var*,
+						void* var_ptr,
+						const void* save)
+{
+	const char* table_name = *static_cast<const char*const*>(save);
+	char* old = *static_cast<char**>(var_ptr);
+	*static_cast<char**>(var_ptr) = table_name
+		? my_strdup(PSI_INSTRUMENT_ME, table_name, MYF(0))
+		: NULL;
+	my_free(old);
+
+	if (!table_name) {
+		return;
+	}
+
+	mysql_mutex_unlock(&LOCK_global_system_variables);
+
+	dberr_t err = DB_TABLE_NOT_FOUND;
+
+	if (dict_table_t* table = dict_table_open_on_name(
+		    table_name, FALSE, TRUE, DICT_ERR_IGNORE_NONE)) {
+		err = table->space
+			? fil_zstd_dict_train(table->space)
+			: DB_TABLESPACE_NOT_FOUND;
+		dict_table_close(table, FALSE, FALSE);
+	}
+
+	if (err != DB_SUCCESS) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: Cannot train a zstd dictionary"
+				    " for %s: %s", table_name, ut_strerr(err));
+	}
+
+	mysql_mutex_lock(&LOCK_global_system_variables);
+}
+
 #ifdef BTR_CUR_HASH_ADAPT
 /****************************************************************//**
 Update the system variable innodb_adaptive_hash_index using the "saved"
@@ -18264,6 +18388,14 @@ static MYSQL_SYSVAR_BOOL(doublewrite, srv_use_doublewrite_buf,
   " Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_UINT(doublewrite_pages, srv_doublewrite_pages,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Maximum number of pages in a doublewrite batch, at most the size of the"
+  " doublewrite buffer (0 = the whole doublewrite buffer). Batches of at"
+  " most half of the doublewrite buffer are written while the data pages"
+  " of the previous batch are being written.",
+  NULL, NULL, 0, 0, 512, 0);
+
 static MYSQL_SYSVAR_BOOL(use_atomic_writes, srv_use_atomic_writes,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Enable atomic writes, instead of using the doublewrite buffer, for files "
@@ -18272,6 +18404,14 @@ static MYSQL_SYSVAR_BOOL(use_atomic_writes, srv_use_atomic_writes,
   "the directFS filesystem or with Shannon cards using any file system.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_STR(atomic_write_paths, srv_atomic_write_paths,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Semicolon-separated list of directories on storage that is known to "
+  "write innodb_page_size pages atomically. With innodb_use_atomic_writes, "
+  "the data files in these directories are written without the "
+  "doublewrite buffer.",
+  NULL, NULL, NULL);
+
 static MYSQL_SYSVAR_BOOL(stats_include_delete_marked,
   srv_stats_include_delete_marked,
   PLUGIN_VAR_OPCMDARG,
@@ -18387,6 +18527,11 @@ static MYSQL_SYSVAR_STR(log_group_home_dir, srv_log_group_home_dir,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Path to InnoDB log files.", NULL, NULL, NULL);
 
+static MYSQL_SYSVAR_STR(log_archive_dir, srv_log_archive_dir,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Directory where the redo log is archived before it can be overwritten"
+  " (default: no archiving)", NULL, NULL, NULL);
+
 static MYSQL_SYSVAR_DOUBLE(max_dirty_pages_pct, srv_max_buf_pool_modified_pct,
   PLUGIN_VAR_RQCMDARG,
   "Percentage of dirty pages allowed in bufferpool.",
@@ -18568,6 +18713,13 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_dump_at_shutdown, srv_buffer_pool_dump_at_s
   "Dump the buffer pool into a file named @@innodb_buffer_pool_filename",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(buffer_pool_dump_pages, srv_buffer_pool_dump_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "Whether innodb_buffer_pool_dump_at_shutdown also writes the page contents"
+  " to @@innodb_buffer_pool_filename.pages, for loading them at startup"
+  " with sequential reads",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
   PLUGIN_VAR_RQCMDARG,
   "Dump only the hottest N% of each buffer pool, defaults to 25",
@@ -18666,6 +18818,14 @@ static MYSQL_SYSVAR_SIZE_T(lru_flush_size, innodb_lru_flush_size,
   "How many pages to flush on LRU eviction",
   NULL, NULL, 32, 1, SIZE_T_MAX, 0);
 
+static MYSQL_SYSVAR_ENUM(lru_policy, buf_LRU_policy,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Buffer pool replacement policy: midpoint (insert pages that are read"
+  " from files at the midpoint of the LRU list) or ghost (like midpoint,"
+  " but a page that was made young and evicted recently is inserted at"
+  " the head when it is requested again)",
+  NULL, NULL, BUF_LRU_MIDPOINT, &innodb_lru_policy_typelib);
+
 static MYSQL_SYSVAR_ULONG(flush_neighbors, srv_flush_neighbors,
   PLUGIN_VAR_OPCMDARG,
   "Set to 0 (don't flush neighbors from buffer pool),"
@@ -18984,6 +19144,13 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   " trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(logical_read_ahead, srv_logical_read_ahead,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of B-tree leaf pages to read ahead in key order, using the"
+  " node pointers of the parent page, when a range scan reaches a page"
+  " that is not in the buffer pool (0 to disable).",
+  NULL, NULL, 0, 0, BTR_PCUR_READ_AHEAD_MAX, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
   PLUGIN_VAR_RQCMDARG,
   "Turn on a monitor counter",
@@ -19129,7 +19296,7 @@ static MYSQL_SYSVAR_BOOL(force_primary_key,
   "Do not allow creating a table without primary key (off by default)",
   NULL, NULL, FALSE);
 
-static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", 0 };
+static const char *page_compression_algorithms[]= { "none", "zlib", "lz4", "lzo", "lzma", "bzip2", "snappy", "zstd", 0 };
 static TYPELIB page_compression_algorithms_typelib=
 {
   array_elements(page_compression_algorithms) - 1, 0,
@@ -19137,7 +19304,7 @@ static TYPELIB page_compression_algorithms_typelib=
 };
 static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PLUGIN_VAR_OPCMDARG,
-  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, or snappy",
+  "Compression algorithm used on page compression. One of: none, zlib, lz4, lzo, lzma, bzip2, snappy, or zstd",
   innodb_compression_algorithm_validate, NULL,
   /* We use here the largest number of supported compression method to
   enable all those methods that are available. Availability of compression
@@ -19145,6 +19312,31 @@ static MYSQL_SYSVAR_ENUM(compression_algorithm, innodb_compression_algorithm,
   PAGE_ZLIB_ALGORITHM,
   &page_compression_algorithms_typelib);
 
+/** Update innodb_page_compression_threads.
+@param[in]	save	to-be-assigned value */
+static void
+innodb_page_compression_threads_update(THD*, st_mysql_sys_var*, void*,
+				       const void* save)
+{
+	srv_page_compression_threads = *static_cast<const uint*>(save);
+	buf_page_compression_threads(srv_page_compression_threads);
+}
+
+static MYSQL_SYSVAR_UINT(page_compression_threads,
+  srv_page_compression_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of page_compressed pages to compress or decompress"
+  " concurrently in the thread pool when writing or reading them"
+  " (0 to do it in the page cleaner thread and the read i/o callbacks).",
+  NULL, innodb_page_compression_threads_update, 0, 0, 255, 0);
+
+static MYSQL_SYSVAR_STR(zstd_train_dictionary, innodb_zstd_train_dictionary,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
+  "Train a zstd dictionary on the pages of the specified"
+  " page_compressed table (database/table), unless it already has one.",
+  innodb_zstd_train_dictionary_validate,
+  innodb_zstd_train_dictionary_update, NULL);
+
 static MYSQL_SYSVAR_ULONG(fatal_semaphore_wait_threshold, srv_fatal_semaphore_wait_threshold,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Maximum number of seconds that semaphore times out in InnoDB.",
@@ -19216,6 +19408,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_filename),
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
+  MYSQL_SYSVAR(buffer_pool_dump_pages),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
@@ -19234,6 +19427,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(defragment_frequency),
   MYSQL_SYSVAR(lru_scan_depth),
   MYSQL_SYSVAR(lru_flush_size),
+  MYSQL_SYSVAR(lru_policy),
   MYSQL_SYSVAR(flush_neighbors),
   MYSQL_SYSVAR(checksum_algorithm),
   MYSQL_SYSVAR(compression_level),
@@ -19241,8 +19435,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(temp_data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_pages),
   MYSQL_SYSVAR(stats_include_delete_marked),
   MYSQL_SYSVAR(use_atomic_writes),
+  MYSQL_SYSVAR(atomic_write_paths),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(read_io_threads),
   MYSQL_SYSVAR(write_io_threads),
@@ -19268,6 +19464,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(log_buffer_size),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_write_ahead_size),
+  MYSQL_SYSVAR(log_archive_dir),
   MYSQL_SYSVAR(log_group_home_dir),
   MYSQL_SYSVAR(max_dirty_pages_pct),
   MYSQL_SYSVAR(max_dirty_pages_pct_lwm),
@@ -19326,6 +19523,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* WITH_INNODB_DISALLOW_WRITES */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(logical_read_ahead),
   MYSQL_SYSVAR(read_only),
   MYSQL_SYSVAR(read_only_compressed),
   MYSQL_SYSVAR(instant_alter_column_allowed),
@@ -19375,6 +19573,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   /* Table page compression feature */
   MYSQL_SYSVAR(compression_default),
   MYSQL_SYSVAR(compression_algorithm),
+  MYSQL_SYSVAR(page_compression_threads),
+  MYSQL_SYSVAR(zstd_train_dictionary),
   /* Encryption feature */
   MYSQL_SYSVAR(encrypt_tables),
   MYSQL_SYSVAR(encryption_threads),
@@ -19434,7 +19634,8 @@ i_s_innodb_sys_foreign,
 i_s_innodb_sys_foreign_cols,
 i_s_innodb_sys_tablespaces,
 i_s_innodb_sys_virtual,
-i_s_innodb_tablespaces_encryption
+i_s_innodb_tablespaces_encryption,
+i_s_innodb_tablespaces_page_compression
 maria_declare_plugin_end;
 
 /** @brief Adjust some InnoDB startup parameters based on file contents
@@ -20524,6 +20725,17 @@ innodb_compression_algorithm_validate(
 		DBUG_RETURN(1);
 	}
 #endif
+
+#ifndef HAVE_ZSTD
+	if (compression_algorithm == PAGE_ZSTD_ALGORITHM) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    HA_ERR_UNSUPPORTED,
+				    "InnoDB: innodb_compression_algorithm = %lu unsupported.\n"
+				    "InnoDB: libzstd is not installed. \n",
+				    compression_algorithm);
+		DBUG_RETURN(1);
+	}
+#endif
 	DBUG_RETURN(0);
 }
 
@@ -6881,3 +6881,217 @@ UNIV_INTERN struct st_maria_plugin	i_s_innodb_tablespaces_encryption =
 	STRUCT_FLD(version_info, INNODB_VERSION_STR),
 	STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE)
 };
+
+namespace Show {
+/**  TABLESPACES_PAGE_COMPRESSION    ***************************************/
+/* Fields of the table INFORMATION_SCHEMA.INNODB_TABLESPACES_PAGE_COMPRESSION */
+static ST_FIELD_INFO	innodb_tablespaces_page_compression_fields_info[] =
+{
+#define TABLESPACES_PAGE_COMPRESSION_SPACE	0
+  Column("SPACE", ULong(), NOT_NULL),
+
+#define TABLESPACES_PAGE_COMPRESSION_NAME	1
+  Column("NAME", Varchar(MAX_FULL_NAME_LEN + 1), NULLABLE),
+
+#define TABLESPACES_PAGE_COMPRESSION_COMPRESSED_PAGES	2
+  Column("COMPRESSED_PAGES", ULonglong(), NOT_NULL),
+
+#define TABLESPACES_PAGE_COMPRESSION_COMPRESSED_BYTES	3
+  Column("COMPRESSED_BYTES", ULonglong(), NOT_NULL),
+
+#define TABLESPACES_PAGE_COMPRESSION_COMPRESSION_RATIO	4
+  Column("COMPRESSION_RATIO", Float(MAX_FLOAT_STR_LENGTH), NULLABLE),
+
+#define TABLESPACES_PAGE_COMPRESSION_COMPRESS_TIME	5
+  Column("COMPRESS_TIME", ULonglong(), NOT_NULL),
+
+#define TABLESPACES_PAGE_COMPRESSION_DECOMPRESSED_PAGES	6
+  Column("DECOMPRESSED_PAGES", ULonglong(), NOT_NULL),
+
+#define TABLESPACES_PAGE_COMPRESSION_DECOMPRESS_TIME	7
+  Column("DECOMPRESS_TIME", ULonglong(), NOT_NULL),
+
+  CEnd()
+};
+} // namespace Show
+
+/**********************************************************************//**
+Function to fill INFORMATION_SCHEMA.INNODB_TABLESPACES_PAGE_COMPRESSION.
+@param[in]	thd		thread handle
+@param[in]	space		page_compressed tablespace
+@param[in]	table_to_fill	I_S table to fill
+@return 0 on success */
+static
+int
+i_s_dict_fill_tablespaces_page_compression(
+	THD*		thd,
+	fil_space_t*	space,
+	TABLE*		table_to_fill)
+{
+	Field**	fields;
+
+	DBUG_ENTER("i_s_dict_fill_tablespaces_page_compression");
+
+	fields = table_to_fill->field;
+
+	const fil_space_t::page_compression_stats& stats
+		= space->page_compression;
+	const ulint	compressed = stats.compressed;
+	const ulint	compressed_bytes = stats.compressed_bytes;
+
+	OK(fields[TABLESPACES_PAGE_COMPRESSION_SPACE]->store(space->id, true));
+
+	{
+		const auto name = space->name();
+		if (name.data()) {
+			OK(fields[TABLESPACES_PAGE_COMPRESSION_NAME]->store(
+				   name.data(), name.size(),
+				   system_charset_info));
+			fields[TABLESPACES_PAGE_COMPRESSION_NAME]->set_notnull();
+		} else {
+			fields[TABLESPACES_PAGE_COMPRESSION_NAME]->set_null();
+		}
+	}
+
+	OK(fields[TABLESPACES_PAGE_COMPRESSION_COMPRESSED_PAGES]->store(
+		   compressed, true));
+	OK(fields[TABLESPACES_PAGE_COMPRESSION_COMPRESSED_BYTES]->store(
+		   compressed_bytes, true));
+
+	if (compressed_bytes) {
+		OK(fields[TABLESPACES_PAGE_COMPRESSION_COMPRESSION_RATIO]
+		   ->store(double(compressed) * space->physical_size()
+			   / double(compressed_bytes)));
+		fields[TABLESPACES_PAGE_COMPRESSION_COMPRESSION_RATIO]
+			->set_notnull();
+	} else {
+		fields[TABLESPACES_PAGE_COMPRESSION_COMPRESSION_RATIO]
+			->set_null();
+	}
+
+	OK(fields[TABLESPACES_PAGE_COMPRESSION_COMPRESS_TIME]->store(
+		   stats.compress_usec, true));
+	OK(fields[TABLESPACES_PAGE_COMPRESSION_DECOMPRESSED_PAGES]->store(
+		   stats.decompressed, true));
+	OK(fields[TABLESPACES_PAGE_COMPRESSION_DECOMPRESS_TIME]->store(
+		   stats.decompress_usec, true));
+
+	OK(schema_table_store_record(thd, table_to_fill));
+
+	DBUG_RETURN(0);
+}
+/*******************************************************************//**
+Function to populate INFORMATION_SCHEMA.INNODB_TABLESPACES_PAGE_COMPRESSION.
+Loop through each page_compressed tablespace and fill in its compression
+statistics.
+@return 0 on success */
+static
+int
+i_s_tablespaces_page_compression_fill_table(
+/*========================================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	Item*		)	/*!< in: condition (not used) */
+{
+	DBUG_ENTER("i_s_tablespaces_page_compression_fill_table");
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name.str);
+
+	/* deny access to user without PROCESS_ACL privilege */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	int err = 0;
+	mysql_mutex_lock(&fil_system.mutex);
+	fil_system.freeze_space_list++;
+
+	for (fil_space_t& space : fil_system.space_list) {
+		if (space.purpose == FIL_TYPE_TABLESPACE
+		    && space.is_compressed()
+		    && !space.is_stopping()) {
+			space.reacquire();
+			mysql_mutex_unlock(&fil_system.mutex);
+			err = i_s_dict_fill_tablespaces_page_compression(
+				thd, &space, tables->table);
+			mysql_mutex_lock(&fil_system.mutex);
+			space.release();
+			if (err) {
+				break;
+			}
+		}
+	}
+
+	fil_system.freeze_space_list--;
+	mysql_mutex_unlock(&fil_system.mutex);
+	DBUG_RETURN(err);
+}
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_TABLESPACES_PAGE_COMPRESSION
+@return 0 on success */
+static
+int
+innodb_tablespaces_page_compression_init(
+/*=====================================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("innodb_tablespaces_page_compression_init");
+
+	schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info
+		= Show::innodb_tablespaces_page_compression_fields_info;
+	schema->fill_table = i_s_tablespaces_page_compression_fill_table;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_maria_plugin	i_s_innodb_tablespaces_page_compression =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_TABLESPACES_PAGE_COMPRESSION"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB TABLESPACES_PAGE_COMPRESSION"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, innodb_tablespaces_page_compression_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* Maria extension */
+	STRUCT_FLD(version_info, INNODB_VERSION_STR),
+	STRUCT_FLD(maturity, MariaDB_PLUGIN_MATURITY_STABLE)
+};
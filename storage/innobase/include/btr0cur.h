@@ -890,6 +890,10 @@ struct btr_cur_t {
 					NULL */
 	ulint		fold;		/*!< fold value used in the search if
 					flag is BTR_CUR_HASH */
+	uint32_t	parent_page_no;	/*!< page number of the level-1 page
+					that the search passed through to
+					reach the leaf page, or FIL_NULL;
+					used for logical read-ahead */
 	/* @} */
 	btr_path_t*	path_arr;	/*!< in estimating the number of
 					rows in range, we store in this array
@@ -915,6 +919,7 @@ struct btr_cur_t {
 		n_fields = 0;
 		n_bytes = 0;
 		fold = 0;
+		parent_page_no = FIL_NULL;
 		path_arr = NULL;
 		rtr_info = NULL;
 	}
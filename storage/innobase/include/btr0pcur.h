@@ -46,6 +46,9 @@ of a scroll cursor easier */
 	BTR_PCUR_AFTER_LAST_IN_TREE	= 5	/* in an empty tree */
 };
 
+/** Maximum value of innodb_logical_read_ahead */
+#define BTR_PCUR_READ_AHEAD_MAX	64
+
 /**************************************************************//**
 Allocates memory for a persistent cursor object and initializes the cursor.
 @return own: persistent cursor */
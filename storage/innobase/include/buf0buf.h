@@ -582,6 +582,15 @@ void buf_page_monitor(const buf_page_t *bpage, buf_io_fix io_type);
 @retval DB_DECRYPTION_FAILED    if the page cannot be decrypted */
 dberr_t buf_page_read_complete(buf_page_t *bpage, const fil_node_t &node);
 
+/** The task group that compresses page_compressed pages for writing and
+decompresses them after reading, limited to innodb_page_compression_threads */
+extern tpool::task_group buf_page_compression_group;
+
+/** Update innodb_page_compression_threads.
+@param n  maximum number of pages to compress or decompress concurrently,
+or 0 to do it in the thread that writes or reads the page */
+void buf_page_compression_threads(uint n);
+
 /** Calculate aligned buffer pool size based on srv_buf_pool_chunk_unit,
 if needed.
 @param[in]	size	size in bytes
@@ -748,6 +757,10 @@ class buf_page_t
   /** Change buffer entries for the page exist.
   Protected by io_fix()==BUF_IO_READ or by buf_block_t::lock. */
   bool ibuf_exist;
+  /** Whether buf_page_make_young() or a hit in the list of recently
+  evicted pages moved the page to the start of the LRU list; for
+  innodb_lru_policy=ghost. Protected by buf_pool.mutex. */
+  bool made_young;
 
   /** Block initialization status. Can be modified while holding io_fix()
   or buf_block_t::lock X-latch */
@@ -777,6 +790,7 @@ class buf_page_t
     buf_fix_count_= 0;
     old= 0;
     freed_page_clock= 0;
+    made_young= false;
     access_time= 0;
     oldest_modification_= 0;
     slot= nullptr;
@@ -1292,6 +1306,20 @@ class buf_pool_t
     /** Register the chunk */
     void reg() { map_reg->emplace(map::value_type(blocks->frame, this)); }
 
+    /** Allocate a chunk of buffer frames and initialize the block
+    descriptors, without making the blocks available to buf_pool.
+    @param bytes    requested size
+    @return whether the allocation succeeded */
+    inline bool allocate(size_t bytes);
+
+    /** Add the blocks of an allocate()d chunk to buf_pool.free
+    and register the chunk. */
+    inline void attach();
+
+    /** Free the memory of a chunk that is not attached, or whose
+    blocks have all been withdrawn. */
+    inline void free();
+
     /** Allocate a chunk of buffer frames.
     @param bytes    requested size
     @return whether the allocation succeeded */
@@ -51,6 +51,11 @@ class buf_dblwr_t
     byte* write_buf;
     /** buffer blocks to be written via write_buf */
     element* buf_block_arr;
+    /** the doublewrite block that write_buf is written to; if
+    batch_size > block_size(), the batch continues in block2 */
+    page_id_t block= page_id_t(0, 0);
+    /** whether a batch from this slot is being written */
+    bool batch_running;
   };
 
   /** the page number of the first doublewrite block (block_size() pages) */
@@ -58,14 +63,23 @@ class buf_dblwr_t
   /** the page number of the second doublewrite block (block_size() pages) */
   page_id_t block2= page_id_t(0, 0);
 
+  /** maximum number of pages in a batch (innodb_doublewrite_pages) */
+  uint32_t batch_size;
+
   /** mutex protecting the data members below */
   mysql_mutex_t mutex;
-  /** condition variable for !batch_running */
+  /** condition variable for changes of slot::batch_running, dblwr_slot
+  and write_slot */
   pthread_cond_t cond;
-  /** whether a batch is being written from the doublewrite buffer */
-  bool batch_running;
-  /** number of expected flush_buffered_writes_completed() calls */
-  unsigned flushing_buffered_writes;
+  /** the slot that is being written to its doublewrite block, or nullptr */
+  slot *dblwr_slot;
+  /** number of pending writes of dblwr_slot to the doublewrite buffer */
+  ulint flushing_buffered_writes;
+  /** the slot whose pages are being written to the data files, or nullptr */
+  slot *write_slot;
+  /** a slot whose doublewrite block has been written, and whose pages
+  will be written to the data files once write_slot has completed */
+  slot *ready_slot;
   /** pages submitted to flush_buffered_writes() */
   ulint pages_submitted;
   /** number of flush_buffered_writes_completed() calls */
@@ -73,8 +87,21 @@ class buf_dblwr_t
   /** number of pages written by flush_buffered_writes_completed() */
   ulint pages_written;
 
+  /** If batch_size fits in a doublewrite block, each slot is written to
+  one of the two doublewrite blocks, so that the data page writes of one
+  batch can be in progress while the next batch is being written to the
+  other doublewrite block. Otherwise, a batch fills both blocks, and the
+  next batch is only being collected meanwhile. */
   slot slots[2];
   slot *active_slot= &slots[0];
+#ifdef UNIV_DEBUG
+  /** a batch whose data page writes were held back by
+  ib_dblwr_write_pages_pause, or nullptr */
+  slot *deferred_slot;
+#endif
+
+  /** @return whether each slot has a doublewrite block of its own */
+  bool pipelined() const { return batch_size <= block_size(); }
 
   /** Initialize the doublewrite buffer data structure.
   @param header   doublewrite page header in the TRX_SYS page */
@@ -83,6 +110,18 @@ class buf_dblwr_t
   /** Flush possible buffered writes to persistent storage. */
   bool flush_buffered_writes(const ulint size);
 
+  /** Write the pages of a batch to the data files, after the batch
+  has been written to the doublewrite block and made durable.
+  @param flush_slot  the batch to write */
+  static void write_pages(const slot &flush_slot);
+#ifdef UNIV_DEBUG
+  /** Write the pages of deferred_slot. While ib_dblwr_write_pages_pause
+  is set, they are only written after another batch has been submitted,
+  and that thread waits until the keyword is removed.
+  @param submitted  whether this thread just submitted a batch */
+  void write_deferred(bool submitted);
+#endif
+
 public:
   /** Create or restore the doublewrite buffer in the TRX_SYS page.
   @return whether the operation succeeded */
@@ -159,7 +198,7 @@ class buf_dblwr_t
     if (is_initialised())
     {
       mysql_mutex_lock(&mutex);
-      while (batch_running)
+      while (slots[0].batch_running || slots[1].batch_running)
         my_cond_wait(&cond, &mutex.m_mutex);
       mysql_mutex_unlock(&mutex);
     }
@@ -27,6 +27,8 @@ Created April 08, 2011 Vasil Dimov
 #ifndef buf0dump_h
 #define buf0dump_h
 
+#include "buf0types.h"
+
 /** Start the buffer pool dump/load task and instructs it to start a dump. */
 void buf_dump_start();
 /** Start the buffer pool dump/load task and instructs it to start a load. */
@@ -41,4 +43,38 @@ void buf_load_at_startup();
 /** Wait for currently running load/dumps to finish*/
 void buf_load_dump_end();
 
+/** Write the hottest pages of the buffer pool to
+innodb_buffer_pool_filename.pages, if innodb_buffer_pool_dump_pages is set.
+This is invoked after the final log checkpoint of a shutdown, when no
+page is dirty.
+@param lsn	the shutdown LSN */
+void buf_dump_pages(lsn_t lsn);
+
+/** Check at startup whether the page image that was written by
+buf_dump_pages() at the previous shutdown matches the data files.
+If it does, buf_load() will load the pages from it. This must be
+invoked before any page is modified. */
+void buf_load_pages_prepare();
+
+/** The LSN of the page image that buf_load() is going to load, or 0.
+Protected by buf_pool.mutex. */
+extern lsn_t buf_load_pages_lsn;
+
+/** Note that a page is being removed from the buffer pool
+while buf_load_pages_lsn is set.
+@param bpage	page that is being removed */
+void buf_load_pages_evicted(const buf_page_t &bpage);
+
+/** Note that a tablespace is about to be discarded, dropped or closed.
+Its identifier may be reused by IMPORT TABLESPACE, so that the page image
+is no longer valid for it.
+@param id	tablespace identifier */
+void buf_load_pages_space_stopping(uint32_t id);
+
+/** Check whether the page image may be older than the data file.
+@param id	page identifier
+@return whether the page was modified and evicted after startup, or
+its tablespace was discarded */
+bool buf_load_pages_stale(const page_id_t id);
+
 #endif /* buf0dump_h */
@@ -175,6 +175,34 @@ least this many milliseconds ago.  Not protected by any mutex or latch. */
 extern uint	buf_LRU_old_threshold_ms;
 /* @} */
 
+/** Buffer pool replacement policy (innodb_lru_policy) */
+enum buf_LRU_policy_t
+{
+  /** midpoint insertion; pages read from files enter the old sublist */
+  BUF_LRU_MIDPOINT= 0,
+  /** like BUF_LRU_MIDPOINT, but pages that are read again soon after
+  their eviction enter the young sublist */
+  BUF_LRU_GHOST
+};
+
+/** innodb_lru_policy */
+extern ulong buf_LRU_policy;
+
+/** Allocate the list of recently evicted pages if innodb_lru_policy=ghost.
+@param n  number of pages in the buffer pool */
+void buf_LRU_ghost_create(ulint n);
+/** Resize the list of recently evicted pages with the buffer pool.
+The caller must hold buf_pool.mutex.
+@param n  number of pages in the buffer pool */
+void buf_LRU_ghost_resize(ulint n);
+/** Free the list of recently evicted pages. */
+void buf_LRU_ghost_free();
+/** Check whether a page that is about to be read was evicted recently.
+The caller must hold buf_pool.mutex.
+@param id  page identifier
+@return whether the page should be added to the young sublist */
+bool buf_LRU_ghost_hit(page_id_t id);
+
 /** @brief Statistics for selecting the LRU list for eviction.
 
 These statistics are not 'of' LRU but 'for' LRU.  We keep count of I/O
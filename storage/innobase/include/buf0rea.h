@@ -54,6 +54,16 @@ void buf_read_page_background(fil_space_t *space, const page_id_t page_id,
 			      ulint zip_size, bool sync)
   MY_ATTRIBUTE((nonnull));
 
+/** Add a page to the buffer pool from the page image that was written
+by buf_dump_pages() at the previous shutdown.
+@param space    tablespace (the caller must hold a reference)
+@param page_id  page identifier
+@param frame    contents of the page in the page image
+@return whether the page was added to the buffer pool */
+bool buf_read_page_from_image(fil_space_t *space, const page_id_t page_id,
+                              const byte *frame)
+  MY_ATTRIBUTE((nonnull));
+
 /** Applies a random read-ahead in buf_pool if there are at least a threshold
 value of accessed pages from the random read-ahead area. Does not read any
 page, not even the one at the position (space, offset), if the read-ahead
@@ -102,6 +112,19 @@ which could result in a deadlock if the OS does not support asynchronous io.
 ulint
 buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf);
 
+/** Issue asynchronous reads for pages of a B-tree that a scan is about
+to access in key order (innodb_logical_read_ahead). Pages that are
+already in the buffer pool are skipped.
+NOTE: the calling thread may own latches on pages: this function does
+not wait for any page latches.
+@param space_id  tablespace identifier
+@param pages     page numbers, in the order in which they will be accessed
+@param n         number of elements in pages
+@param zip_size  ROW_FORMAT=COMPRESSED page size, or 0
+@return number of page read requests issued */
+ulint buf_read_ahead_logical(uint32_t space_id, const uint32_t *pages,
+                             ulint n, ulint zip_size);
+
 /** Issues read requests for pages which recovery wants to read in.
 @param[in]	space_id	tablespace id
 @param[in]	page_nos	array of page numbers to read, with the
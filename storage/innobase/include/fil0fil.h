@@ -102,6 +102,9 @@ class page_id_t;
 /** Structure containing encryption specification */
 struct fil_space_crypt_t;
 
+/** Trained zstd dictionary of a page_compressed tablespace */
+struct fil_zstd_dict_t;
+
 /** File types */
 enum fil_type_t {
 	/** temporary tablespace (temporary undo log or tables) */
@@ -354,11 +357,15 @@ struct fil_space_t final
   }
 	ulint		id;	/*!< space id */
 	hash_node_t	hash;	/*!< hash chain node */
-	lsn_t		max_lsn;
-				/*!< LSN of the most recent
-				fil_names_write_if_was_clean().
-				Reset to 0 by fil_names_clear().
-				Protected by log_sys.mutex.
+	Atomic_relaxed<lsn_t> max_lsn;
+				/*!< start LSN of the most recent
+				log written for the tablespace.
+				Set from 0 by
+				fil_names_write_if_was_clean() under
+				log_sys.mutex and advanced by
+				update_max_lsn(). Reset to 0 by
+				fil_names_clear() under exclusive
+				log_sys.latch.
 				If and only if this is nonzero, the
 				tablespace will be in named_spaces. */
 	/** whether undo tablespace truncation is in progress */
@@ -416,6 +423,10 @@ struct fil_space_t final
 	/** MariaDB encryption data */
 	fil_space_crypt_t* crypt_data;
 
+	/** zstd dictionary for page_compressed pages, or nullptr;
+	assigned once, on the first page of the file */
+	std::atomic<fil_zstd_dict_t*> zstd_dict;
+
 	/** Checks that this tablespace in a list of unflushed tablespaces. */
 	bool is_in_unflushed_spaces;
 
@@ -429,6 +440,22 @@ struct fil_space_t final
 	punch hole */
 	bool		punch_hole;
 
+	/** page_compressed statistics, for
+	INFORMATION_SCHEMA.INNODB_TABLESPACES_PAGE_COMPRESSION */
+	struct page_compression_stats
+	{
+		/** number of compressed page writes */
+		Atomic_counter<ulint>	compressed;
+		/** total size of the compressed page images */
+		Atomic_counter<ulint>	compressed_bytes;
+		/** microseconds spent in fil_page_compress() */
+		Atomic_counter<ulint>	compress_usec;
+		/** number of decompressed page reads */
+		Atomic_counter<ulint>	decompressed;
+		/** microseconds spent in fil_page_decompress() */
+		Atomic_counter<ulint>	decompress_usec;
+	} page_compression;
+
 	/** mutex to protect freed ranges */
 	std::mutex	freed_range_mutex;
 
@@ -607,6 +634,16 @@ struct fil_space_t final
   /** Close all tablespace files at shutdown */
   static void close_all();
 
+  /** Note that log was written for the tablespace. The caller must hold
+  log_sys.latch in shared mode, and max_lsn must be nonzero.
+  @param lsn  start LSN of the log */
+  void update_max_lsn(lsn_t lsn)
+  {
+    lsn_t old= max_lsn;
+    ut_ad(old);
+    while (old < lsn && !max_lsn.compare_exchange_strong(old, lsn));
+  }
+
   /** @return last_freed_lsn */
   lsn_t get_last_freed_lsn() { return last_freed_lsn; }
   /** Update last_freed_lsn */
@@ -753,6 +790,7 @@ struct fil_space_t final
 		case PAGE_LZ4_ALGORITHM:
 		case PAGE_LZO_ALGORITHM:
 		case PAGE_SNAPPY_ALGORITHM:
+		case PAGE_ZSTD_ALGORITHM:
 			return true;
 		}
 		return false;
@@ -1775,25 +1813,29 @@ void fil_names_dirty_and_write(fil_space_t* space);
 
 /** Write FILE_MODIFY records if a persistent tablespace was modified
 for the first time since the latest fil_names_clear().
+The caller must hold log_sys.latch in shared mode, and update
+space->max_lsn after reserving the log.
 @param[in,out]	space	tablespace
-@param[in,out]	mtr	mini-transaction
 @return whether any FILE_MODIFY record was written */
 inline bool fil_names_write_if_was_clean(fil_space_t* space)
 {
-	mysql_mutex_assert_owner(&log_sys.mutex);
-
-	if (space == NULL) {
+	if (space == NULL || space->max_lsn) {
+		/* max_lsn can only be reset while log_sys.latch is
+		held in exclusive mode. */
 		return(false);
 	}
 
+	mysql_mutex_lock(&log_sys.mutex);
+
 	const bool	was_clean = space->max_lsn == 0;
-	ut_ad(space->max_lsn <= log_sys.get_lsn());
-	space->max_lsn = log_sys.get_lsn();
 
 	if (was_clean) {
+		space->max_lsn = log_sys.get_lsn();
 		fil_names_dirty_and_write(space);
 	}
 
+	mysql_mutex_unlock(&log_sys.mutex);
+
 	return(was_clean);
 }
 
@@ -35,26 +35,60 @@ Created 11/12/2013 Jan Lindström jan.lindstrom@skysql.com
 @param[in]	flags		tablespace flags
 @param[in]	block_size	file system block size
 @param[in]	encrypted	whether the page will be subsequently encrypted
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return actual length of compressed page
 @retval	0	if the page was not compressed */
 ulint fil_page_compress(
-	const byte*	buf,
-	byte*		out_buf,
-	ulint		flags,
-	ulint		block_size,
-	bool		encrypted)
-	MY_ATTRIBUTE((nonnull, warn_unused_result));
+	const byte*		buf,
+	byte*			out_buf,
+	ulint			flags,
+	ulint			block_size,
+	bool			encrypted,
+	const fil_zstd_dict_t*	dict = nullptr)
+	MY_ATTRIBUTE((nonnull(1,2), warn_unused_result));
 
 /** Decompress a page that may be subject to page_compressed compression.
 @param[in,out]	tmp_buf		temporary buffer (of innodb_page_size)
 @param[in,out]	buf		compressed page buffer
 @param[in]	flags		talespace flags
+@param[in]	dict		zstd dictionary of the tablespace, or nullptr
 @return size of the compressed data
 @retval	0		if decompression failed
 @retval	srv_page_size	if the page was not compressed */
 ulint fil_page_decompress(
-	byte*	tmp_buf,
-	byte*	buf,
-	ulint	flags)
+	byte*			tmp_buf,
+	byte*			buf,
+	ulint			flags,
+	const fil_zstd_dict_t*	dict = nullptr)
+	MY_ATTRIBUTE((nonnull(1,2), warn_unused_result));
+
+/** Read the zstd dictionary from the first page of a page_compressed
+tablespace.
+@param[in]	page	first page of the tablespace
+@return the dictionary, to be freed by fil_zstd_dict_free()
+@retval	nullptr	if the page does not carry a dictionary */
+fil_zstd_dict_t* fil_zstd_dict_read(const byte* page)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+
+/** Free a zstd dictionary.
+@param[in,out]	dict	dictionary returned by fil_zstd_dict_read(),
+or nullptr */
+void fil_zstd_dict_free(fil_zstd_dict_t* dict);
+
+/** Determine if fil_zstd_dict_train() can train a dictionary.
+@param[in]	space	tablespace
+@return whether the tablespace is page_compressed with zstd */
+bool fil_zstd_dict_applicable(const fil_space_t& space)
+	MY_ATTRIBUTE((warn_unused_result));
+
+/** Train a zstd dictionary on a sample of the index pages of a
+page_compressed tablespace, store it in the first page, and start
+compressing pages with it. Once stored, the dictionary is never replaced,
+because the pages that were compressed with it refer to it.
+@param[in,out]	space	page_compressed tablespace
+@return error code
+@retval	DB_SUCCESS	if the tablespace has a dictionary
+@retval	DB_UNSUPPORTED	if the tablespace is not compressed with zstd */
+dberr_t fil_zstd_dict_train(fil_space_t* space)
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
 #endif
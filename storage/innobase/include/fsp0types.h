@@ -43,7 +43,8 @@ static constexpr size_t SRV_SPACE_ID_UPPER_BOUND= 0xFFFFFFF0;
 #define PAGE_LZMA_ALGORITHM	4
 #define PAGE_BZIP2_ALGORITHM	5
 #define PAGE_SNAPPY_ALGORITHM	6
-#define PAGE_ALGORITHM_LAST	PAGE_SNAPPY_ALGORITHM
+#define PAGE_ZSTD_ALGORITHM	7
+#define PAGE_ALGORITHM_LAST	PAGE_ZSTD_ALGORITHM
 
 /** @name Flags for inserting records in order
 If records are inserted in order, there are the following
@@ -114,6 +114,10 @@ struct fts_sync_t {
 	bool		in_progress;	/*!< flag whether sync is in progress.*/
 	bool		unlock_cache;	/*!< flag whether unlock cache when
 					write fts node */
+	bool		catch_up;	/*!< flag whether the SYNC is writing
+					the nodes that were added while a
+					previous pass released the cache
+					lock */
   /** condition variable for in_progress; used with table->fts->cache->lock */
   pthread_cond_t cond;
 };
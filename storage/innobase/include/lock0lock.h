@@ -600,6 +600,9 @@ class lock_sys_t
     in any hash chain, lock_t::is_waiting() entries must not precede
     granted locks */
     hash_cell_t *array;
+    /** number of times that a latch of this table was found to be held
+    by another thread */
+    Atomic_counter<ulint> latch_waits;
 
     /** Create the hash table.
     @param n  the lower bound of n_cells */
@@ -624,6 +627,25 @@ class lock_sys_t
                              (ELEMENTS_PER_LATCH + LATCH));
       return static_cast<hash_latch*>(l);
     }
+    /** Acquire the latch of a cell, counting any contention.
+    @param cell  hash table cell */
+    void acquire(hash_cell_t *cell)
+    {
+      hash_latch *l= latch(cell);
+      if (!l->try_acquire())
+      {
+        latch_waits++;
+        l->acquire();
+      }
+    }
+    /** Try to acquire the latch of a cell, without waiting.
+    @param cell  hash table cell
+    @return whether the latch was acquired */
+    static bool try_acquire(hash_cell_t *cell)
+    { return latch(cell)->try_acquire(); }
+    /** Release the latch of a cell.
+    @param cell  hash table cell that was passed to acquire() */
+    static void release(hash_cell_t *cell) { latch(cell)->release(); }
     /** Get a hash table cell. */
     inline hash_cell_t *cell_get(ulint fold) const;
 
@@ -687,6 +709,9 @@ class lock_sys_t
   ulint deadlocks;
   /** number of lock wait timeouts; protected by wait_mutex */
   ulint timeouts;
+  /** number of exclusive latch acquisitions, each of which blocks
+  access to all hash table cells; protected by latch */
+  ulint latch_exclusive;
   /**
     Constructor.
 
@@ -717,6 +742,7 @@ class lock_sys_t
     latch.wr_lock();
     ut_ad(!writer.exchange(os_thread_get_curr_id(),
                            std::memory_order_relaxed));
+    latch_exclusive++;
   }
   /** Release exclusive lock_sys.latch */
   void wr_unlock()
@@ -750,6 +776,7 @@ class lock_sys_t
     if (!latch.wr_lock_try()) return false;
     ut_ad(!writer.exchange(os_thread_get_curr_id(),
                            std::memory_order_relaxed));
+    latch_exclusive++;
     return true;
   }
   /** Try to acquire shared lock_sys.latch
@@ -923,7 +950,7 @@ struct LockGuard
   LockGuard(lock_sys_t::hash_table &hash, const page_id_t id);
   ~LockGuard()
   {
-    lock_sys_t::hash_table::latch(cell_)->release();
+    lock_sys_t::hash_table::release(cell_);
     /* Must be last, to avoid a race with lock_sys_t::hash_table::resize() */
     lock_sys.rd_unlock();
   }
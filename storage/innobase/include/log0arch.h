@@ -0,0 +1,71 @@
+/*****************************************************************************
+
+Copyright (c) 2026, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/log0arch.h
+Redo log archiving (innodb_log_archive_dir)
+
+The circular redo log file may overwrite log that precedes the latest
+checkpoint. When archiving is enabled, each log checkpoint lets a
+background task copy the log blocks between the previous and the new
+checkpoint into an archive file, so that mariabackup --prepare can later
+roll a backup forward past the end of the log that was copied during the
+backup. Until the copying has finished, the log is not overwritten.
+If the copying fails, archiving stops (Innodb_log_archive_stopped=ON).
+
+An archive file consists of whole log blocks, exactly as they were
+written to ib_logfile0. The file name contains the 20-digit decimal LSN
+of the first block; the file covers the LSN range from there up to the
+file size. Files may overlap, but the contents of an LSN is the same in
+each file.
+*******************************************************/
+
+#pragma once
+
+#include "log0log.h"
+
+/** innodb_log_archive_dir: where to archive the redo log, or NULL */
+extern char *srv_log_archive_dir;
+
+/** Prefix of the redo log archive file names */
+static const char LOG_ARCHIVE_PREFIX[]= "ib_logarch.";
+
+/** End of the archived log, or LSN_MAX if the log is not being archived */
+extern Atomic_relaxed<lsn_t> log_archived_lsn;
+
+/** Innodb_log_archive_stopped: whether archiving stopped after an error */
+extern bool log_archive_stopped;
+
+/** @return the LSN after which the log may not be overwritten:
+log_sys.last_checkpoint_lsn, or the end of the archived log if the
+archiving is lagging behind */
+inline lsn_t log_archive_checkpoint_lsn()
+{
+  return std::min<lsn_t>(log_sys.last_checkpoint_lsn, log_archived_lsn);
+}
+
+/** Request the redo log up to a checkpoint to be archived, before it
+can be overwritten. The copying is done by a background task.
+@param checkpoint_lsn  the new checkpoint LSN; must be durably written */
+void log_archive(lsn_t checkpoint_lsn);
+
+/** Wait for the pending archiving to finish. */
+void log_archive_wait();
+
+/** Finish the archiving and close the archive file. */
+void log_archive_close();
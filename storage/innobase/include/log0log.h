@@ -38,11 +38,16 @@ Created 12/9/1995 Heikki Tuuri
 #include "os0file.h"
 #include "span.h"
 #include "my_atomic_wrapper.h"
+#include "srw_lock.h"
 #include <vector>
 #include <string>
+#include <mutex>
+#include <condition_variable>
 
 using st_::span;
 
+extern ulong srv_log_buffer_size;
+
 static const char LOG_FILE_NAME_PREFIX[] = "ib_logfile";
 static const char LOG_FILE_NAME[] = "ib_logfile0";
 
@@ -62,17 +67,6 @@ static inline void delete_log_file(const char* suffix)
   os_file_delete_if_exists(innodb_log_file_key, path.c_str(), nullptr);
 }
 
-/** Append a string to the log.
-@param[in]	str		string
-@param[in]	len		string length
-@param[out]	start_lsn	start LSN of the log record
-@return end lsn of the log record, zero if did not succeed */
-UNIV_INLINE
-lsn_t
-log_reserve_and_write_fast(
-	const void*	str,
-	ulint		len,
-	lsn_t*		start_lsn);
 /***********************************************************************//**
 Checks if there is need for a log buffer flush or a new checkpoint, and does
 this if yes. Any database operation should call this when it has modified
@@ -475,22 +469,48 @@ struct log_t{
   preflush buffer pool pages, or initiate a log checkpoint.
   This must hold if lsn - last_checkpoint_lsn > max_checkpoint_age. */
   std::atomic<bool> check_flush_or_checkpoint_;
+  /** number of copy_slots */
+  static constexpr size_t N_COPY_SLOTS= 64;
+  /** A log buffer range that is being copied to by mtr_t::commit() */
+  struct copy_slot
+  {
+    /** a lower bound of the start LSN of the range, or 0 if unused */
+    MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) std::atomic<lsn_t> start;
+  };
+  /** ranges of buf that were reserved by advancing lsn, and are
+  being copied to; the prefix of buf that precedes all of them
+  has been copied completely, @see get_copied_lsn() */
+  copy_slot copy_slots[N_COPY_SLOTS];
+  /** number of threads waiting in wait_copied() */
+  std::atomic<uint32_t> copy_waiters;
+  /** mutex for copy_cond */
+  std::mutex copy_mutex;
+  /** signalled by copy_end() when copy_waiters is nonzero */
+  std::condition_variable copy_cond;
 public:
+  /** latch that is held in shared mode by mtr_t::commit() from the
+  fil_names_write_if_was_clean() check until lsn has been advanced,
+  and in exclusive mode when no log may be reserved, such as in
+  log_checkpoint() or log_buffer_extend(). Must be acquired before mutex. */
+  MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) srw_lock_low latch;
   /** mutex protecting the log */
   MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) mysql_mutex_t mutex;
-  /** first free offset within the log buffer in use */
-  size_t buf_free;
-  /** recommended maximum size of buf, after which the buffer is flushed */
+  /** start of the log block that will be written next; buf holds the
+  log from here up to lsn. Advanced by log_write(). */
+  std::atomic<lsn_t> buf_start_lsn;
+  /** recommended maximum of lsn - buf_start_lsn, after which the buffer
+  is flushed */
   size_t max_buf_free;
   /** mutex to serialize access to the flush list when we are putting
   dirty blocks in the list. The idea behind this mutex is to be able
-  to release log_sys.mutex during mtr_commit and still ensure that
+  to release log_sys.latch during mtr_commit and still ensure that
   insertions in the flush_list happen in the LSN order. */
   MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE) mysql_mutex_t flush_order_mutex;
-  /** log_buffer, append data here */
+  /** log_buffer, append data here. This is a ring buffer where the log
+  block of an LSN is at buf_block(lsn). */
   byte *buf;
-  /** log_buffer, writing data to file from this buffer.
-  Before flushing write_buf is swapped with flush_buf */
+  /** log_buffer, log_write() copies data from buf to this buffer
+  and writes it to the file from here */
   byte *flush_buf;
   /** Log file stuff. Protected by mutex. */
   struct file {
@@ -520,6 +540,8 @@ struct log_t{
     void write_header_durable(lsn_t lsn);
     /** opens log file which must be closed prior this call */
     dberr_t rename(std::string path) { return fd.rename(path); }
+    /** @return the name of the log file */
+    const std::string &get_path() const { return fd.get_path(); }
     /** reads buffer from log file
     @param[in]	offset		offset in log file
     @param[in]	buf		buffer where to read */
@@ -576,13 +598,6 @@ struct log_t{
 
 	/** The fields involved in the log buffer flush @{ */
 
-	size_t		buf_next_to_write;/*!< first offset in the log buffer
-					where the byte content may not exist
-					written to file, e.g., the start
-					offset of a log record catenated
-					later; this is advanced when a flush
-					operation is completed to all the log
-					groups */
 	lsn_t		write_lsn;	/*!< last written lsn */
 	lsn_t		current_flush_lsn;/*!< end lsn for the current running
 					write + flush operation */
@@ -649,6 +664,12 @@ struct log_t{
   lsn_t get_lsn(std::memory_order order= std::memory_order_relaxed) const
   { return lsn.load(order); }
   void set_lsn(lsn_t lsn) { this->lsn.store(lsn, std::memory_order_release); }
+  /** Advance lsn over log records that will be copied to buf.
+  @param start  expected lsn; updated to the current lsn on failure
+  @param end    end LSN of the log records
+  @return whether lsn was advanced from start to end */
+  bool advance_lsn(lsn_t &start, lsn_t end)
+  { return lsn.compare_exchange_weak(start, end); }
 
   lsn_t get_flushed_lsn() const
   { return flushed_to_disk_lsn.load(std::memory_order_acquire); }
@@ -690,6 +711,45 @@ struct log_t{
       : OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_CHECKSUM;
   }
 
+  /** Calculate the end LSN of log records.
+  @param start  start LSN of the log records
+  @param len    length of the log records, excluding the log block framing
+  @return end LSN of the log records */
+  lsn_t calc_end_lsn(lsn_t start, size_t len) const
+  {
+    const size_t used= size_t(start % OS_FILE_LOG_BLOCK_SIZE);
+    ut_ad(used >= LOG_BLOCK_HDR_SIZE);
+    ut_ad(used < trailer_offset());
+    const size_t payload= payload_size();
+    const size_t total= used - LOG_BLOCK_HDR_SIZE + len;
+    return start - used + (total / payload) * OS_FILE_LOG_BLOCK_SIZE +
+      LOG_BLOCK_HDR_SIZE + total % payload;
+  }
+
+  /** @return the position of the log block of an LSN in buf */
+  byte *buf_block(lsn_t lsn) const
+  {
+    return buf + size_t(ut_uint64_align_down(lsn, OS_FILE_LOG_BLOCK_SIZE) %
+                        srv_log_buffer_size);
+  }
+
+  /** Acquire a copy slot before advancing lsn.
+  @param start  a lower bound of the start LSN of the log records
+  @return the copy slot */
+  size_t copy_start(lsn_t start);
+  /** Update the lower bound of the start LSN in a copy slot, before
+  retrying advance_lsn() */
+  void copy_update(size_t slot, lsn_t start)
+  { copy_slots[slot].start.store(start); }
+  /** Note that the log records were copied to the reserved space in buf.
+  @param slot  the copy slot that copy_start() returned */
+  void copy_end(size_t slot);
+  /** @return the end of the completely copied prefix of buf */
+  lsn_t get_copied_lsn() const;
+  /** Wait until buf has been copied to up to an LSN.
+  @param lsn  an LSN that is at most get_lsn() */
+  void wait_copied(lsn_t lsn);
+
   size_t get_pending_flushes() const
   {
     return pending_flushes.load(std::memory_order_relaxed);
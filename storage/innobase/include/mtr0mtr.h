@@ -615,13 +615,21 @@ struct mtr_t {
   inline void log_write_extended(const buf_block_t &block, byte type);
 
   /** Prepare to write the mini-transaction log to the redo log buffer.
+  If anything is to be written, log_sys.latch will be held in shared mode.
   @return number of bytes to write in finish_write() */
   inline ulint prepare_write();
 
-  /** Append the redo log records to the redo log buffer.
-  @param len   number of bytes to write
+  /** Reserve space for the redo log records in the redo log buffer.
+  The records must be copied there by copy_log().
+  If m_made_dirty, log_sys.flush_order_mutex will be acquired.
+  @param len    number of bytes to write
+  @param files  whether the caller holds log_sys.mutex (commit_files())
   @return {start_lsn,flush_ahead} */
-  inline std::pair<lsn_t,bool> finish_write(ulint len);
+  inline std::pair<lsn_t,bool> finish_write(ulint len, bool files= false);
+
+  /** Copy the redo log records to the space that finish_write()
+  reserved. This does not require any log_sys latch to be held. */
+  inline void copy_log();
 
   /** Release the resources */
   inline void release_resources();
@@ -685,6 +693,11 @@ struct mtr_t {
   /** LSN at commit time */
   lsn_t m_commit_lsn;
 
+  /** start LSN of the log_sys.buf range reserved by finish_write() */
+  lsn_t m_copy_lsn;
+  /** log_sys.copy_slots[] entry of the range reserved by finish_write() */
+  size_t m_copy_slot;
+
   /** tablespace where pages have been freed */
   fil_space_t *m_freed_space= nullptr;
   /** set of freed page ids */
@@ -214,6 +214,12 @@ class ReadView: public ReadViewBase
   */
   trx_id_t m_creator_trx_id;
 
+  /**
+    trx_sys.get_deregistered() before the snapshot was taken.
+    Used exclusively by the read view owner thread.
+  */
+  uint64_t m_deregistered;
+
 public:
   ReadView(): m_open(false)
   { mysql_mutex_init(read_view_mutex_key, &m_mutex, nullptr); }
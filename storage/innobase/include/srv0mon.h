@@ -143,6 +143,9 @@ enum monitor_id_t {
 	MONITOR_MODULE_LOCK,
 	MONITOR_DEADLOCK,
 	MONITOR_TIMEOUT,
+	MONITOR_LOCK_SYS_EXCLUSIVE,
+	MONITOR_REC_HASH_LATCH_WAITS,
+	MONITOR_PRDT_HASH_LATCH_WAITS,
 	MONITOR_LOCKREC_WAIT,
 	MONITOR_TABLELOCK_WAIT,
 	MONITOR_NUM_RECLOCK_REQ,
@@ -229,6 +232,8 @@ enum monitor_id_t {
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_NUM_CALL,
 	MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL,
+	MONITOR_LRU_GHOST_ADDED,
+	MONITOR_LRU_GHOST_HITS,
 
 	/* Buffer Page I/O specific counters. */
 	MONITOR_MODULE_BUF_PAGE,
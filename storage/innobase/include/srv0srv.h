@@ -120,6 +120,8 @@ struct srv_stats_t
 	ulint_ctr_n_t          non_index_pages_written;
 	/* Number of pages compressed with page compression */
         ulint_ctr_n_t          pages_page_compressed;
+	/* Number of pages compressed with a zstd dictionary */
+	ulint_ctr_n_t          pages_page_compressed_dict;
 	/* Number of TRIM operations induced by page compression */
         ulint_ctr_n_t          page_compressed_trim_op;
 	/* Number of pages decompressed with page compression */
@@ -202,6 +204,9 @@ extern char*		srv_buf_dump_filename;
 and/or load it during startup. */
 extern char		srv_buffer_pool_dump_at_shutdown;
 extern char		srv_buffer_pool_load_at_startup;
+/** innodb_buffer_pool_dump_pages: whether the page contents are dumped
+along with the page identifiers at shutdown */
+extern my_bool		srv_buffer_pool_dump_pages;
 
 /* Whether to disable file system cache if it is defined */
 extern char		srv_disable_sort_file_cache;
@@ -251,6 +256,10 @@ extern my_bool	srv_numa_interleave;
 /* Use atomic writes i.e disable doublewrite buffer */
 extern my_bool srv_use_atomic_writes;
 
+/** innodb_atomic_write_paths: directories whose storage is asserted to
+write innodb_page_size pages atomically */
+extern char* srv_atomic_write_paths;
+
 /* Compression algorithm*/
 extern ulong innodb_compression_algorithm;
 
@@ -345,8 +354,10 @@ extern ulong	srv_checksum_algorithm;
 extern uint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+extern ulong	srv_logical_read_ahead;
 extern uint	srv_n_read_io_threads;
 extern uint	srv_n_write_io_threads;
+extern uint	srv_page_compression_threads;
 
 /* Defragmentation, Origianlly facebook default value is 100, but it's too high */
 #define SRV_DEFRAGMENT_FREQUENCY_DEFAULT 40
@@ -401,6 +412,9 @@ extern unsigned long long	srv_stats_modified_counter;
 extern my_bool			srv_stats_sample_traditional;
 
 extern my_bool	srv_use_doublewrite_buf;
+/** innodb_doublewrite_pages: maximum number of pages in a doublewrite
+batch, or 0 for the whole doublewrite buffer */
+extern uint	srv_doublewrite_pages;
 extern ulong	srv_checksum_algorithm;
 
 extern my_bool	srv_force_primary_key;
@@ -798,6 +812,9 @@ struct export_var_t{
 						written */
 	int64_t innodb_pages_page_compressed;/*!< Number of pages
 						compressed by page compression */
+	int64_t innodb_pages_page_compressed_dict;/*!< Number of pages
+						compressed with a zstd
+						dictionary */
 	int64_t innodb_page_compressed_trim_op;/*!< Number of TRIM operations
 						induced by page compression */
 	int64_t innodb_pages_page_decompressed;/*!< Number of pages
@@ -868,6 +868,19 @@ class trx_sys_t
   MY_ALIGNED(CACHE_LINE_SIZE) std::atomic<trx_id_t> m_rw_trx_hash_version;
 
 
+  /**
+    Number of completed deregister_rw() calls.
+
+    A closed read view may be reused as is if neither this nor m_max_trx_id
+    changed since its creation: no transaction was started, committed or
+    assigned a transaction number in between.
+
+    @sa deregister_rw()
+    @sa ReadView::open()
+  */
+  MY_ALIGNED(CACHE_LINE_SIZE) std::atomic<uint64_t> m_deregistered;
+
+
   bool m_initialised;
 
 public:
@@ -953,6 +966,16 @@ class trx_sys_t
   }
 
 
+  /**
+    @return number of completed deregister_rw() calls
+    @sa m_deregistered
+  */
+  uint64_t get_deregistered() const
+  {
+    return m_deregistered.load(std::memory_order_acquire);
+  }
+
+
   /**
     Allocates a new transaction id.
     @return new, allocated trx id
@@ -1094,6 +1117,7 @@ class trx_sys_t
   void deregister_rw(trx_t *trx)
   {
     rw_trx_hash.erase(trx);
+    m_deregistered.fetch_add(1, std::memory_order_release);
   }
 
 
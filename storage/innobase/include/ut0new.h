@@ -841,12 +841,14 @@ constexpr const char* const auto_event_names[] =
   "buf0buf",
   "buf0dblwr",
   "buf0dump",
+  "buf0lru",
   "dict0dict",
   "dict0mem",
   "dict0stats",
   "eval0eval",
   "fil0crypt",
   "fil0fil",
+  "fil0pagecompress",
   "fsp0file",
   "fts0ast",
   "fts0blex",
@@ -24,6 +24,7 @@ INCLUDE(lzo.cmake)
 INCLUDE(lzma.cmake)
 INCLUDE(bzip2.cmake)
 INCLUDE(snappy.cmake)
+INCLUDE(zstd.cmake)
 INCLUDE(numa)
 INCLUDE(TestBigEndian)
 
@@ -32,6 +33,7 @@ MYSQL_CHECK_LZO()
 MYSQL_CHECK_LZMA()
 MYSQL_CHECK_BZIP2()
 MYSQL_CHECK_SNAPPY()
+MYSQL_CHECK_ZSTD()
 MYSQL_CHECK_NUMA()
 
 INCLUDE(${MYSQL_CMAKE_SCRIPT_DIR}/compile_flags.cmake)
@@ -97,6 +99,11 @@ IF(HAVE_SCHED_GETCPU)
  ADD_DEFINITIONS(-DHAVE_SCHED_GETCPU=1)
 ENDIF()
 
+CHECK_FUNCTION_EXISTS(copy_file_range HAVE_COPY_FILE_RANGE)
+IF(HAVE_COPY_FILE_RANGE)
+ ADD_DEFINITIONS(-DHAVE_COPY_FILE_RANGE=1)
+ENDIF()
+
 IF(HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE)
  ADD_DEFINITIONS(-DHAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE=1)
 ENDIF()
@@ -198,7 +198,7 @@ LockGuard::LockGuard(lock_sys_t::hash_table &hash, page_id_t id)
   const auto id_fold= id.fold();
   lock_sys.rd_lock(SRW_LOCK_CALL);
   cell_= hash.cell_get(id_fold);
-  hash.latch(cell_)->acquire();
+  hash.acquire(cell_);
 }
 
 LockMultiGuard::LockMultiGuard(lock_sys_t::hash_table &hash,
@@ -210,21 +210,20 @@ LockMultiGuard::LockMultiGuard(lock_sys_t::hash_table &hash,
   cell1_= hash.cell_get(id1_fold);
   cell2_= hash.cell_get(id2_fold);
 
-  auto latch1= hash.latch(cell1_), latch2= hash.latch(cell2_);
-  if (latch1 > latch2)
-    std::swap(latch1, latch2);
-  latch1->acquire();
-  if (latch1 != latch2)
-    latch2->acquire();
+  hash_cell_t *c1= cell1_, *c2= cell2_;
+  if (hash.latch(c1) > hash.latch(c2))
+    std::swap(c1, c2);
+  hash.acquire(c1);
+  if (hash.latch(c1) != hash.latch(c2))
+    hash.acquire(c2);
 }
 
 LockMultiGuard::~LockMultiGuard()
 {
-  auto latch1= lock_sys_t::hash_table::latch(cell1_),
-    latch2= lock_sys_t::hash_table::latch(cell2_);
-  latch1->release();
-  if (latch1 != latch2)
-    latch2->release();
+  lock_sys_t::hash_table::release(cell1_);
+  if (lock_sys_t::hash_table::latch(cell1_) !=
+      lock_sys_t::hash_table::latch(cell2_))
+    lock_sys_t::hash_table::release(cell2_);
   /* Must be last, to avoid a race with lock_sys_t::hash_table::resize() */
   lock_sys.rd_unlock();
 }
@@ -395,6 +394,7 @@ void lock_sys_t::wr_lock(const char *file, unsigned line)
   mysql_mutex_assert_not_owner(&wait_mutex);
   latch.wr_lock(file, line);
   ut_ad(!writer.exchange(os_thread_get_curr_id(), std::memory_order_relaxed));
+  latch_exclusive++;
 }
 /** Release exclusive lock_sys.latch */
 void lock_sys_t::wr_unlock()
@@ -2712,17 +2712,15 @@ static void lock_assert_no_spatial(const page_id_t id)
 {
   const auto id_fold= id.fold();
   auto cell= lock_sys.prdt_page_hash.cell_get(id_fold);
-  auto latch= lock_sys_t::hash_table::latch(cell);
-  latch->acquire();
+  lock_sys.prdt_page_hash.acquire(cell);
   /* there should exist no page lock on the left page,
   otherwise, it will be blocked from merge */
   ut_ad(!lock_sys_t::get_first(*cell, id));
-  latch->release();
+  lock_sys.prdt_page_hash.release(cell);
   cell= lock_sys.prdt_hash.cell_get(id_fold);
-  latch= lock_sys_t::hash_table::latch(cell);
-  latch->acquire();
+  lock_sys.prdt_hash.acquire(cell);
   ut_ad(!lock_sys_t::get_first(*cell, id));
-  latch->release();
+  lock_sys.prdt_hash.release(cell);
 }
 #endif
 
@@ -2933,17 +2931,15 @@ lock_update_discard(
 	} else {
 		const auto fold = page_id.fold();
 		auto cell = lock_sys.prdt_hash.cell_get(fold);
-		auto latch = lock_sys_t::hash_table::latch(cell);
-		latch->acquire();
+		lock_sys.prdt_hash.acquire(cell);
 		lock_rec_free_all_from_discard_page(page_id, *cell,
 						    lock_sys.prdt_hash);
-		latch->release();
+		lock_sys.prdt_hash.release(cell);
 		cell = lock_sys.prdt_page_hash.cell_get(fold);
-		latch = lock_sys_t::hash_table::latch(cell);
-		latch->acquire();
+		lock_sys.prdt_page_hash.acquire(cell);
 		lock_rec_free_all_from_discard_page(page_id, *cell,
 						    lock_sys.prdt_page_hash);
-		latch->release();
+		lock_sys.prdt_page_hash.release(cell);
 	}
 }
 
@@ -3463,13 +3459,14 @@ void lock_table_resurrect(dict_table_t *table, trx_t *trx, lock_mode mode)
   if (lock_table_has(trx, table, mode))
     return;
 
-  {
-    LockMutexGuard g{SRW_LOCK_CALL};
-    ut_ad(!lock_table_other_has_incompatible(trx, LOCK_WAIT, table, mode));
+  lock_sys.rd_lock(SRW_LOCK_CALL);
+  table->lock_mutex_lock();
+  ut_ad(!lock_table_other_has_incompatible(trx, LOCK_WAIT, table, mode));
 
-    trx->mutex_lock();
-    lock_table_create(table, mode, trx, nullptr);
-  }
+  trx->mutex_lock();
+  lock_table_create(table, mode, trx, nullptr);
+  table->lock_mutex_unlock();
+  lock_sys.rd_unlock();
   trx->mutex_unlock();
 }
 
@@ -3731,13 +3728,12 @@ static bool lock_release_try(trx_t *trx)
             trx->dict_operation);
       auto &lock_hash= lock_sys.hash_get(lock->type_mode);
       auto cell= lock_hash.cell_get(lock->un_member.rec_lock.page_id.fold());
-      auto latch= lock_sys_t::hash_table::latch(cell);
-      if (!latch->try_acquire())
+      if (!lock_hash.try_acquire(cell))
         all_released= false;
       else
       {
         lock_rec_dequeue_from_page(lock, false);
-        latch->release();
+        lock_hash.release(cell);
       }
     }
     else
@@ -5333,30 +5329,33 @@ lock_trx_holds_autoinc_locks(
 	return(!ib_vector_is_empty(trx->autoinc_locks));
 }
 
-/** Release all AUTO_INCREMENT locks of the transaction. */
+/** Release all AUTO_INCREMENT locks of the transaction. Like lock_table(),
+this only needs the shared lock_sys.latch and the lock_mutex of each table. */
 static void lock_release_autoinc_locks(trx_t *trx)
 {
+  lock_sys.rd_lock(SRW_LOCK_CALL);
+  auto autoinc_locks= trx->autoinc_locks;
+  ut_a(autoinc_locks);
+
+  /* Only the thread that is serving the transaction adds or removes
+  granted AUTO_INC locks, so the vector is stable while no lock is held.
+  We release the locks in the reverse order. This is to avoid
+  searching the vector for the element to delete at the lower level.
+  See (lock_table_remove_low()) for details. */
+  while (ulint size= ib_vector_size(autoinc_locks))
   {
-    LockMutexGuard g{SRW_LOCK_CALL};
-    mysql_mutex_lock(&lock_sys.wait_mutex);
+    lock_t *lock= *static_cast<lock_t**>
+      (ib_vector_get(autoinc_locks, size - 1));
+    ut_ad(lock->type_mode == (LOCK_AUTO_INC | LOCK_TABLE));
+    dict_table_t *table= lock->un_member.tab_lock.table;
+    table->lock_mutex_lock();
     trx->mutex_lock();
-    auto autoinc_locks= trx->autoinc_locks;
-    ut_a(autoinc_locks);
-
-    /* We release the locks in the reverse order. This is to avoid
-    searching the vector for the element to delete at the lower level.
-    See (lock_table_remove_low()) for details. */
-    while (ulint size= ib_vector_size(autoinc_locks))
-    {
-      lock_t *lock= *static_cast<lock_t**>
-        (ib_vector_get(autoinc_locks, size - 1));
-      ut_ad(lock->type_mode == (LOCK_AUTO_INC | LOCK_TABLE));
-      lock_table_dequeue(lock, true);
-      lock_trx_table_locks_remove(lock);
-    }
+    lock_table_dequeue(lock, false);
+    lock_trx_table_locks_remove(lock);
+    trx->mutex_unlock();
+    table->lock_mutex_unlock();
   }
-  mysql_mutex_unlock(&lock_sys.wait_mutex);
-  trx->mutex_unlock();
+  lock_sys.rd_unlock();
 }
 
 /** Cancel a waiting lock request and release possibly waiting transactions */
@@ -895,8 +895,7 @@ void lock_sys_t::prdt_page_free_from_discard(const page_id_t id, bool all)
   const auto id_fold= id.fold();
   rd_lock(SRW_LOCK_CALL);
   auto cell= prdt_page_hash.cell_get(id_fold);
-  auto latch= hash_table::latch(cell);
-  latch->acquire();
+  prdt_page_hash.acquire(cell);
 
   for (lock_t *lock= get_first(*cell, id), *next; lock; lock= next)
   {
@@ -906,10 +905,9 @@ void lock_sys_t::prdt_page_free_from_discard(const page_id_t id, bool all)
 
   if (all)
   {
-    latch->release();
+    prdt_page_hash.release(cell);
     cell= prdt_hash.cell_get(id_fold);
-    latch= hash_table::latch(cell);
-    latch->acquire();
+    prdt_hash.acquire(cell);
     for (lock_t *lock= get_first(*cell, id), *next; lock; lock= next)
     {
       next= lock_rec_get_next_on_page(lock);
@@ -917,10 +915,9 @@ void lock_sys_t::prdt_page_free_from_discard(const page_id_t id, bool all)
     }
   }
 
-  latch->release();
+  hash_table::release(cell);
   cell= rec_hash.cell_get(id_fold);
-  latch= hash_table::latch(cell);
-  latch->acquire();
+  rec_hash.acquire(cell);
 
   for (lock_t *lock= get_first(*cell, id), *next; lock; lock= next)
   {
@@ -928,7 +925,7 @@ void lock_sys_t::prdt_page_free_from_discard(const page_id_t id, bool all)
     lock_rec_discard(rec_hash, lock);
   }
 
-  latch->release();
+  rec_hash.release(cell);
   /* Must be last, to avoid a race with lock_sys_t::hash_table::resize() */
   rd_unlock();
 }
@@ -0,0 +1,309 @@
+/*****************************************************************************
+
+Copyright (c) 2026, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file log/log0arch.cc
+Redo log archiving (innodb_log_archive_dir)
+*******************************************************/
+
+#include "log0arch.h"
+#include "buf0buf.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "os0file.h"
+
+#ifdef HAVE_COPY_FILE_RANGE
+# include <unistd.h>
+#endif
+
+/** innodb_log_archive_dir: where to archive the redo log, or NULL */
+char *srv_log_archive_dir;
+
+/** End of the archived log, or LSN_MAX if the log is not being archived */
+Atomic_relaxed<lsn_t> log_archived_lsn{LSN_MAX};
+
+/** Innodb_log_archive_stopped: whether archiving stopped after an error */
+bool log_archive_stopped;
+
+/** State of the redo log archive. Except for target_lsn, this is only
+accessed by log_archive_task, which does not run concurrently with itself
+(see log_archive_group). */
+static struct
+{
+  /** the redo log file, opened for reading */
+  pfs_os_file_t log_file= OS_FILE_CLOSED;
+  /** name of the redo log file */
+  std::string log_path;
+  /** the current archive file */
+  pfs_os_file_t file= OS_FILE_CLOSED;
+  /** name of the current archive file */
+  std::string path;
+  /** first LSN of the current archive file */
+  lsn_t start_lsn;
+  /** the log is to be archived up to this LSN; protected by log_sys.mutex */
+  lsn_t target_lsn;
+} log_archive_sys;
+
+/** Open a new archive file.
+@param lsn  the first LSN to be archived in it
+@return whether the file was opened */
+static bool log_archive_open(lsn_t lsn)
+{
+  ut_ad(!(lsn & (OS_FILE_LOG_BLOCK_SIZE - 1)));
+
+  char name[sizeof LOG_ARCHIVE_PREFIX + 20];
+  snprintf(name, sizeof name, "%s%020llu", LOG_ARCHIVE_PREFIX,
+           static_cast<unsigned long long>(lsn));
+  log_archive_sys.path.assign(srv_log_archive_dir).append("/").append(name);
+
+  bool success;
+  log_archive_sys.file=
+    os_file_create(innodb_log_file_key, log_archive_sys.path.c_str(),
+                   OS_FILE_OVERWRITE | OS_FILE_ON_ERROR_NO_EXIT,
+                   OS_FILE_NORMAL, OS_DATA_FILE_NO_O_DIRECT, false, &success);
+  if (!success)
+  {
+    log_archive_sys.file= OS_FILE_CLOSED;
+    ib::error() << "Cannot create the redo log archive file "
+                << log_archive_sys.path;
+    return false;
+  }
+
+  log_archive_sys.start_lsn= lsn;
+  return true;
+}
+
+/** Copy a contiguous part of ib_logfile0 to the current archive file.
+@param offset  byte offset in ib_logfile0
+@param dest    byte offset in the archive file
+@param len     number of bytes to copy
+@return whether the copying succeeded */
+static bool log_archive_copy(os_offset_t offset, os_offset_t dest, size_t len)
+{
+#ifdef HAVE_COPY_FILE_RANGE
+  /* Let the kernel copy the data, possibly without it ever being
+  transferred to user space or (on some file systems) duplicated. */
+  loff_t off_in= loff_t(offset), off_out= loff_t(dest);
+  while (len)
+  {
+    ssize_t n= copy_file_range(log_archive_sys.log_file, &off_in,
+                               log_archive_sys.file, &off_out, len, 0);
+    if (n <= 0)
+    {
+      if (n < 0 && (errno == EINTR || errno == EAGAIN))
+        continue;
+      if (n < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                    errno == EOPNOTSUPP))
+        /* Fall back to reading and writing */
+        break;
+      return false;
+    }
+    len-= size_t(n);
+  }
+  if (!len)
+    return true;
+  offset= os_offset_t(off_in);
+  dest= os_offset_t(off_out);
+#endif
+
+  constexpr size_t buf_size= 1U << 20;
+  byte *buf= static_cast<byte*>(aligned_malloc(buf_size, 4096));
+  bool ok= true;
+
+  while (len)
+  {
+    const size_t n= std::min(len, buf_size);
+    if (os_file_read(IORequestRead, log_archive_sys.log_file, buf, offset, n)
+        != DB_SUCCESS ||
+        os_file_write(IORequestWrite, log_archive_sys.path.c_str(),
+                      log_archive_sys.file, buf, dest, n) != DB_SUCCESS)
+    {
+      ok= false;
+      break;
+    }
+    offset+= n;
+    dest+= n;
+    len-= n;
+  }
+
+  aligned_free(buf);
+  return ok;
+}
+
+/** Copy a part of the redo log to the archive.
+@param start_lsn  the first LSN to be archived
+@param end_lsn    the end of the log to be archived
+@param offset     byte offset of start_lsn in the redo log file
+@param file_size  size of the redo log file
+@return whether the copying succeeded */
+static bool log_archive_write(lsn_t start_lsn, lsn_t end_lsn,
+                              os_offset_t offset, os_offset_t file_size)
+{
+  if (log_archive_sys.log_file == OS_FILE_CLOSED)
+  {
+    bool ok;
+    log_archive_sys.log_file=
+      os_file_create(innodb_log_file_key, log_archive_sys.log_path.c_str(),
+                     OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT,
+                     OS_FILE_NORMAL, OS_DATA_FILE_NO_O_DIRECT, true, &ok);
+    if (!ok)
+    {
+      log_archive_sys.log_file= OS_FILE_CLOSED;
+      ib::error() << "Cannot open " << log_archive_sys.log_path
+                  << " for archiving";
+      return false;
+    }
+  }
+
+  /* Start a new archive file at startup, or once the current file
+  has grown to the size of ib_logfile0. */
+  if (log_archive_sys.file != OS_FILE_CLOSED &&
+      start_lsn - log_archive_sys.start_lsn >= file_size)
+  {
+    os_file_close(log_archive_sys.file);
+    log_archive_sys.file= OS_FILE_CLOSED;
+  }
+
+  if (log_archive_sys.file == OS_FILE_CLOSED && !log_archive_open(start_lsn))
+    return false;
+
+  DBUG_EXECUTE_IF("log_archive_fail", return false;);
+
+  const os_offset_t dest= start_lsn - log_archive_sys.start_lsn;
+  /* The log file is circular after its header. */
+  const size_t len= size_t(end_lsn - start_lsn);
+  const size_t first= size_t(std::min<lsn_t>(len, file_size - offset));
+  return log_archive_copy(offset, dest, first) &&
+    (first == len ||
+     log_archive_copy(LOG_FILE_HDR_SIZE, dest + first, len - first)) &&
+    os_file_flush(log_archive_sys.file);
+}
+
+/** Close the archive file and the redo log file. */
+static void log_archive_close_files()
+{
+  if (log_archive_sys.file != OS_FILE_CLOSED)
+  {
+    os_file_close(log_archive_sys.file);
+    log_archive_sys.file= OS_FILE_CLOSED;
+  }
+  if (log_archive_sys.log_file != OS_FILE_CLOSED)
+  {
+    os_file_close(log_archive_sys.log_file);
+    log_archive_sys.log_file= OS_FILE_CLOSED;
+  }
+}
+
+/** Copy the redo log to the archive, up to log_archive_sys.target_lsn. */
+static void log_archive_func(void*)
+{
+  mysql_mutex_lock(&log_sys.mutex);
+
+  while (!log_archive_stopped)
+  {
+    const lsn_t start_lsn= log_archived_lsn;
+    const lsn_t end_lsn= log_archive_sys.target_lsn;
+    if (start_lsn >= end_lsn)
+      break;
+
+    ut_ad(end_lsn - start_lsn <= log_sys.log.capacity());
+    const os_offset_t offset= log_sys.log.calc_lsn_offset(start_lsn);
+    const os_offset_t file_size= log_sys.log.file_size;
+    /* At startup, the log may be written to ib_logfile101
+    before it is renamed to ib_logfile0. */
+    const std::string &log_path= log_sys.log.get_path();
+
+    if (log_archive_sys.log_path != log_path)
+    {
+      if (log_archive_sys.log_file != OS_FILE_CLOSED)
+      {
+        os_file_close(log_archive_sys.log_file);
+        log_archive_sys.log_file= OS_FILE_CLOSED;
+      }
+      log_archive_sys.log_path= log_path;
+    }
+
+    mysql_mutex_unlock(&log_sys.mutex);
+    const bool ok= log_archive_write(start_lsn, end_lsn, offset, file_size);
+    mysql_mutex_lock(&log_sys.mutex);
+
+    if (ok)
+      log_archived_lsn= end_lsn;
+    else
+    {
+      /* Do not leave a gap in the archive. Stop archiving, so that
+      the log will no longer be retained for it. */
+      ib::error() << "Failed to archive the redo log from LSN " << start_lsn
+                  << " to " << end_lsn << "; redo log archiving stopped";
+      log_archive_stopped= true;
+      log_archived_lsn= LSN_MAX;
+      log_archive_close_files();
+    }
+  }
+
+  mysql_mutex_unlock(&log_sys.mutex);
+}
+
+/** Execute log_archive_task one at a time */
+static tpool::task_group log_archive_group(1);
+/** The task that copies the redo log to the archive */
+static tpool::waitable_task log_archive_task(log_archive_func, nullptr,
+                                             &log_archive_group);
+
+/** Request the redo log up to a checkpoint to be archived, before it
+can be overwritten. The copying is done by a background task.
+@param checkpoint_lsn  the new checkpoint LSN; must be durably written */
+void log_archive(lsn_t checkpoint_lsn)
+{
+  mysql_mutex_assert_owner(&log_sys.mutex);
+  ut_ad(checkpoint_lsn <= log_sys.get_flushed_lsn());
+
+  if (!srv_log_archive_dir || log_archive_stopped || srv_read_only_mode ||
+      srv_operation != SRV_OPERATION_NORMAL || !log_sys.is_physical())
+    return;
+
+  if (log_archived_lsn == LSN_MAX)
+    /* The log since the previous checkpoint is still available. */
+    log_archived_lsn= ut_uint64_align_down(log_sys.last_checkpoint_lsn,
+                                           OS_FILE_LOG_BLOCK_SIZE);
+
+  /* Only archive complete blocks. The block that contains
+  checkpoint_lsn will be archived at a subsequent checkpoint. */
+  const lsn_t end_lsn= ut_uint64_align_down(checkpoint_lsn,
+                                            OS_FILE_LOG_BLOCK_SIZE);
+  if (end_lsn <= log_archive_sys.target_lsn)
+    return;
+
+  log_archive_sys.target_lsn= end_lsn;
+  srv_thread_pool->submit_task(&log_archive_task);
+}
+
+/** Wait for the pending archiving to finish. */
+void log_archive_wait()
+{
+  log_archive_task.wait();
+}
+
+/** Finish the archiving and close the archive file. */
+void log_archive_close()
+{
+  log_archive_wait();
+  log_archived_lsn= LSN_MAX;
+  log_archive_sys.target_lsn= 0;
+  log_archive_close_files();
+}
@@ -36,6 +36,7 @@ Created 12/9/1995 Heikki Tuuri
 #include <my_service_manager.h>
 
 #include "log0log.h"
+#include "log0arch.h"
 #include "log0crypt.h"
 #include "buf0buf.h"
 #include "buf0flu.h"
@@ -83,11 +84,13 @@ void log_buffer_extend(ulong len)
 		(ut_malloc_dontdump(new_buf_size, PSI_INSTRUMENT_ME));
 	TRASH_ALLOC(new_flush_buf, new_buf_size);
 
+	log_sys.latch.wr_lock();
 	mysql_mutex_lock(&log_sys.mutex);
 
 	if (len <= srv_log_buffer_size) {
 		/* Already extended enough by the others */
 		mysql_mutex_unlock(&log_sys.mutex);
+		log_sys.latch.wr_unlock();
 		ut_free_dodump(new_buf, new_buf_size);
 		ut_free_dodump(new_flush_buf, new_buf_size);
 		return;
@@ -97,19 +100,34 @@ void log_buffer_extend(ulong len)
 		" exceeds innodb_log_buffer_size="
 		<< srv_log_buffer_size << " / 2). Trying to extend it.";
 
+	/* Holding log_sys.latch prevents new reservations; wait for
+	the already reserved log records to be copied to log_sys.buf. */
+	const lsn_t end_lsn = log_sys.get_lsn();
+	log_sys.wait_copied(end_lsn);
+
 	byte* old_buf = log_sys.buf;
 	byte* old_flush_buf = log_sys.flush_buf;
 	const ulong old_buf_size = srv_log_buffer_size;
 	srv_log_buffer_size = static_cast<ulong>(new_buf_size);
 	log_sys.buf = new_buf;
 	log_sys.flush_buf = new_flush_buf;
-	memcpy_aligned<OS_FILE_LOG_BLOCK_SIZE>(new_buf, old_buf,
-					       log_sys.buf_free);
+
+	/* Move the unwritten log blocks to their positions in the
+	larger ring buffer. */
+	for (lsn_t lsn = log_sys.buf_start_lsn.load(std::memory_order_relaxed);
+	     lsn < end_lsn;
+	     lsn += OS_FILE_LOG_BLOCK_SIZE) {
+		memcpy_aligned<OS_FILE_LOG_BLOCK_SIZE>(
+			log_sys.buf_block(lsn),
+			old_buf + size_t(lsn % old_buf_size),
+			OS_FILE_LOG_BLOCK_SIZE);
+	}
 
 	log_sys.max_buf_free = new_buf_size / LOG_BUF_FLUSH_RATIO
 		- LOG_BUF_FLUSH_MARGIN;
 
 	mysql_mutex_unlock(&log_sys.mutex);
+	log_sys.latch.wr_unlock();
 
 	ut_free_dodump(old_buf, old_buf_size);
 	ut_free_dodump(old_flush_buf, old_buf_size);
@@ -168,6 +186,67 @@ log_set_capacity(ulonglong file_size)
 	return(true);
 }
 
+/** Acquire a copy slot before advancing lsn.
+@param start  a lower bound of the start LSN of the log records
+@return the copy slot */
+size_t log_t::copy_start(lsn_t start)
+{
+  ut_ad(start);
+  for (size_t i= std::hash<std::thread::id>()(std::this_thread::get_id());;)
+  {
+    for (size_t n= N_COPY_SLOTS; n--; i++)
+    {
+      const size_t slot= i % N_COPY_SLOTS;
+      lsn_t unused= 0;
+      if (copy_slots[slot].start.compare_exchange_strong(unused, start))
+        return slot;
+    }
+    std::this_thread::yield();
+  }
+}
+
+/** Note that the log records were copied to the reserved space in buf.
+@param slot  the copy slot that copy_start() returned */
+void log_t::copy_end(size_t slot)
+{
+  ut_ad(copy_slots[slot].start.load(std::memory_order_relaxed));
+  copy_slots[slot].start.store(0);
+  if (copy_waiters.load())
+  {
+    std::lock_guard<std::mutex> g(copy_mutex);
+    copy_cond.notify_all();
+  }
+}
+
+/** @return the end of the completely copied prefix of buf */
+lsn_t log_t::get_copied_lsn() const
+{
+  /* A copy slot is assigned before lsn is advanced, so any range that
+  was reserved below the lsn that we read here is visible in the
+  copy slots, unless its copying was completed. */
+  lsn_t copied= get_lsn(std::memory_order_seq_cst);
+  for (const copy_slot &c : copy_slots)
+  {
+    const lsn_t start= c.start.load();
+    if (start && start < copied)
+      copied= start;
+  }
+  return copied;
+}
+
+/** Wait until buf has been copied to up to an LSN.
+@param lsn  an LSN that is at most get_lsn() */
+void log_t::wait_copied(lsn_t lsn)
+{
+  ut_ad(lsn <= get_lsn());
+  if (get_copied_lsn() >= lsn)
+    return;
+  std::unique_lock<std::mutex> lk(copy_mutex);
+  copy_waiters.fetch_add(1);
+  copy_cond.wait(lk, [this, lsn]{ return get_copied_lsn() >= lsn; });
+  copy_waiters.fetch_sub(1);
+}
+
 /** Initialize the redo log subsystem. */
 void log_t::create()
 {
@@ -175,8 +254,12 @@ void log_t::create()
   ut_ad(!is_initialised());
   m_initialised= true;
 
+  latch.init();
   mysql_mutex_init(log_sys_mutex_key, &mutex, nullptr);
   mysql_mutex_init(log_flush_order_mutex_key, &flush_order_mutex, nullptr);
+  for (copy_slot &c : copy_slots)
+    c.start= 0;
+  copy_waiters= 0;
 
   /* Start the lsn from one log block from zero: this way every
   log record has a non-zero start lsn, a fact which we will use */
@@ -201,7 +284,7 @@ void log_t::create()
   n_log_ios_old= n_log_ios;
   last_printout_time= time(NULL);
 
-  buf_next_to_write= 0;
+  buf_start_lsn.store(LOG_START_LSN, std::memory_order_relaxed);
   last_checkpoint_lsn= write_lsn= LOG_START_LSN;
   n_log_ios= 0;
   n_log_ios_old= 0;
@@ -212,10 +295,8 @@ void log_t::create()
   next_checkpoint_lsn= 0;
   n_pending_checkpoint_writes= 0;
 
-  log_block_init(buf, LOG_START_LSN);
-  log_block_set_first_rec_group(buf, LOG_BLOCK_HDR_SIZE);
-
-  buf_free= LOG_BLOCK_HDR_SIZE;
+  log_block_init(buf_block(LOG_START_LSN), LOG_START_LSN);
+  log_block_set_first_rec_group(buf_block(LOG_START_LSN), LOG_BLOCK_HDR_SIZE);
 }
 
 mapped_file_t::~mapped_file_t() noexcept
@@ -629,31 +710,6 @@ static void log_write_flush_to_disk_low(lsn_t lsn)
   log_sys.set_flushed_lsn(lsn);
 }
 
-/** Swap log buffers, and copy the content of last block
-from old buf to the head of the new buf. Thus, buf_free and
-buf_next_to_write would be changed accordingly */
-static inline
-void
-log_buffer_switch()
-{
-	mysql_mutex_assert_owner(&log_sys.mutex);
-	ut_ad(log_write_lock_own());
-
-	size_t		area_end = ut_calc_align<size_t>(
-		log_sys.buf_free, OS_FILE_LOG_BLOCK_SIZE);
-
-	/* Copy the last block to new buf */
-	memcpy_aligned<OS_FILE_LOG_BLOCK_SIZE>(
-		log_sys.flush_buf,
-		log_sys.buf + area_end - OS_FILE_LOG_BLOCK_SIZE,
-		OS_FILE_LOG_BLOCK_SIZE);
-
-	std::swap(log_sys.buf, log_sys.flush_buf);
-
-	log_sys.buf_free %= OS_FILE_LOG_BLOCK_SIZE;
-	log_sys.buf_next_to_write = log_sys.buf_free;
-}
-
 /** Invoke commit_checkpoint_notify_ha() to notify that outstanding
 log writes have been completed. */
 void log_flush_notify(lsn_t flush_lsn);
@@ -667,13 +723,17 @@ This function does not flush anything.
 Note : the caller must have log_sys.mutex locked, and this
 mutex is released in the function.
 
-*/
-static void log_write(bool rotate_key)
+@param write_lsn   end of the log to write; log_sys.buf must have been
+copied to up to this, @see log_t::wait_copied()
+@param rotate_key  whether to rotate the encryption key */
+static void log_write(lsn_t write_lsn, bool rotate_key)
 {
 	mysql_mutex_assert_owner(&log_sys.mutex);
 	ut_ad(!recv_no_log_write);
-	lsn_t write_lsn;
-	if (log_sys.buf_free == log_sys.buf_next_to_write) {
+	ut_ad(write_lsn >= log_sys.write_lsn);
+	ut_ad(write_lsn <= log_sys.get_lsn());
+
+	if (write_lsn == log_sys.write_lsn) {
 		/* Nothing to write */
 		mysql_mutex_unlock(&log_sys.mutex);
 		return;
@@ -681,35 +741,53 @@ static void log_write(bool rotate_key)
 
 	ulint		start_offset;
 	ulint		end_offset;
-	ulint		area_start;
 	ulint		area_end;
 	ulong		write_ahead_size = srv_log_write_ahead_size;
 	ulint		pad_size;
 
 	DBUG_PRINT("ib_log", ("write " LSN_PF " to " LSN_PF,
-			      log_sys.write_lsn,
-			      log_sys.get_lsn()));
-
-
-	start_offset = log_sys.buf_next_to_write;
-	end_offset = log_sys.buf_free;
-
-	area_start = ut_2pow_round(start_offset,
-				   ulint(OS_FILE_LOG_BLOCK_SIZE));
+			      log_sys.write_lsn, write_lsn));
+
+	const lsn_t	area_start_lsn = log_sys.buf_start_lsn.load(
+		std::memory_order_relaxed);
+	ut_ad(area_start_lsn == ut_uint64_align_down(log_sys.write_lsn,
+						     OS_FILE_LOG_BLOCK_SIZE));
+	start_offset = ulint(log_sys.write_lsn - area_start_lsn);
+	end_offset = ulint(write_lsn - area_start_lsn);
 	area_end = ut_calc_align(end_offset, ulint(OS_FILE_LOG_BLOCK_SIZE));
 
-	ut_ad(area_end - area_start > 0);
-
-	log_block_set_flush_bit(log_sys.buf + area_start, TRUE);
-	log_block_set_checkpoint_no(
-		log_sys.buf + area_end - OS_FILE_LOG_BLOCK_SIZE,
-		log_sys.next_checkpoint_no);
-
-	write_lsn = log_sys.get_lsn();
-	byte *write_buf = log_sys.buf;
+	ut_ad(area_end > 0);
+	ut_ad(area_end <= srv_log_buffer_size);
+
+	/* Copy the log from the ring buffer. Anything after write_lsn
+	may still be being copied to by mtr_t::commit(). */
+	byte *write_buf = log_sys.flush_buf;
+	const size_t buf_offset = size_t(area_start_lsn % srv_log_buffer_size);
+	const size_t first_len = std::min<size_t>(
+		end_offset, srv_log_buffer_size - buf_offset);
+	memcpy(write_buf, log_sys.buf + buf_offset, first_len);
+	memcpy(write_buf + first_len, log_sys.buf, end_offset - first_len);
+
+	/* Fill in the log block headers; mtr_t::commit() only wrote
+	LOG_BLOCK_FIRST_REC_GROUP */
+	for (ulint i = 0; i < area_end; i += OS_FILE_LOG_BLOCK_SIZE) {
+		byte* log_block = write_buf + i;
+		log_block_set_hdr_no(log_block, log_block_convert_lsn_to_no(
+					     area_start_lsn + i));
+		log_block_set_data_len(
+			log_block,
+			end_offset - i >= OS_FILE_LOG_BLOCK_SIZE
+			? OS_FILE_LOG_BLOCK_SIZE : end_offset - i);
+		log_block_set_checkpoint_no(log_block,
+					    log_sys.next_checkpoint_no);
+	}
 
-	log_buffer_switch();
+	log_block_set_flush_bit(write_buf, TRUE);
 
+	/* Let mtr_t::commit() reuse the space that was copied from */
+	log_sys.buf_start_lsn.store(ut_uint64_align_down(
+					    write_lsn, OS_FILE_LOG_BLOCK_SIZE),
+				    std::memory_order_release);
 	log_sys.log.set_fields(log_sys.write_lsn);
 
 	mysql_mutex_unlock(&log_sys.mutex);
@@ -726,7 +804,7 @@ static void log_write(bool rotate_key)
 		end_offset_in_unit = (ulint) (end_offset % write_ahead_size);
 
 		if (end_offset_in_unit > 0
-		    && (area_end - area_start) > end_offset_in_unit) {
+		    && area_end > end_offset_in_unit) {
 			/* The first block in the unit was initialized
 			after the last writing.
 			Needs to be written padded data once. */
@@ -744,20 +822,17 @@ static void log_write(bool rotate_key)
 	}
 
 	if (log_sys.is_encrypted()) {
-		log_crypt(write_buf + area_start, log_sys.write_lsn,
-			  area_end - area_start,
+		log_crypt(write_buf, log_sys.write_lsn, area_end,
 			  rotate_key ? LOG_ENCRYPT_ROTATE_KEY : LOG_ENCRYPT);
 	}
 
 	/* Do the write to the log file */
 	log_write_buf(
-		write_buf + area_start, area_end - area_start + pad_size,
+		write_buf, area_end + pad_size,
 #ifdef UNIV_DEBUG
 		pad_size,
 #endif /* UNIV_DEBUG */
-		ut_uint64_align_down(log_sys.write_lsn,
-				     OS_FILE_LOG_BLOCK_SIZE),
-		start_offset - area_start);
+		area_start_lsn, start_offset);
 	srv_stats.log_padded.add(pad_size);
 	log_sys.write_lsn = write_lsn;
 	if (log_sys.log.writes_are_durable()) {
@@ -800,6 +875,8 @@ void log_write_up_to(lsn_t lsn, bool flush_to_disk, bool rotate_key,
     return;
   }
 
+  DEBUG_SYNC_C("log_write_up_to");
+
   if (flush_to_disk &&
     flush_lock.acquire(lsn, callback) != group_commit_lock::ACQUIRED)
   {
@@ -809,11 +886,18 @@ void log_write_up_to(lsn_t lsn, bool flush_to_disk, bool rotate_key,
   if (write_lock.acquire(lsn, flush_to_disk?0:callback) ==
       group_commit_lock::ACQUIRED)
   {
+    /* Wait for mtr_t::commit() to copy the requested log records to
+    log_sys.buf, and write everything that has been copied by then.
+    Any ranges that were reserved later are left for the next write,
+    so that no write covers a range that is still being copied. */
+    log_sys.wait_copied(std::min(lsn, log_sys.get_lsn()));
     mysql_mutex_lock(&log_sys.mutex);
-    lsn_t write_lsn= log_sys.get_lsn();
+    /* A copy slot may briefly hold a stale lower bound from before
+    log_sys.write_lsn; the log up to that has been written already. */
+    lsn_t write_lsn= std::max(log_sys.get_copied_lsn(), log_sys.write_lsn);
     write_lock.set_pending(write_lsn);
 
-    log_write(rotate_key);
+    log_write(write_lsn, rotate_key);
 
     ut_a(log_sys.write_lsn == write_lsn);
     write_lock.release(write_lsn);
@@ -852,7 +936,9 @@ ATTRIBUTE_COLD static void log_flush_margin()
 
 	mysql_mutex_lock(&log_sys.mutex);
 
-	if (log_sys.buf_free > log_sys.max_buf_free) {
+	if (log_sys.get_lsn()
+	    - log_sys.buf_start_lsn.load(std::memory_order_relaxed)
+	    > log_sys.max_buf_free) {
 		/* We can write during flush */
 		lsn = log_sys.get_lsn();
 	}
@@ -903,6 +989,10 @@ ATTRIBUTE_COLD void log_write_checkpoint_info(lsn_t end_lsn)
 
 	++log_sys.n_pending_checkpoint_writes;
 
+	/* Request the log that the checkpoint would allow to overwrite
+	to be archived. */
+	log_archive(log_sys.next_checkpoint_lsn);
+
 	mysql_mutex_unlock(&log_sys.mutex);
 
 	/* Note: We alternate the physical place of the checkpoint info.
@@ -956,8 +1046,9 @@ ATTRIBUTE_COLD static void log_checkpoint_margin()
 
     const lsn_t lsn= log_sys.get_lsn();
     const lsn_t checkpoint= log_sys.last_checkpoint_lsn;
+    const lsn_t limit= log_archive_checkpoint_lsn();
     const lsn_t sync_lsn= checkpoint + log_sys.max_checkpoint_age;
-    if (lsn <= sync_lsn)
+    if (lsn <= limit + log_sys.max_checkpoint_age)
     {
       log_sys.set_check_flush_or_checkpoint(false);
       goto func_exit;
@@ -966,7 +1057,11 @@ ATTRIBUTE_COLD static void log_checkpoint_margin()
     mysql_mutex_unlock(&log_sys.mutex);
 
     /* We must wait to prevent the tail of the log overwriting the head. */
-    buf_flush_wait_flushed(std::min(sync_lsn, checkpoint + (1U << 20)));
+    if (limit < ut_uint64_align_down(checkpoint, OS_FILE_LOG_BLOCK_SIZE))
+      /* The log since limit has not been archived yet. */
+      log_archive_wait();
+    else
+      buf_flush_wait_flushed(std::min(sync_lsn, checkpoint + (1U << 20)));
     /* Sleep to avoid a thundering herd */
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
   }
@@ -1196,6 +1291,8 @@ ATTRIBUTE_COLD void logs_empty_and_mark_files_at_shutdown()
 	srv_shutdown_lsn = lsn;
 
 	if (!srv_read_only_mode) {
+		buf_dump_pages(lsn);
+
 		dberr_t err = fil_write_flushed_lsn(lsn);
 
 		if (err != DB_SUCCESS) {
@@ -1280,6 +1377,7 @@ void log_t::close()
   ut_ad(this == &log_sys);
   if (!is_initialised()) return;
   m_initialised = false;
+  log_archive_close();
   log.close();
 
   ut_free_dodump(buf, srv_log_buffer_size);
@@ -1289,6 +1387,7 @@ void log_t::close()
 
   mysql_mutex_destroy(&mutex);
   mysql_mutex_destroy(&flush_order_mutex);
+  latch.destroy();
 
   recv_sys.close();
 }
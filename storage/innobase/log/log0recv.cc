@@ -3702,8 +3702,17 @@ recv_recovery_from_checkpoint_start(lsn_t flush_lsn)
 	      || checkpoint_lsn == recv_sys.recovered_lsn);
 
 	log_sys.write_lsn = log_sys.get_lsn();
-	log_sys.buf_free = log_sys.write_lsn % OS_FILE_LOG_BLOCK_SIZE;
-	log_sys.buf_next_to_write = log_sys.buf_free;
+	log_sys.buf_start_lsn.store(ut_uint64_align_down(
+					    log_sys.write_lsn,
+					    OS_FILE_LOG_BLOCK_SIZE),
+				    std::memory_order_relaxed);
+	/* recv_synchronize_groups() read the last log block to the start
+	of log_sys.buf; move it to its position in the ring buffer. */
+	byte* last_block = log_sys.buf_block(log_sys.write_lsn);
+	if (last_block != log_sys.buf) {
+		memcpy_aligned<OS_FILE_LOG_BLOCK_SIZE>(
+			last_block, log_sys.buf, OS_FILE_LOG_BLOCK_SIZE);
+	}
 
 	log_sys.last_checkpoint_lsn = checkpoint_lsn;
 
@@ -3790,7 +3799,8 @@ bool recv_dblwr_t::validate_page(const page_id_t page_id,
   case FIL_PAGE_PAGE_COMPRESSED_ENCRYPTED:
     if (space->zip_size())
       return false; /* ROW_FORMAT=COMPRESSED cannot be page_compressed */
-    ulint decomp= fil_page_decompress(tmp_frame, tmp_page, space->flags);
+    ulint decomp= fil_page_decompress(tmp_frame, tmp_page, space->flags,
+                                      space->zstd_dict);
     if (!decomp)
       return false; /* decompression failed */
     if (decomp == srv_page_size)
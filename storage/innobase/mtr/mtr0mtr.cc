@@ -32,6 +32,7 @@ Created 11/26/1995 Heikki Tuuri
 #include "page0types.h"
 #include "mtr0log.h"
 #include "log0recv.h"
+#include "log0arch.h"
 #ifdef BTR_CUR_HASH_ADAPT
 # include "btr0sea.h"
 #endif
@@ -406,19 +407,24 @@ void mtr_t::commit()
 
     std::pair<lsn_t,bool> lsns;
 
-    if (const ulint len= prepare_write())
+    const ulint len= prepare_write();
+
+    if (len)
+    {
       lsns= finish_write(len);
+      log_sys.latch.rd_unlock();
+    }
     else
+    {
+      if (m_made_dirty)
+        mysql_mutex_lock(&log_sys.flush_order_mutex);
+      m_commit_lsn= log_sys.get_lsn();
       lsns= { m_commit_lsn, false };
+    }
 
-    if (m_made_dirty)
-      mysql_mutex_lock(&log_sys.flush_order_mutex);
-
-    /* It is now safe to release the log mutex because the
-    flush_order mutex will ensure that we are the first one
-    to insert into the flush list. */
-    mysql_mutex_unlock(&log_sys.mutex);
-
+    /* The flush_order mutex, which was acquired before lsn was
+    advanced, ensures that we are the first one to insert into
+    the flush list. */
     if (m_freed_pages)
     {
       ut_ad(!m_freed_pages->empty());
@@ -447,6 +453,15 @@ void mtr_t::commit()
     if (m_made_dirty)
       mysql_mutex_unlock(&log_sys.flush_order_mutex);
 
+    /* The space for our log records was reserved in finish_write().
+    Copy them before releasing the page latches. log_write() will not
+    write anything past the start of our range before we are done. */
+    if (len)
+    {
+      DEBUG_SYNC_C("mtr_copy_log");
+      copy_log();
+    }
+
     m_memo.for_each_block_in_reverse(CIterate<ReleaseLatches>());
 
     if (lsns.second)
@@ -464,7 +479,8 @@ void mtr_t::commit()
 /** Commit a mini-transaction that did not modify any pages,
 but generated some redo log on a higher level, such as
 FILE_MODIFY records and an optional FILE_CHECKPOINT marker.
-The caller must hold log_sys.mutex.
+The caller must hold log_sys.mutex, and log_sys.latch in shared
+or exclusive mode.
 This is to be used at log_checkpoint().
 @param[in]	checkpoint_lsn		log checkpoint LSN, or 0 */
 void mtr_t::commit_files(lsn_t checkpoint_lsn)
@@ -490,14 +506,15 @@ void mtr_t::commit_files(lsn_t checkpoint_lsn)
 		*m_log.push<byte*>(1) = 0;
 	}
 
-	finish_write(m_log.size());
+	finish_write(m_log.size(), true);
+	copy_log();
 	srv_stats.log_write_requests.inc();
 	release_resources();
 
 	if (checkpoint_lsn) {
 		DBUG_PRINT("ib_log",
 			   ("FILE_CHECKPOINT(" LSN_PF ") written at " LSN_PF,
-			    checkpoint_lsn, log_sys.get_lsn()));
+			    checkpoint_lsn, m_commit_lsn));
 	}
 }
 
@@ -643,8 +660,10 @@ static void log_margin_checkpoint_age(ulint len)
   /* actual length stored per block */
   const ulint len_per_blk= OS_FILE_LOG_BLOCK_SIZE - framing_size;
 
+  const lsn_t lsn= log_sys.get_lsn();
+
   /* actual data length in last block already written */
-  ulint extra_len= log_sys.buf_free % OS_FILE_LOG_BLOCK_SIZE;
+  ulint extra_len= ulint(lsn % OS_FILE_LOG_BLOCK_SIZE);
 
   ut_ad(extra_len >= LOG_BLOCK_HDR_SIZE);
   extra_len-= LOG_BLOCK_HDR_SIZE;
@@ -654,10 +673,6 @@ static void log_margin_checkpoint_age(ulint len)
 
   const ulint margin= len + extra_len;
 
-  mysql_mutex_assert_owner(&log_sys.mutex);
-
-  const lsn_t lsn= log_sys.get_lsn();
-
   if (UNIV_UNLIKELY(margin > log_sys.log_capacity))
   {
     time_t t= time(nullptr);
@@ -672,7 +687,7 @@ static void log_margin_checkpoint_age(ulint len)
                      "for mini-transaction size " << len;
     }
   }
-  else if (UNIV_LIKELY(lsn + margin <= log_sys.last_checkpoint_lsn +
+  else if (UNIV_LIKELY(lsn + margin <= log_archive_checkpoint_lsn() +
                        log_sys.log_capacity))
     return;
 
@@ -680,25 +695,26 @@ static void log_margin_checkpoint_age(ulint len)
 }
 
 
-/** Open the log for log_write_low(). The log must be closed with log_close().
-@param len length of the data to be written
-@return start lsn of the log record */
-static lsn_t log_reserve_and_open(size_t len)
+/** Wait until the log buffer is likely to have space for log records.
+@param len          length of the data to be written
+@param mutex_owned  whether the caller holds log_sys.mutex */
+static void log_wait_for_space(size_t len, bool mutex_owned)
 {
   for (ut_d(ulint count= 0);;)
   {
-    mysql_mutex_assert_owner(&log_sys.mutex);
-
     /* Calculate an upper limit for the space the string may take in
     the log buffer */
 
     size_t len_upper_limit= (4 * OS_FILE_LOG_BLOCK_SIZE) +
       srv_log_write_ahead_size + (5 * len) / 4;
 
-    if (log_sys.buf_free + len_upper_limit <= srv_log_buffer_size)
+    if (log_sys.get_lsn() + len_upper_limit <=
+        log_sys.buf_start_lsn.load(std::memory_order_acquire) +
+        srv_log_buffer_size)
       break;
 
-    mysql_mutex_unlock(&log_sys.mutex);
+    if (mutex_owned)
+      mysql_mutex_unlock(&log_sys.mutex);
     DEBUG_SYNC_C("log_buf_size_exceeded");
 
     /* Not enough free space, do a write of the log buffer */
@@ -708,87 +724,99 @@ static lsn_t log_reserve_and_open(size_t len)
 
     ut_ad(++count < 50);
 
-    mysql_mutex_lock(&log_sys.mutex);
+    if (mutex_owned)
+      mysql_mutex_lock(&log_sys.mutex);
   }
-
-  return log_sys.get_lsn();
 }
 
-/** Append data to the log buffer. */
-static void log_write_low(const void *str, size_t size)
+/** Reserve space in the log buffer by advancing log_sys.lsn.
+The data must be copied by log_copy() before log_sys.copy_end().
+@param len          length of the data to be written
+@param flush_order  whether to acquire log_sys.flush_order_mutex
+@param mutex_owned  whether the caller holds log_sys.mutex
+@param slot         the copy slot for log_sys.copy_end()
+@return {start_lsn,end_lsn} of the data */
+static std::pair<lsn_t,lsn_t> log_reserve(size_t len, bool flush_order,
+                                          bool mutex_owned, size_t &slot)
 {
-  mysql_mutex_assert_owner(&log_sys.mutex);
-  const ulint trailer_offset= log_sys.trailer_offset();
-
-  do
+  for (;;)
   {
-    /* Calculate a part length */
-    size_t len= size;
-    size_t data_len= (log_sys.buf_free % OS_FILE_LOG_BLOCK_SIZE) + size;
+    log_wait_for_space(len, mutex_owned);
 
-    if (data_len > trailer_offset)
+    if (flush_order)
+      mysql_mutex_lock(&log_sys.flush_order_mutex);
+
+    lsn_t start= log_sys.get_lsn();
+    slot= log_sys.copy_start(start);
+
+    for (;;)
     {
-      data_len= trailer_offset;
-      len= trailer_offset - log_sys.buf_free % OS_FILE_LOG_BLOCK_SIZE;
+      const lsn_t end= log_sys.calc_end_lsn(start, len);
+      if (ut_uint64_align_up(end, OS_FILE_LOG_BLOCK_SIZE) >
+          log_sys.buf_start_lsn.load(std::memory_order_acquire) +
+          srv_log_buffer_size)
+        break;
+      /* The copy slot must cover start before lsn is advanced, so that
+      log_t::get_copied_lsn() will not return anything past start
+      until log_sys.copy_end() has been called. */
+      if (log_sys.advance_lsn(start, end))
+        return {start, end};
+      log_sys.copy_update(slot, start);
     }
 
-    memcpy(log_sys.buf + log_sys.buf_free, str, len);
+    /* Other threads filled up the log buffer meanwhile. */
+    log_sys.copy_end(slot);
+    if (flush_order)
+      mysql_mutex_unlock(&log_sys.flush_order_mutex);
+  }
+}
 
-    size-= len;
-    str= static_cast<const char*>(str) + len;
+/** Copy data to a log buffer range that was reserved by log_reserve(),
+skipping the log block framing.
+@param lsn   current position in the log
+@param str   data to copy
+@param size  length of the data
+@return the position after the data */
+static lsn_t log_copy(lsn_t lsn, const void *str, size_t size)
+{
+  const ulint trailer_offset= log_sys.trailer_offset();
 
-    byte *log_block= static_cast<byte*>(ut_align_down(log_sys.buf +
-                                                      log_sys.buf_free,
-                                                      OS_FILE_LOG_BLOCK_SIZE));
+  do
+  {
+    const size_t used= size_t(lsn % OS_FILE_LOG_BLOCK_SIZE);
+    ut_ad(used >= LOG_BLOCK_HDR_SIZE);
+    ut_ad(used < trailer_offset);
+    const size_t len= std::min(size, trailer_offset - used);
 
-    log_block_set_data_len(log_block, data_len);
-    lsn_t lsn= log_sys.get_lsn();
+    memcpy(log_sys.buf_block(lsn) + used, str, len);
+    lsn+= len;
+    size-= len;
+    str= static_cast<const char*>(str) + len;
 
-    if (data_len == trailer_offset)
+    if (used + len == trailer_offset)
     {
-      /* This block became full */
-      log_block_set_data_len(log_block, OS_FILE_LOG_BLOCK_SIZE);
-      log_block_set_checkpoint_no(log_block, log_sys.next_checkpoint_no);
-      len+= log_sys.framing_size();
-      lsn+= len;
-      /* Initialize the next block header */
-      log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE, lsn);
+      /* log_reserve() skipped the trailer and the next block header.
+      No log record group starts in the next block, unless it is the
+      last one, @see mtr_t::copy_log(). log_write() will fill in the
+      rest of the block header. */
+      lsn+= log_sys.framing_size();
+      log_block_set_first_rec_group(log_sys.buf_block(lsn), 0);
     }
-    else
-      lsn+= len;
-
-    log_sys.set_lsn(lsn);
-    log_sys.buf_free+= len;
-
-    ut_ad(log_sys.buf_free <= size_t{srv_log_buffer_size});
   }
   while (size);
+
+  return lsn;
 }
 
 /** Close the log at mini-transaction commit.
 @return whether buffer pool flushing is needed */
 static bool log_close(lsn_t lsn)
 {
-  mysql_mutex_assert_owner(&log_sys.mutex);
-  ut_ad(lsn == log_sys.get_lsn());
-
-  byte *log_block= static_cast<byte*>(ut_align_down(log_sys.buf +
-                                                    log_sys.buf_free,
-                                                    OS_FILE_LOG_BLOCK_SIZE));
-
-  if (!log_block_get_first_rec_group(log_block))
-  {
-    /* We initialized a new log block which was not written
-    full by the current mtr: the next mtr log record group
-    will start within this block at the offset data_len */
-    log_block_set_first_rec_group(log_block,
-                                  log_block_get_data_len(log_block));
-  }
-
-  if (log_sys.buf_free > log_sys.max_buf_free)
+  if (lsn - log_sys.buf_start_lsn.load(std::memory_order_relaxed) >
+      log_sys.max_buf_free)
     log_sys.set_check_flush_or_checkpoint();
 
-  const lsn_t checkpoint_age= lsn - log_sys.last_checkpoint_lsn;
+  const lsn_t checkpoint_age= lsn - log_archive_checkpoint_lsn();
 
   if (UNIV_UNLIKELY(checkpoint_age >= log_sys.log_capacity))
   {
@@ -810,19 +838,23 @@ static bool log_close(lsn_t lsn)
   return true;
 }
 
-/** Write the block contents to the REDO log */
-struct mtr_write_log
+/** Copy the block contents to the reserved space in the redo log buffer */
+struct mtr_copy_log
 {
-  /** Append a block to the redo log buffer.
-  @return whether the appending should continue */
-  bool operator()(const mtr_buf_t::block_t *block) const
+  /** current position in the log */
+  lsn_t lsn;
+
+  /** Copy a block to the redo log buffer.
+  @return whether the copying should continue */
+  bool operator()(const mtr_buf_t::block_t *block)
   {
-    log_write_low(block->begin(), block->used());
+    lsn= log_copy(lsn, block->begin(), block->used());
     return true;
   }
 };
 
 /** Prepare to write the mini-transaction log to the redo log buffer.
+If anything is to be written, log_sys.latch will be held in shared mode.
 @return number of bytes to write in finish_write() */
 inline ulint mtr_t::prepare_write()
 {
@@ -831,8 +863,6 @@ inline ulint mtr_t::prepare_write()
 	if (UNIV_UNLIKELY(m_log_mode != MTR_LOG_ALL)) {
 		ut_ad(m_log_mode == MTR_LOG_NO_REDO);
 		ut_ad(m_log.size() == 0);
-		mysql_mutex_lock(&log_sys.mutex);
-		m_commit_lsn = log_sys.get_lsn();
 		return 0;
 	}
 
@@ -850,7 +880,9 @@ inline ulint mtr_t::prepare_write()
 		space = NULL;
 	}
 
-	mysql_mutex_lock(&log_sys.mutex);
+	/* Block log_checkpoint() until lsn has been advanced and
+	space->max_lsn updated in finish_write(). */
+	log_sys.latch.rd_lock();
 
 	if (fil_names_write_if_was_clean(space)) {
 		len = m_log.size();
@@ -869,40 +901,54 @@ inline ulint mtr_t::prepare_write()
 	return(len);
 }
 
-/** Append the redo log records to the redo log buffer.
-@param len   number of bytes to write
+/** Reserve space for the redo log records in the redo log buffer.
+The records must be copied there by copy_log().
+If m_made_dirty, log_sys.flush_order_mutex will be acquired.
+@param len    number of bytes to write
+@param files  whether the caller holds log_sys.mutex (commit_files())
 @return {start_lsn,flush_ahead_lsn} */
-inline std::pair<lsn_t,bool> mtr_t::finish_write(ulint len)
+inline std::pair<lsn_t,bool> mtr_t::finish_write(ulint len, bool files)
 {
 	ut_ad(m_log_mode == MTR_LOG_ALL);
-	mysql_mutex_assert_owner(&log_sys.mutex);
 	ut_ad(m_log.size() == len);
 	ut_ad(len > 0);
+	ut_ad(!files || !m_made_dirty);
 
-	lsn_t start_lsn;
-
-	if (m_log.is_small()) {
-		const mtr_buf_t::block_t* front = m_log.front();
-		ut_ad(len <= front->used());
+	const std::pair<lsn_t,lsn_t> lsns = log_reserve(
+		len, m_made_dirty, files, m_copy_slot);
+	m_copy_lsn = lsns.first;
+	m_commit_lsn = lsns.second;
 
-		m_commit_lsn = log_reserve_and_write_fast(front->begin(), len,
-							  &start_lsn);
-
-		if (m_commit_lsn) {
-			return std::make_pair(start_lsn, false);
-		}
+	if (m_user_space && !is_predefined_tablespace(m_user_space->id)) {
+		m_user_space->update_max_lsn(m_copy_lsn);
 	}
 
-	/* Open the database log for log_write_low */
-	start_lsn = log_reserve_and_open(len);
-
-	mtr_write_log write_log;
-	m_log.for_each_block(write_log);
-	m_commit_lsn = log_sys.get_lsn();
 	bool flush = log_close(m_commit_lsn);
 	DBUG_EXECUTE_IF("ib_log_flush_ahead", flush=true;);
 
-	return std::make_pair(start_lsn, flush);
+	return std::make_pair(m_copy_lsn, flush);
+}
+
+/** Copy the redo log records to the space that finish_write() reserved. */
+inline void mtr_t::copy_log()
+{
+	ut_ad(m_log_mode == MTR_LOG_ALL);
+
+	mtr_copy_log copy{m_copy_lsn};
+	m_log.for_each_block(copy);
+	ut_ad(copy.lsn == m_commit_lsn);
+
+	if (ut_uint64_align_down(m_copy_lsn, OS_FILE_LOG_BLOCK_SIZE)
+	    != ut_uint64_align_down(m_commit_lsn, OS_FILE_LOG_BLOCK_SIZE)) {
+		/* We entered a new log block which was not written
+		full by the current mtr: the next mtr log record group
+		will start within this block at our end offset */
+		log_block_set_first_rec_group(
+			log_sys.buf_block(m_commit_lsn),
+			ulint(m_commit_lsn % OS_FILE_LOG_BLOCK_SIZE));
+	}
+
+	log_sys.copy_end(m_copy_slot);
 }
 
 /** Find out whether a block was not X-latched by the mini-transaction */
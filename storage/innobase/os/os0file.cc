@@ -47,6 +47,7 @@ Created 10/21/1995 Heikki Tuuri
 #include "srv0start.h"
 #include "fil0fil.h"
 #include "fsp0fsp.h"
+#include "fil0pagecompress.h"
 #ifdef HAVE_LINUX_UNISTD_H
 #include "unistd.h"
 #endif
@@ -4381,6 +4382,54 @@ static bool is_file_on_ssd(char *file_path)
 
 #endif
 
+#ifndef _WIN32
+/** Determine whether a file is located in one of the directories of
+innodb_atomic_write_paths.
+@param name  file name
+@return whether the storage of the file is asserted to write pages
+atomically */
+static bool os_file_in_atomic_write_path(const char *name)
+{
+  if (!srv_atomic_write_paths || !*srv_atomic_write_paths)
+    return false;
+
+  char path[FN_REFLEN];
+  if (my_realpath(path, name, MYF(0)))
+    return false;
+  const size_t path_len= strlen(path);
+
+  for (const char *dir= srv_atomic_write_paths; *dir; )
+  {
+    const char *end= strchr(dir, ';');
+    const size_t len= end ? size_t(end - dir) : strlen(dir);
+    char real_dir[FN_REFLEN];
+
+    if (len && len < FN_REFLEN)
+    {
+      char dir_name[FN_REFLEN];
+      memcpy(dir_name, dir, len);
+      dir_name[len]= '\0';
+
+      if (!my_realpath(real_dir, dir_name, MYF(0)))
+      {
+        size_t dir_len= strlen(real_dir);
+        while (dir_len && real_dir[dir_len - 1] == '/')
+          dir_len--;
+        if (dir_len < path_len && path[dir_len] == '/' &&
+            !memcmp(path, real_dir, dir_len))
+          return true;
+      }
+    }
+
+    if (!end)
+      break;
+    dir= end + 1;
+  }
+
+  return false;
+}
+#endif
+
 /** Determine some file metadata when creating or reading the file.
 @param	file	the file that is being created, or OS_FILE_CLOSED */
 void fil_node_t::find_metadata(os_file_t file
@@ -4441,8 +4490,9 @@ void fil_node_t::find_metadata(os_file_t file
 		space->atomic_write_supported = atomic_write
 			&& srv_use_atomic_writes
 #ifndef _WIN32
-			&& my_test_if_atomic_write(file,
-						   space->physical_size())
+			&& (my_test_if_atomic_write(file,
+						    space->physical_size())
+			    || os_file_in_atomic_write_path(name))
 #else
 			/* On Windows, all single sector writes are atomic,
 			as per WriteFile() documentation on MSDN.
@@ -4532,6 +4582,12 @@ bool fil_node_t::read_page0()
 		space->crypt_data = fil_space_read_crypt_data(
 			fil_space_t::zip_size(flags), page);
 	}
+
+	/* The zstd dictionary must be available before any
+	page_compressed page is read. */
+	if (fil_space_t::is_compressed(flags) && !space->zstd_dict) {
+		space->zstd_dict = fil_zstd_dict_read(page);
+	}
 	aligned_free(page);
 
 	if (UNIV_UNLIKELY(space_id != space->id)) {
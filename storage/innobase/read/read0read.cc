@@ -188,7 +188,10 @@ inline void ReadViewBase::snapshot(trx_t *trx)
   @param[in,out] trx transaction
 
   Reuses closed view if there were no read-write transactions since (and at)
-  its creation time.
+  its creation time. A view of active transactions is reused as well if
+  no transaction was started, committed or deregistered since its creation,
+  so that consecutive READ COMMITTED statements do not have to copy the
+  same set of transaction identifiers from trx_sys over and over again.
 
   Original comment states: there is an inherent race here between purge
   and this thread.
@@ -221,12 +224,18 @@ void ReadView::open(trx_t *trx)
   else if (likely(!srv_read_only_mode))
   {
     m_creator_trx_id= trx->id;
-    if (trx_is_autocommit_non_locking(trx) && empty() &&
-        low_limit_id() == trx_sys.get_max_trx_id())
+    if (low_limit_id() == trx_sys.get_max_trx_id() &&
+        (empty()
+         ? trx_is_autocommit_non_locking(trx)
+         : m_deregistered == trx_sys.get_deregistered()))
       m_open.store(true, std::memory_order_relaxed);
     else
     {
       mysql_mutex_lock(&m_mutex);
+      /* Read the counter before the snapshot: a transaction that is
+      deregistered concurrently will cause the next open() to take a
+      new snapshot. */
+      m_deregistered= trx_sys.get_deregistered();
       snapshot(trx);
       m_open.store(true, std::memory_order_relaxed);
       mysql_mutex_unlock(&m_mutex);
@@ -3329,6 +3329,7 @@ struct fil_iterator_t {
 	byte*		io_buffer;		/*!< Buffer to use for IO */
 	fil_space_crypt_t *crypt_data;		/*!< Crypt data (if encrypted) */
 	byte*           crypt_io_buffer;        /*!< IO buffer when encrypted */
+	fil_zstd_dict_t* zstd_dict;		/*!< zstd dictionary (if any) */
 };
 
 
@@ -3581,7 +3582,8 @@ fil_iterate(
 			if (page_compressed) {
 				ulint compress_length = fil_page_decompress(
 					page_compress_buf, dst,
-					callback.get_space_flags());
+					callback.get_space_flags(),
+					iter.zstd_dict);
 				ut_ad(compress_length != srv_page_size);
 				if (compress_length == 0) {
 					goto page_corrupted;
@@ -3657,7 +3659,7 @@ fil_iterate(
 					    page_compress_buf,
 					    callback.get_space_flags(),
 					    512,/* FIXME: proper block size */
-					    encrypted)) {
+					    encrypted, iter.zstd_dict)) {
 					/* FIXME: remove memcpy() */
 					memcpy(src, page_compress_buf, len);
 					memset(src + len, 0,
@@ -3834,6 +3836,11 @@ fil_tablespace_iterate(
 		iter.crypt_data = fil_space_read_crypt_data(
 			callback.get_zip_size(), page);
 
+		/* read (optional) zstd dictionary */
+		iter.zstd_dict = fil_space_t::is_compressed(
+			callback.get_space_flags())
+			? fil_zstd_dict_read(page) : nullptr;
+
 		/* If tablespace is encrypted, it needs extra buffers */
 		if (iter.crypt_data && n_io_buffers > 1) {
 			/* decrease io buffers so that memory
@@ -3872,6 +3879,8 @@ fil_tablespace_iterate(
 			fil_space_destroy_crypt_data(&iter.crypt_data);
 		}
 
+		fil_zstd_dict_free(iter.zstd_dict);
+
 		aligned_free(iter.crypt_io_buffer);
 		aligned_free(iter.io_buffer);
 	}
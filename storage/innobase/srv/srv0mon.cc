@@ -100,6 +100,24 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DEFAULT_ON | MONITOR_DISPLAY_CURRENT),
 	 MONITOR_DEFAULT_START, MONITOR_TIMEOUT},
 
+	{"lock_sys_latch_exclusive", "lock",
+	 "Number of exclusive lock_sys latch acquisitions",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DEFAULT_ON | MONITOR_DISPLAY_CURRENT),
+	 MONITOR_DEFAULT_START, MONITOR_LOCK_SYS_EXCLUSIVE},
+
+	{"lock_rec_hash_latch_waits", "lock",
+	 "Number of waits for a record lock hash table cell latch",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DEFAULT_ON | MONITOR_DISPLAY_CURRENT),
+	 MONITOR_DEFAULT_START, MONITOR_REC_HASH_LATCH_WAITS},
+
+	{"lock_prdt_hash_latch_waits", "lock",
+	 "Number of waits for a predicate lock hash table cell latch",
+	 static_cast<monitor_type_t>(
+	 MONITOR_EXISTING | MONITOR_DEFAULT_ON | MONITOR_DISPLAY_CURRENT),
+	 MONITOR_DEFAULT_START, MONITOR_PRDT_HASH_LATCH_WAITS},
+
 	{"lock_rec_lock_waits", "lock",
 	 "Number of times enqueued into record lock wait queue",
 	 MONITOR_NONE,
@@ -550,6 +568,16 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_SET_MEMBER, MONITOR_LRU_UNZIP_SEARCH_SCANNED,
 	 MONITOR_LRU_UNZIP_SEARCH_SCANNED_PER_CALL},
 
+	{"buffer_LRU_ghost_added", "buffer",
+	 "Number of evicted pages remembered by innodb_lru_policy=ghost",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_GHOST_ADDED},
+
+	{"buffer_LRU_ghost_hits", "buffer",
+	 "Number of pages read again soon after eviction and made young",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_GHOST_HITS},
+
 	/* ========== Counters for Buffer Page I/O ========== */
 	{"module_buffer_page", "buffer_page_io", "Buffer Page I/O Module",
 	 static_cast<monitor_type_t>(
@@ -1877,6 +1905,16 @@ srv_mon_process_existing_counter(
 	case MONITOR_TIMEOUT:
 		value = lock_sys.timeouts;
 		break;
+	case MONITOR_LOCK_SYS_EXCLUSIVE:
+		value = lock_sys.latch_exclusive;
+		break;
+	case MONITOR_REC_HASH_LATCH_WAITS:
+		value = lock_sys.rec_hash.latch_waits;
+		break;
+	case MONITOR_PRDT_HASH_LATCH_WAITS:
+		value = lock_sys.prdt_hash.latch_waits
+			+ lock_sys.prdt_page_hash.latch_waits;
+		break;
 
 	default:
 		ut_error;
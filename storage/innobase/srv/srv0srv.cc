@@ -141,6 +141,9 @@ my_bool	srv_use_native_aio;
 my_bool	srv_numa_interleave;
 /** copy of innodb_use_atomic_writes; @see innodb_init_params() */
 my_bool	srv_use_atomic_writes;
+/** innodb_atomic_write_paths: directories whose storage is asserted to
+write innodb_page_size pages atomically */
+char*	srv_atomic_write_paths;
 /** innodb_compression_algorithm; used with page compression */
 ulong	innodb_compression_algorithm;
 
@@ -230,6 +233,14 @@ my_bool	srv_random_read_ahead;
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong	srv_read_ahead_threshold;
+/** innodb_logical_read_ahead; the number of B-tree leaf pages to read
+ahead in key order when a scan reaches a page that is not in the buffer
+pool, or 0 to disable */
+ulong	srv_logical_read_ahead;
+/** innodb_page_compression_threads; the maximum number of page_compressed
+pages that are being compressed concurrently in the thread pool,
+or 0 to compress them in the page cleaner thread */
+uint	srv_page_compression_threads;
 
 /** innodb_change_buffer_max_size; maximum on-disk size of change
 buffer in terms of percentage of the buffer pool. */
@@ -333,6 +344,8 @@ based on number of configured pages */
 my_bool	srv_stats_sample_traditional;
 
 my_bool	srv_use_doublewrite_buf;
+/** innodb_doublewrite_pages */
+uint	srv_doublewrite_pages;
 
 /** innodb_sync_spin_loops */
 ulong	srv_n_spin_wait_rounds;
@@ -541,6 +554,9 @@ char*	srv_buf_dump_filename;
 and/or load it during startup. */
 char	srv_buffer_pool_dump_at_shutdown = TRUE;
 char	srv_buffer_pool_load_at_startup = TRUE;
+/** innodb_buffer_pool_dump_pages: whether the page contents are dumped
+along with the page identifiers at shutdown */
+my_bool	srv_buffer_pool_dump_pages;
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
 /** Performance schema stage event for monitoring ALTER TABLE progress
@@ -1137,6 +1153,7 @@ srv_export_innodb_status(void)
 	export_vars.innodb_index_pages_written = srv_stats.index_pages_written;
 	export_vars.innodb_non_index_pages_written = srv_stats.non_index_pages_written;
 	export_vars.innodb_pages_page_compressed = srv_stats.pages_page_compressed;
+	export_vars.innodb_pages_page_compressed_dict = srv_stats.pages_page_compressed_dict;
 	export_vars.innodb_page_compressed_trim_op = srv_stats.page_compressed_trim_op;
 	export_vars.innodb_pages_page_decompressed = srv_stats.pages_page_decompressed;
 	export_vars.innodb_pages_page_compression_error = srv_stats.pages_page_compression_error;
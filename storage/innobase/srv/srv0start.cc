@@ -310,19 +310,18 @@ static dberr_t create_log_file(bool create_new_db, lsn_t lsn,
 	log_sys.log.set_lsn(lsn);
 	log_sys.log.set_lsn_offset(LOG_FILE_HDR_SIZE);
 
-	log_sys.buf_next_to_write = 0;
+	log_sys.buf_start_lsn.store(lsn, std::memory_order_relaxed);
 	log_sys.write_lsn = lsn;
 
 	log_sys.next_checkpoint_no = 0;
 	log_sys.last_checkpoint_lsn = 0;
 
 	memset(log_sys.buf, 0, srv_log_buffer_size);
-	log_block_init(log_sys.buf, lsn);
-	log_block_set_first_rec_group(log_sys.buf, LOG_BLOCK_HDR_SIZE);
+	log_block_init(log_sys.buf_block(lsn), lsn);
+	log_block_set_first_rec_group(log_sys.buf_block(lsn),
+				      LOG_BLOCK_HDR_SIZE);
 	memset(log_sys.flush_buf, 0, srv_log_buffer_size);
 
-	log_sys.buf_free = LOG_BLOCK_HDR_SIZE;
-
 	log_sys.log.write_header_durable(lsn);
 
 	mysql_mutex_unlock(&log_sys.mutex);
@@ -895,11 +894,13 @@ static lsn_t srv_prepare_to_delete_redo_log_file(bool old_exists)
 		DBUG_EXECUTE_IF("innodb_log_abort_1", DBUG_RETURN(0););
 		DBUG_PRINT("ib_log", ("After innodb_log_abort_1"));
 
+		log_sys.latch.wr_lock();
 		mysql_mutex_lock(&log_sys.mutex);
 
 		fil_names_clear(log_sys.get_lsn(), false);
 
 		flushed_lsn = log_sys.get_lsn();
+		log_sys.latch.wr_unlock();
 
 		{
 			ib::info	info;
@@ -1433,6 +1434,9 @@ dberr_t srv_start(bool create_new_db)
 			return(srv_init_abort(err));
 		}
 
+		/* Nothing has been modified yet. */
+		buf_load_pages_prepare();
+
 		switch (srv_operation) {
 		case SRV_OPERATION_NORMAL:
 		case SRV_OPERATION_RESTORE_EXPORT:
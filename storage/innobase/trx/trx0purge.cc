@@ -1117,6 +1117,89 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/** Determine whether equal values of the first PRIMARY KEY field of a table
+are always stored as equal bytes. That is not the case for character
+strings, where for example 'a' and 'A ' may be equal in the collation.
+@param table_id  table identifier
+@return whether the field may be folded as a byte string */
+static bool trx_purge_pk_is_binary(table_id_t table_id)
+{
+  bool binary= false;
+  dict_sys.mutex_lock();
+  const dict_table_t *table= dict_sys.get_table(table_id);
+  if (const dict_index_t *index=
+      table ? dict_table_get_first_index(table) : nullptr)
+  {
+    const dict_col_t *col= index->fields[0].col;
+    switch (col->mtype) {
+    case DATA_INT:
+    case DATA_SYS:
+    case DATA_FIXBINARY:
+    case DATA_BINARY:
+      binary= true;
+      break;
+    case DATA_BLOB:
+      binary= col->prtype & DATA_BINARY_TYPE;
+    }
+  }
+  dict_sys.mutex_unlock();
+  return binary;
+}
+
+/** Compute the purge thread affinity of an undo log record.
+All records of a row map to the same value, because the table identifier
+and the first PRIMARY KEY field are included in it. The records of a row
+must be purged in order, but different rows of a table may be purged by
+different threads. If the first PRIMARY KEY field is not compared as a
+byte string, or the table is not in the cache, all records of the table
+map to the same value.
+@param undo_rec  undo log record
+@param binary_pk cache of trx_purge_pk_is_binary() for the current batch
+@return fold value */
+static ulint
+trx_purge_rec_fold(trx_undo_rec_t *undo_rec,
+                   std::unordered_map<table_id_t, bool> &binary_pk)
+{
+  ulint type, cmpl_info;
+  bool updated_extern;
+  undo_no_t undo_no;
+  table_id_t table_id;
+  const byte *ptr= trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info,
+                                         &updated_extern, &undo_no,
+                                         &table_id);
+  const ulint fold= ut_fold_ull(table_id);
+
+  auto b= binary_pk.emplace(table_id, false);
+  if (b.second)
+    b.first->second= trx_purge_pk_is_binary(table_id);
+  if (!b.first->second)
+    return fold;
+
+  switch (type) {
+  case TRX_UNDO_INSERT_REC:
+    break;
+  case TRX_UNDO_UPD_EXIST_REC:
+  case TRX_UNDO_UPD_DEL_REC:
+  case TRX_UNDO_DEL_MARK_REC:
+    trx_id_t trx_id;
+    roll_ptr_t roll_ptr;
+    byte info_bits;
+    ptr= trx_undo_update_rec_get_sys_cols(ptr, &trx_id, &roll_ptr,
+                                          &info_bits);
+    break;
+  default:
+    /* The record does not refer to any particular row. */
+    return fold;
+  }
+
+  const byte *field;
+  uint32_t len, orig_len;
+  trx_undo_rec_get_col_val(ptr, &field, &len, &orig_len);
+  return field && len < UNIV_EXTERN_STORAGE_FIELD
+    ? ut_fold_ulint_pair(fold, ut_fold_binary(field, len))
+    : fold;
+}
+
 /** Run a purge batch.
 @param n_purge_threads	number of purge threads
 @return number of undo log pages handled in the batch */
@@ -1157,26 +1240,33 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 #endif
 
 	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
+	to a per purge node vector, chosen by a hash of the table and the
+	row, so that each row is purged in order by a single thread while
+	a table that is being updated heavily can be purged by all threads. */
 	thr = UT_LIST_GET_FIRST(purge_sys.query->thrs);
 	ut_a(n_thrs > 0 && thr != NULL);
 
-	ut_ad(purge_sys.head <= purge_sys.tail);
+	mem_heap_empty(purge_sys.heap);
 
-	i = 0;
+	purge_node_t**	nodes = static_cast<purge_node_t**>(
+		mem_heap_alloc(purge_sys.heap,
+			       n_purge_threads * sizeof *nodes));
+
+	for (i = 0; i < n_purge_threads; i++) {
+		ut_a(thr != NULL);
+		nodes[i] = static_cast<purge_node_t*>(thr->child);
+		ut_a(que_node_get_type(nodes[i]) == QUE_NODE_PURGE);
+		thr = UT_LIST_GET_NEXT(thrs, thr);
+	}
+
+	ut_ad(purge_sys.head <= purge_sys.tail);
 
 	const ulint		batch_size = srv_purge_batch_size;
-	std::unordered_map<table_id_t, purge_node_t*> table_id_map;
-	mem_heap_empty(purge_sys.heap);
+	std::unordered_map<table_id_t, bool> binary_pk;
 
 	while (UNIV_LIKELY(srv_undo_sources) || !srv_fast_shutdown) {
-		purge_node_t*		node;
 		trx_purge_rec_t		purge_rec;
 
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
 
@@ -1195,26 +1285,8 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 			continue;
 		}
 
-		table_id_t table_id = trx_undo_rec_get_table_id(
-			purge_rec.undo_rec);
-
-		purge_node_t *& table_node = table_id_map[table_id];
-
-		if (table_node) {
-			node = table_node;
-		} else {
-			thr = UT_LIST_GET_NEXT(thrs, thr);
-
-			if (!(++i % n_purge_threads)) {
-				thr = UT_LIST_GET_FIRST(
-					purge_sys.query->thrs);
-			}
-
-			ut_a(thr != NULL);
-			table_node = node;
-		}
-
-		node->undo_recs.push(purge_rec);
+		nodes[trx_purge_rec_fold(purge_rec.undo_rec, binary_pk)
+		      % n_purge_threads]->undo_recs.push(purge_rec);
 
 		if (n_pages_handled >= batch_size) {
 			break;
@@ -40,7 +40,7 @@ namespace tpool
   void task_group::execute(task* t)
   {
     std::unique_lock<std::mutex> lk(m_mtx);
-    if (m_tasks_running == m_max_concurrent_tasks)
+    if (m_tasks_running >= m_max_concurrent_tasks)
     {
       /* Queue for later execution by another thread.*/
       m_queue.push(t);
@@ -58,7 +58,9 @@ namespace tpool
       }
       lk.lock();
 
-      if (m_queue.empty())
+      /* If set_max_tasks() lowered the limit, leave the queue to the
+      remaining threads. */
+      if (m_queue.empty() || m_tasks_running > m_max_concurrent_tasks)
         break;
       t = m_queue.front();
       m_queue.pop();
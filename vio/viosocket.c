@@ -36,6 +36,10 @@
 # include <sys/filio.h>
 #endif
 
+#ifdef HAVE_SENDFILE
+# include <sys/sendfile.h>
+#endif
+
 /* Network io wait callbacks  for threadpool */
 static void (*before_io_wait)(void)= 0;
 static void (*after_io_wait)(void)= 0;
@@ -286,6 +290,55 @@ size_t vio_write(Vio *vio, const uchar* buf, size_t size)
   DBUG_RETURN(ret);
 }
 
+#ifdef HAVE_SENDFILE
+/**
+  Send up to size bytes of a file directly to a socket, without copying
+  them through a user space buffer.
+
+  Only valid for plain TCP/IP and Unix socket connections; the caller
+  must not use it for SSL or named pipe connections.
+
+  @param vio      VIO object representing a connected socket.
+  @param file     File to read from.
+  @param offset   Position in the file of the first byte to send.
+  @param size     Number of bytes to send.
+
+  @return Number of bytes sent, or -1 on error (as vio_write()).
+*/
+
+size_t vio_sendfile(Vio *vio, File file, my_off_t offset, size_t size)
+{
+  ssize_t ret;
+  off_t file_pos= (off_t) offset;
+  DBUG_ENTER("vio_sendfile");
+  DBUG_ASSERT(vio->type == VIO_TYPE_TCPIP || vio->type == VIO_TYPE_SOCKET);
+  DBUG_PRINT("enter", ("sd: %d  file: %d  offset: %llu  size: %zu",
+                       (int)mysql_socket_getfd(vio->mysql_socket), file,
+                       (ulonglong) offset, size));
+
+  while ((ret= sendfile(mysql_socket_getfd(vio->mysql_socket), file,
+                        &file_pos, size)) == -1)
+  {
+    int error= socket_errno;
+    /* The operation would block? */
+    if (error != SOCKET_EAGAIN && error != SOCKET_EWOULDBLOCK)
+      break;
+
+    /* Wait for the output buffer to become writable.*/
+    if ((ret= vio_socket_io_wait(vio, VIO_IO_EVENT_WRITE)))
+      break;
+  }
+#ifndef DBUG_OFF
+  if (ret == -1)
+  {
+    DBUG_PRINT("vio_error", ("Got error on sendfile: %d",socket_errno));
+  }
+#endif /* DBUG_OFF */
+  DBUG_PRINT("exit", ("%d", (int) ret));
+  DBUG_RETURN(ret);
+}
+#endif /* HAVE_SENDFILE */
+
 int vio_socket_shutdown(Vio *vio, int how)
 {
   int ret= shutdown(mysql_socket_getfd(vio->mysql_socket), how);